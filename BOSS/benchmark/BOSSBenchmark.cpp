@@ -0,0 +1,545 @@
+#include "BOSS.h"
+#include "JSONTools.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include <dirent.h>
+#include <sys/resource.h>
+#include <fstream>
+#include <algorithm>
+
+using namespace BOSS;
+
+// standalone benchmark for the BOSS searches, built with 'make linux' and run from BOSS/bin
+//
+//   BOSS_benchmark [-d buildOrderDir] [-t dfbbTimeMS] [-c combatTimeMS] [-n threads] [-o results.json] [-b baseline.json]
+//
+// every problem is solved by the naive search and by DFBB_BuildOrderSmartSearch with each engine, and each race gets a run of
+// every CombatSearch variant. the results are written as json, and if a baseline from an earlier run is given
+// the exit code is 1 when any DFBB result lost its makespan or got a longer one than in the baseline, or a beam result lost its makespan
+
+class BenchmarkOptions
+{
+public:
+
+    std::string     buildOrderDir;
+    std::string     outputFile;
+    std::string     baselineFile;
+    double          searchTimeLimit;
+    double          combatTimeLimit;
+    int             numThreads;
+
+    BenchmarkOptions()
+        : buildOrderDir("buildorders")
+        , outputFile("BOSS_benchmark.json")
+        , searchTimeLimit(3000)
+        , combatTimeLimit(2000)
+        , numThreads(1)
+    {
+
+    }
+};
+
+class BenchmarkProblem
+{
+public:
+
+    std::string             name;
+    RaceID                  race;
+    BuildOrderSearchGoal    goal;
+    BuildOrder              reference;      // the build order the goal came from, empty for the canonical goals
+
+    BenchmarkProblem(const std::string & n, const RaceID r)
+        : name(n)
+        , race(r)
+        , goal(r)
+    {
+
+    }
+};
+
+class BenchmarkResult
+{
+public:
+
+    std::string             problem;
+    std::string             search;
+    bool                    solved;
+    bool                    timedOut;
+    bool                    solutionFound;
+    unsigned long long      nodesExpanded;
+    unsigned long long      nodesDominated;
+    double                  timeElapsed;
+    double                  firstSolutionTime;
+    FrameCountType          makespan;
+    FrameCountType          referenceMakespan;
+    size_t                  buildOrderSize;
+    long                    peakMemoryKB;
+
+    BenchmarkResult(const std::string & p, const std::string & s)
+        : problem(p)
+        , search(s)
+        , solved(false)
+        , timedOut(false)
+        , solutionFound(false)
+        , nodesExpanded(0)
+        , nodesDominated(0)
+        , timeElapsed(0)
+        , firstSolutionTime(0)
+        , makespan(0)
+        , referenceMakespan(0)
+        , buildOrderSize(0)
+        , peakMemoryKB(0)
+    {
+
+    }
+
+    double nodesPerSecond() const
+    {
+        return timeElapsed > 0 ? (1000.0 * nodesExpanded / timeElapsed) : 0;
+    }
+};
+
+// the high water mark of the whole process, so it only tells you something when it goes up
+long GetPeakMemoryKB()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+std::string Trim(const std::string & str)
+{
+    const size_t first = str.find_first_not_of(" \t\r\n");
+    const size_t last = str.find_last_not_of(" \t\r\n");
+
+    return first == std::string::npos ? "" : str.substr(first, last - first + 1);
+}
+
+GameState GetStartingState(const RaceID race)
+{
+    GameState state(race);
+    state.setStartingState();
+    return state;
+}
+
+// a build order file is the race on the first line followed by one action name per line
+// the goal is to have everything the build order makes on top of the starting units
+bool ReadBuildOrderProblem(const std::string & dir, const std::string & filename, std::vector<BenchmarkProblem> & problems)
+{
+    std::ifstream fin((dir + "/" + filename).c_str());
+    std::string line;
+
+    if (!std::getline(fin, line))
+    {
+        return false;
+    }
+
+    const RaceID race = Races::GetRaceID(Trim(line));
+    BOSS_ASSERT(race != Races::None, "Build order file %s doesn't start with a race", filename.c_str());
+
+    BenchmarkProblem problem(filename.substr(0, filename.find_last_of('.')), race);
+    while (std::getline(fin, line))
+    {
+        line = Trim(line);
+        if (line.empty())
+        {
+            continue;
+        }
+
+        BOSS_ASSERT(ActionTypes::TypeExists(line), "Action Type doesn't exist: %s", line.c_str());
+        problem.reference.add(ActionTypes::GetActionType(line));
+    }
+
+    const GameState state(GetStartingState(race));
+    for (size_t i(0); i < problem.reference.size(); ++i)
+    {
+        const ActionType & action = problem.reference[i];
+        problem.goal.setGoal(action, std::max(problem.goal.getGoal(action), (UnitCountType)state.getUnitData().getNumTotal(action)) + 1);
+    }
+
+    problems.push_back(problem);
+    return true;
+}
+
+void ReadBuildOrderProblems(const std::string & dir, std::vector<BenchmarkProblem> & problems)
+{
+    std::vector<std::string> filenames;
+
+    DIR * d = opendir(dir.c_str());
+    if (d == nullptr)
+    {
+        std::cerr << "Couldn't open build order directory " << dir << "\n";
+        return;
+    }
+
+    while (struct dirent * entry = readdir(d))
+    {
+        const std::string filename(entry->d_name);
+        if (filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".txt") == 0)
+        {
+            filenames.push_back(filename);
+        }
+    }
+
+    closedir(d);
+
+    // directory order isn't stable, and the problem order should be
+    std::sort(filenames.begin(), filenames.end());
+    for (size_t i(0); i < filenames.size(); ++i)
+    {
+        ReadBuildOrderProblem(dir, filenames[i], problems);
+    }
+}
+
+void AddCanonicalProblem(const std::string & name, const RaceID race, const std::vector< std::pair<std::string, int> > & goal, std::vector<BenchmarkProblem> & problems)
+{
+    BenchmarkProblem problem(name, race);
+
+    for (size_t i(0); i < goal.size(); ++i)
+    {
+        problem.goal.setGoal(ActionTypes::GetActionType(goal[i].first), goal[i].second);
+    }
+
+    problems.push_back(problem);
+}
+
+// a spread of small to large goals for each race, the large ones don't finish within a few seconds
+void AddCanonicalProblems(std::vector<BenchmarkProblem> & problems)
+{
+    AddCanonicalProblem("Protoss_Zealots",      Races::Protoss, {{"Protoss_Zealot", 4}, {"Protoss_Probe", 12}}, problems);
+    AddCanonicalProblem("Protoss_Dragoons",     Races::Protoss, {{"Protoss_Dragoon", 4}, {"Protoss_Probe", 14}}, problems);
+    AddCanonicalProblem("Protoss_Gateway",      Races::Protoss, {{"Protoss_Zealot", 6}, {"Protoss_Dragoon", 4}, {"Protoss_Probe", 16}}, problems);
+    AddCanonicalProblem("Terran_Marines",       Races::Terran,  {{"Terran_Marine", 6}, {"Terran_SCV", 12}}, problems);
+    AddCanonicalProblem("Terran_Vultures",      Races::Terran,  {{"Terran_Vulture", 3}, {"Terran_SCV", 12}}, problems);
+    AddCanonicalProblem("Terran_Bio",           Races::Terran,  {{"Terran_Marine", 10}, {"Terran_Medic", 2}, {"Terran_SCV", 16}}, problems);
+    AddCanonicalProblem("Zerg_Zerglings",       Races::Zerg,    {{"Zerg_Zergling", 8}, {"Zerg_Drone", 10}}, problems);
+    AddCanonicalProblem("Zerg_Hydralisks",      Races::Zerg,    {{"Zerg_Hydralisk", 4}, {"Zerg_Drone", 12}}, problems);
+    AddCanonicalProblem("Zerg_Mutalisks",       Races::Zerg,    {{"Zerg_Mutalisk", 2}, {"Zerg_Drone", 12}}, problems);
+    AddCanonicalProblem("Zerg_LingMuta",        Races::Zerg,    {{"Zerg_Mutalisk", 6}, {"Zerg_Zergling", 6}, {"Zerg_Drone", 18}}, problems);
+    AddCanonicalProblem("Zerg_Ultralisks",      Races::Zerg,    {{"Zerg_Ultralisk", 4}, {"Zerg_Zergling", 12}, {"Zerg_Drone", 24}}, problems);
+}
+
+BenchmarkResult RunNaiveSearch(const BenchmarkProblem & problem, const GameState & state)
+{
+    BenchmarkResult result(problem.name, "Naive");
+
+    Timer timer;
+    timer.start();
+
+    NaiveBuildOrderSearch naiveSearch(state, problem.goal);
+    const BuildOrder & buildOrder = naiveSearch.solve();
+
+    result.timeElapsed          = timer.getElapsedTimeInMilliSec();
+    result.firstSolutionTime    = result.timeElapsed;
+    result.solved               = true;
+    result.solutionFound        = !buildOrder.empty();
+    result.buildOrderSize       = buildOrder.size();
+    result.makespan             = buildOrder.empty() ? 0 : buildOrder.getCompletionTime(state);
+    result.peakMemoryKB         = GetPeakMemoryKB();
+
+    return result;
+}
+
+BenchmarkResult RunSmartSearch(const BenchmarkProblem & problem, const GameState & state, const BenchmarkOptions & options, const SearchEngines::SearchEngine engine)
+{
+    BenchmarkResult result(problem.name, engine == SearchEngines::Beam ? "Beam" : (engine == SearchEngines::Milestones ? "Milestones" : "DFBB"));
+
+    DFBB_BuildOrderSmartSearch smartSearch(problem.race);
+    smartSearch.setEngine(engine);
+    smartSearch.setGoal(problem.goal);
+    smartSearch.setState(state);
+    smartSearch.setTimeLimit((int)options.searchTimeLimit);
+    smartSearch.setNumThreads(options.numThreads);
+
+    Timer timer;
+    timer.start();
+
+    smartSearch.search();
+
+    const DFBB_BuildOrderSearchResults & results = smartSearch.getResults();
+    result.timeElapsed          = timer.getElapsedTimeInMilliSec();
+    result.firstSolutionTime    = results.firstSolutionTime;
+    result.solved               = results.solved;
+    result.timedOut             = results.timedOut;
+    result.solutionFound        = results.solutionFound;
+    result.nodesExpanded        = results.nodesExpanded;
+    result.buildOrderSize       = results.buildOrder.size();
+    result.makespan             = results.buildOrder.empty() ? 0 : results.buildOrder.getCompletionTime(state);
+    result.peakMemoryKB         = GetPeakMemoryKB();
+
+    // a finished search with no solution found nothing that beats the naive upper bound, which is what BOSSManager uses then
+    if (!results.timedOut && !results.solutionFound)
+    {
+        NaiveBuildOrderSearch naiveSearch(state, problem.goal);
+        const BuildOrder & buildOrder = naiveSearch.solve();
+
+        result.buildOrderSize   = buildOrder.size();
+        result.makespan         = buildOrder.getCompletionTime(state);
+    }
+
+    return result;
+}
+
+void AddRelevantActions(CombatSearchParameters & params, const std::vector< std::pair<std::string, int> > & actions)
+{
+    ActionSet relevantActions;
+
+    for (size_t i(0); i < actions.size(); ++i)
+    {
+        const ActionType & action = ActionTypes::GetActionType(actions[i].first);
+        relevantActions.add(action);
+
+        if (actions[i].second >= 0)
+        {
+            params.setMaxActions(action, actions[i].second);
+        }
+    }
+
+    params.setRelevantActions(relevantActions);
+}
+
+CombatSearchParameters GetCombatSearchParameters(const RaceID race, const BenchmarkOptions & options)
+{
+    CombatSearchParameters params;
+    params.setInitialState(GetStartingState(race));
+    params.setFrameTimeLimit(5000);
+    params.setSearchTimeLimit(options.combatTimeLimit);
+    params.setAlwaysMakeWorkers(true);
+    params.setNumThreads(options.numThreads);
+
+    if (race == Races::Protoss)
+    {
+        AddRelevantActions(params, {{"Protoss_Probe", -1}, {"Protoss_Pylon", -1}, {"Protoss_Gateway", 3}, {"Protoss_Assimilator", 1},
+                                    {"Protoss_Cybernetics_Core", 1}, {"Protoss_Zealot", -1}, {"Protoss_Dragoon", -1}});
+    }
+    else if (race == Races::Terran)
+    {
+        AddRelevantActions(params, {{"Terran_SCV", -1}, {"Terran_Supply_Depot", -1}, {"Terran_Barracks", 3}, {"Terran_Refinery", 1},
+                                    {"Terran_Academy", 1}, {"Terran_Marine", -1}, {"Terran_Medic", -1}});
+    }
+    else
+    {
+        AddRelevantActions(params, {{"Zerg_Drone", -1}, {"Zerg_Overlord", -1}, {"Zerg_Hatchery", 2}, {"Zerg_Spawning_Pool", 1},
+                                    {"Zerg_Extractor", 1}, {"Zerg_Hydralisk_Den", 1}, {"Zerg_Zergling", -1}, {"Zerg_Hydralisk", -1}});
+    }
+
+    return params;
+}
+
+BenchmarkResult RunCombatSearch(const std::string & searchType, const RaceID race, const CombatSearchParameters & params)
+{
+    BenchmarkResult result(Races::GetRaceName(race) + "_Combat", searchType);
+
+    std::shared_ptr<CombatSearch> combatSearch;
+    if (searchType == "Integral")
+    {
+        combatSearch = std::shared_ptr<CombatSearch>(new CombatSearch_Integral(params));
+    }
+    else if (searchType == "Bucket")
+    {
+        combatSearch = std::shared_ptr<CombatSearch>(new CombatSearch_Bucket(params));
+    }
+    else if (searchType == "BucketPruned")
+    {
+        CombatSearchParameters prunedParams(params);
+        prunedParams.setDominancePruning(true);
+        combatSearch = std::shared_ptr<CombatSearch>(new CombatSearch_Bucket(prunedParams));
+    }
+    else
+    {
+        combatSearch = std::shared_ptr<CombatSearch>(new CombatSearch_BestResponse(params));
+    }
+
+    combatSearch->search();
+
+    // combat search has no makespan to report, it maximizes army value up to the frame limit
+    const CombatSearchResults & results = combatSearch->getResults();
+    result.solved           = results.solved;
+    result.timedOut         = results.timedOut;
+    result.nodesExpanded    = results.nodesExpanded;
+    result.nodesDominated   = results.nodesDominated;
+    result.timeElapsed      = results.timeElapsed;
+    result.peakMemoryKB     = GetPeakMemoryKB();
+
+    return result;
+}
+
+void WriteResults(const std::vector<BenchmarkResult> & results, const BenchmarkOptions & options)
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+
+    writer.StartObject();
+    writer.String("SearchTimeLimitMS");     writer.Double(options.searchTimeLimit);
+    writer.String("CombatTimeLimitMS");     writer.Double(options.combatTimeLimit);
+    writer.String("Threads");               writer.Int(options.numThreads);
+    writer.String("Results");
+    writer.StartArray();
+
+    for (size_t i(0); i < results.size(); ++i)
+    {
+        const BenchmarkResult & result = results[i];
+
+        writer.StartObject();
+        writer.String("Problem");           writer.String(result.problem.c_str());
+        writer.String("Search");            writer.String(result.search.c_str());
+        writer.String("Solved");            writer.Bool(result.solved);
+        writer.String("TimedOut");          writer.Bool(result.timedOut);
+        writer.String("SolutionFound");     writer.Bool(result.solutionFound);
+        writer.String("NodesExpanded");     writer.Uint64(result.nodesExpanded);
+        writer.String("NodesDominated");    writer.Uint64(result.nodesDominated);
+        writer.String("NodesPerSec");       writer.Double(result.nodesPerSecond());
+        writer.String("TimeMS");            writer.Double(result.timeElapsed);
+        writer.String("FirstSolutionMS");   writer.Double(result.firstSolutionTime);
+        writer.String("Makespan");          writer.Int(result.makespan);
+        writer.String("ReferenceMakespan"); writer.Int(result.referenceMakespan);
+        writer.String("BuildOrderSize");    writer.Uint64(result.buildOrderSize);
+        writer.String("PeakMemoryKB");      writer.Int64(result.peakMemoryKB);
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+
+    std::ofstream fout(options.outputFile.c_str());
+    fout << buffer.GetString() << "\n";
+}
+
+// a DFBB result regresses if it had a makespan in the baseline and now has none or a longer one
+// a beam result only regresses if it has none, since any change to the bound that orders the beam moves its makespan both ways
+// a milestone result is the same, its milestones are searched for a fixed time so their build orders depend on the machine
+int CompareToBaseline(const std::vector<BenchmarkResult> & results, const std::string & baselineFile)
+{
+    rapidjson::Document document;
+    JSONTools::ParseJSONFile(document, baselineFile);
+    BOSS_ASSERT(document.HasMember("Results") && document["Results"].IsArray(), "Baseline file %s has no 'Results' array", baselineFile.c_str());
+
+    const rapidjson::Value & baseline = document["Results"];
+    int regressions = 0;
+
+    for (size_t i(0); i < results.size(); ++i)
+    {
+        const BenchmarkResult & result = results[i];
+        if ((result.search != "DFBB") && (result.search != "Beam") && (result.search != "Milestones"))
+        {
+            continue;
+        }
+
+        for (rapidjson::SizeType b(0); b < baseline.Size(); ++b)
+        {
+            const rapidjson::Value & val = baseline[b];
+            if (result.problem != val["Problem"].GetString() || result.search != val["Search"].GetString() || (val["Makespan"].GetInt() == 0))
+            {
+                continue;
+            }
+
+            const int baselineMakespan = val["Makespan"].GetInt();
+            if ((result.makespan == 0) || ((result.search == "DFBB") && (result.makespan > baselineMakespan)))
+            {
+                std::cerr << "REGRESSION " << result.problem << " " << result.search << ": makespan " << result.makespan << " was " << baselineMakespan << "\n";
+                ++regressions;
+            }
+        }
+    }
+
+    return regressions;
+}
+
+bool ParseOptions(int argc, char * argv[], BenchmarkOptions & options)
+{
+    for (int i(1); i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+
+        const std::string val(argv[++i]);
+        if      (arg == "-d") { options.buildOrderDir = val; }
+        else if (arg == "-o") { options.outputFile = val; }
+        else if (arg == "-b") { options.baselineFile = val; }
+        else if (arg == "-t") { options.searchTimeLimit = atof(val.c_str()); }
+        else if (arg == "-c") { options.combatTimeLimit = atof(val.c_str()); }
+        else if (arg == "-n") { options.numThreads = std::max(atoi(val.c_str()), 1); }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char * argv[])
+{
+    BenchmarkOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: BOSS_benchmark [-d buildOrderDir] [-t dfbbTimeMS] [-c combatTimeMS] [-n threads] [-o results.json] [-b baseline.json]\n";
+        return 2;
+    }
+
+    BWAPI::BWAPI_init();
+    BOSS::init();
+
+    std::vector<BenchmarkProblem> problems;
+    ReadBuildOrderProblems(options.buildOrderDir, problems);
+    AddCanonicalProblems(problems);
+
+    std::vector<BenchmarkResult> results;
+    for (size_t p(0); p < problems.size(); ++p)
+    {
+        const BenchmarkProblem & problem = problems[p];
+        const GameState state(GetStartingState(problem.race));
+        const FrameCountType referenceMakespan = problem.reference.empty() ? 0 : problem.reference.getCompletionTime(state);
+
+        results.push_back(RunNaiveSearch(problem, state));
+        results.push_back(RunSmartSearch(problem, state, options, SearchEngines::DFBB));
+        results.push_back(RunSmartSearch(problem, state, options, SearchEngines::Beam));
+        results.push_back(RunSmartSearch(problem, state, options, SearchEngines::Milestones));
+
+        results[results.size()-4].referenceMakespan = referenceMakespan;
+        results[results.size()-3].referenceMakespan = referenceMakespan;
+        results[results.size()-2].referenceMakespan = referenceMakespan;
+        results[results.size()-1].referenceMakespan = referenceMakespan;
+    }
+
+    const RaceID races[] = { Races::Protoss, Races::Terran, Races::Zerg };
+    for (size_t r(0); r < 3; ++r)
+    {
+        CombatSearchParameters params = GetCombatSearchParameters(races[r], options);
+        results.push_back(RunCombatSearch("Integral", races[r], params));
+        results.push_back(RunCombatSearch("Bucket", races[r], params));
+        results.push_back(RunCombatSearch("BucketPruned", races[r], params));
+
+        // best response plays against the first build order file of the next race
+        for (size_t p(0); p < problems.size(); ++p)
+        {
+            if (!problems[p].reference.empty() && problems[p].race == races[(r + 1) % 3])
+            {
+                params.setEnemyInitialState(GetStartingState(problems[p].race));
+                params.setEnemyBuildOrder(problems[p].reference);
+                results.push_back(RunCombatSearch("BestResponse", races[r], params));
+                break;
+            }
+        }
+    }
+
+    WriteResults(results, options);
+
+    for (size_t i(0); i < results.size(); ++i)
+    {
+        const BenchmarkResult & result = results[i];
+        fprintf(stderr, "%-26s %-12s %12llu nodes %10.0f nodes/s %10.1f ms  makespan %6d  ref %6d\n", result.problem.c_str(), result.search.c_str(),
+            result.nodesExpanded, result.nodesPerSecond(), result.timeElapsed, result.makespan, result.referenceMakespan);
+    }
+
+    if (!options.baselineFile.empty() && CompareToBaseline(results, options.baselineFile) > 0)
+    {
+        return 1;
+    }
+
+    return 0;
+}
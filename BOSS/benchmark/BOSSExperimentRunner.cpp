@@ -0,0 +1,54 @@
+#include "BOSS.h"
+#include "BOSSExperiments.h"
+
+using namespace BOSS;
+
+// native runner for the experiments in a BOSS config file, built with 'make linux' and run from BOSS/bin
+//
+//   BOSS_experiments [-f BOSS_Config.txt] [-o BOSS_Results.json] [--jobs N]
+//
+// the enabled experiments of the config file are run as a batch on up to N threads at once, and the timings, nodes,
+// best evals and build orders of all of them are written to one json file
+
+bool ParseOptions(int argc, char * argv[], std::string & configFile, std::string & resultsFile, size_t & jobs)
+{
+    for (int i(1); i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+
+        const std::string val(argv[++i]);
+        if      (arg == "-f")     { configFile = val; }
+        else if (arg == "-o")     { resultsFile = val; }
+        else if (arg == "--jobs") { jobs = std::max(atoi(val.c_str()), 1); }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char * argv[])
+{
+    std::string configFile = "BOSS_Config.txt";
+    std::string resultsFile = "BOSS_Results.json";
+    size_t jobs = 1;
+
+    if (!ParseOptions(argc, argv, configFile, resultsFile, jobs))
+    {
+        std::cerr << "usage: BOSS_experiments [-f BOSS_Config.txt] [-o BOSS_Results.json] [--jobs N]\n";
+        return 2;
+    }
+
+    BWAPI::BWAPI_init();
+    BOSS::init();
+
+    Experiments::RunExperimentBatch(configFile, resultsFile, jobs);
+
+    return 0;
+}
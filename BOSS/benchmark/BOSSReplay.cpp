@@ -0,0 +1,111 @@
+#include "BOSS.h"
+#include "SearchReplay.h"
+
+using namespace BOSS;
+
+// runs the build order searches saved by the bot again, built with 'make linux' and run from BOSS/bin
+//
+//   BOSS_replay -f BOSS_replay.dat [-n threads] [-p problem]
+//
+// each search gets the same time slices it got in the game, so a profiler sees the same work the bot did.
+// by default a search uses the threads it used in the game, -p replays only the problem with that index
+
+class ReplayOptions
+{
+public:
+
+    std::string     replayFile;
+    int             numThreads;     // 0 uses the threads of the game
+    int             problem;        // -1 replays all of them
+
+    ReplayOptions()
+        : numThreads(0)
+        , problem(-1)
+    {
+
+    }
+};
+
+bool ParseOptions(int argc, char * argv[], ReplayOptions & options)
+{
+    for (int i(1); i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+
+        const std::string val(argv[++i]);
+        if      (arg == "-f") { options.replayFile = val; }
+        else if (arg == "-n") { options.numThreads = std::max(atoi(val.c_str()), 1); }
+        else if (arg == "-p") { options.problem = atoi(val.c_str()); }
+        else
+        {
+            return false;
+        }
+    }
+
+    return !options.replayFile.empty();
+}
+
+int main(int argc, char * argv[])
+{
+    ReplayOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: BOSS_replay -f BOSS_replay.dat [-n threads] [-p problem]\n";
+        return 2;
+    }
+
+    BWAPI::BWAPI_init();
+    BOSS::init();
+
+    std::vector<SearchReplayProblem> problems;
+    if (!SearchReplay::Read(options.replayFile, problems))
+    {
+        std::cerr << "couldn't read all of " << options.replayFile << ", replaying the " << problems.size() << " problems before the error\n";
+    }
+
+    printf("%4s %6s %8s %4s %7s | %6s %12s %10s %5s | %6s %12s %10s %5s\n", "#", "Frame", "Race", "Eng", "Slices",
+        "Solved", "GameNodes", "GameMS", "BO", "Solved", "Nodes", "MS", "BO");
+
+    unsigned long long totalNodes = 0;
+    double totalTime = 0;
+    int numReplayed = 0;
+
+    for (size_t p(0); p < problems.size(); ++p)
+    {
+        if (options.problem >= 0 && (size_t)options.problem != p)
+        {
+            continue;
+        }
+
+        const SearchReplayProblem & problem = problems[p];
+        const int numThreads = options.numThreads > 0 ? options.numThreads : problem.numThreads;
+
+        printf("%4d %6d %8s %4s %7s | %6s %12llu %10.2lf %5d | ", (int)p, problem.gameFrame, Races::GetRaceName(problem.state.race).c_str(),
+            problem.engine == SearchEngines::Beam ? "Beam" : (problem.engine == SearchEngines::Milestones ? "Mile" : "DFBB"),
+            problem.background ? "bg" : std::to_string(problem.frameBudgets.size()).c_str(),
+            problem.finished ? (problem.solved ? "yes" : "no") : "cancel", problem.nodesExpanded, problem.timeElapsed, (int)problem.buildOrderSize);
+
+        try
+        {
+            const DFBB_BuildOrderSearchResults results = SearchReplay::Run(problem, numThreads);
+
+            printf("%6s %12llu %10.2lf %5d\n", results.solved ? "yes" : "no", results.nodesExpanded, results.timeElapsed, (int)results.buildOrder.size());
+
+            totalNodes += results.nodesExpanded;
+            totalTime += results.timeElapsed;
+            ++numReplayed;
+        }
+        catch (const BOSSException &)
+        {
+            printf("%6s\n", "error");
+        }
+    }
+
+    printf("\nReplayed %d searches: %llu nodes in %.2lfms\n", numReplayed, totalNodes, totalTime);
+
+    return 0;
+}
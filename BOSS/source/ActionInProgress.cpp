@@ -1,4 +1,5 @@
 #include "ActionInProgress.h"
+#include "GameStateUndo.h"
 
 using namespace BOSS;
 
@@ -13,30 +14,83 @@ UnitCountType ActionsInProgress::numInProgress(const ActionType & a) const
 	return _numProgress[a.ID()];	
 }
 	
-void ActionsInProgress::addAction(const ActionType & action, FrameCountType time)
+void ActionsInProgress::addAction(const ActionType & action, FrameCountType time, GameStateUndo * undo)
 {
 	// deprecated, code below should be faster
     //inProgress.push_back(ActionInProgress(a, (unsigned short)time));
     //inProgress.sort();
 	
     // inProgress should always be sorted, so add the action in its place
-    _inProgress.addSorted(ActionInProgress(action, time));
+    // the index is found here rather than with addSorted, which can read past the end of the
+    // array when an undone action has left a stale entry there
+    ActionInProgress newAction(action, time);
+    size_t index(0);
+    while ((index < _inProgress.size()) && (_inProgress[index] < newAction))
+    {
+        ++index;
+    }
+
+    _inProgress.addAtIndex(newAction, index);
+
+    if (undo)
+    {
+        undo->progressAdded.push_back(index);
+    }
 
 	// increase the specific count of a
 	_numProgress[action.ID()]++;
+
+    _hash.add(Hash::InProgress, Hash::ActionKey(action), time);
 }
 	
-void ActionsInProgress::popNextAction()	
+void ActionsInProgress::popNextAction(GameStateUndo * undo)
 {
 	BOSS_ASSERT(_inProgress.size() > 0, "Can't pop from empty set");
+
+    if (undo)
+    {
+        undo->progressFinished.push_back(_inProgress[_inProgress.size()-1]);
+    }
 	
 	// there is one less of the last unit in progress
 	_numProgress[_inProgress[_inProgress.size()-1]._action.ID()]--;
+
+    _hash.remove(Hash::InProgress, Hash::ActionKey(_inProgress[_inProgress.size()-1]._action), _inProgress[_inProgress.size()-1]._time);
 	
 	// the number of things in progress goes down
     _inProgress.pop_back();
 }
 	
+void ActionsInProgress::saveUndo(GameStateUndo & undo) const
+{
+    undo.progressHash = _hash;
+    undo.progressFinished.clear();
+    undo.progressAdded.clear();
+}
+
+// actions are always finished before new ones are added in doAction, so undo in the opposite order
+void ActionsInProgress::restore(const GameStateUndo & undo)
+{
+    for (size_t i(undo.progressAdded.size()); i > 0; --i)
+    {
+        const size_t index = undo.progressAdded[i-1];
+
+        _numProgress[_inProgress[index]._action.ID()]--;
+        _inProgress.removeByShift(index);
+    }
+
+    // finished actions were popped from the back, so pushing them back in reverse restores the order exactly
+    for (size_t i(undo.progressFinished.size()); i > 0; --i)
+    {
+        const ActionInProgress & finished = undo.progressFinished[i-1];
+
+        _inProgress.push_back(finished);
+        _numProgress[finished._action.ID()]++;
+    }
+
+    _hash = undo.progressHash;
+}
+
 bool ActionsInProgress::isEmpty() const
 {
 	return _inProgress.size() == 0;
@@ -125,6 +179,11 @@ const ActionType & ActionsInProgress::nextAction() const
 	
 	return _inProgress[_inProgress.size()-1]._action;
 }
+
+const HashValues & ActionsInProgress::getHash() const
+{
+    return _hash;
+}
 	
 void ActionsInProgress::printActionsInProgress()
 {
@@ -10,10 +10,13 @@
 #include <math.h>
 #include "Array.hpp"
 #include "ActionType.h"
+#include "Hash.h"
 
 namespace BOSS
 {
 
+class GameStateUndo;
+
 class ActionInProgress
 {
 
@@ -45,6 +48,7 @@ class ActionsInProgress
 {
 	Vec<ActionInProgress, Constants::MAX_PROGRESS>	    _inProgress;
     Vec<UnitCountType, Constants::MAX_ACTIONS>          _numProgress;	// how many of each unit are in progress
+    HashValues                                          _hash;          // hash of every (action, finish time) in progress
 	
 public:
 
@@ -53,8 +57,10 @@ public:
 	UnitCountType operator [] (const ActionType & action) const;
 	UnitCountType numInProgress(const ActionType & action) const;
 	
-	void addAction(const ActionType & a, int time);
-	void popNextAction();
+	void addAction(const ActionType & a, int time, GameStateUndo * undo = nullptr);
+	void popNextAction(GameStateUndo * undo = nullptr);
+    void saveUndo(GameStateUndo & undo) const;
+    void restore(const GameStateUndo & undo);
 	bool isEmpty() const;
 	const UnitCountType size() const;
 
@@ -69,6 +75,7 @@ public:
 	
 	const ActionType & getAction(const UnitCountType index) const;
 	const ActionType & nextAction() const;
+    const HashValues & getHash() const;
 	
 	void printActionsInProgress();
 };
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Common.h"
+#include "ActionType.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace BOSS
+{
+
+typedef unsigned long long ActionMaskType;
+
+namespace BitOps
+{
+    inline size_t PopCount(const ActionMaskType mask)
+    {
+#ifdef _MSC_VER
+        return (size_t)__popcnt64(mask);
+#else
+        return (size_t)__builtin_popcountll(mask);
+#endif
+    }
+
+    // index of the lowest set bit, mask must not be zero
+    inline size_t LowestBit(const ActionMaskType mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return (size_t)index;
+#else
+        return (size_t)__builtin_ctzll(mask);
+#endif
+    }
+}
+
+// a set of action types of one race stored as one bit per ActionID
+// Constants::MAX_ACTIONS is 64 so every action of a race fits in a single word
+// iteration is always in increasing ActionID order
+class ActionMask
+{
+    ActionMaskType      _mask;
+
+public:
+
+    ActionMask()
+        : _mask(0)
+    {
+
+    }
+
+    explicit ActionMask(const ActionMaskType mask)
+        : _mask(mask)
+    {
+
+    }
+
+    static ActionMaskType Bit(const ActionID id)
+    {
+        BOSS_ASSERT(id < Constants::MAX_ACTIONS, "ActionID doesn't fit in an action mask: %d", (int)id);
+
+        return 1ull << id;
+    }
+
+    static ActionMaskType Bit(const ActionType & action)
+    {
+        return Bit(action.ID());
+    }
+
+    ActionMaskType getMask() const
+    {
+        return _mask;
+    }
+
+    size_t size() const
+    {
+        return BitOps::PopCount(_mask);
+    }
+
+    bool isEmpty() const
+    {
+        return _mask == 0;
+    }
+
+    bool contains(const ActionType & action) const
+    {
+        return (_mask & Bit(action)) != 0;
+    }
+
+    bool containsAll(const ActionMask & set) const
+    {
+        return (set._mask & ~_mask) == 0;
+    }
+
+    void add(const ActionType & action)
+    {
+        _mask |= Bit(action);
+    }
+
+    void add(const ActionMask & set)
+    {
+        _mask |= set._mask;
+    }
+
+    void remove(const ActionType & action)
+    {
+        _mask &= ~Bit(action);
+    }
+
+    void remove(const ActionMask & set)
+    {
+        _mask &= ~set._mask;
+    }
+
+    void clear()
+    {
+        _mask = 0;
+    }
+
+    // the lowest ActionID in the set, the set must not be empty
+    ActionID first() const
+    {
+        BOSS_ASSERT(_mask != 0, "Tried to get the first action of an empty mask");
+
+        return (ActionID)BitOps::LowestBit(_mask);
+    }
+
+    // removes and returns the lowest ActionID in the set
+    ActionID popFirst()
+    {
+        const ActionID id = first();
+        _mask &= _mask - 1;
+
+        return id;
+    }
+
+    bool operator == (const ActionMask & rhs) const
+    {
+        return _mask == rhs._mask;
+    }
+
+    bool operator != (const ActionMask & rhs) const
+    {
+        return _mask != rhs._mask;
+    }
+};
+
+}
@@ -22,34 +22,47 @@ const ActionType & ActionSet::operator [] (const size_t & index) const
     return _actionTypes[index];
 }
 
-ActionType & ActionSet::operator [] (const size_t & index)
+const ActionMask & ActionSet::getMask() const
 {
-    return _actionTypes[index];
+    return _mask;
 }
 
 const bool ActionSet::contains(const ActionType & action) const
 {
-    return _actionTypes.contains(action);
+    return _mask.contains(action);
 }
 
 void ActionSet::add(const ActionType & action)
 {
     _actionTypes.push_back(action);
+    _mask.add(action);
 }
 
 void ActionSet::remove(const ActionType & action)
 {
+    if (!_mask.contains(action))
+    {
+        return;
+    }
+
     for (size_t i(0); i<_actionTypes.size(); ++i)
     {
         if (_actionTypes[i] == action)
         {
             _actionTypes.removeByShift(i);
-            return;
+            break;
         }
     }
+
+    // the same action can be added more than once, so only clear it from the mask when the last one is removed
+    if (!_actionTypes.contains(action))
+    {
+        _mask.remove(action);
+    }
 }
 
 void ActionSet::clear()
 {
     _actionTypes.clear();
+    _mask.clear();
 }
\ No newline at end of file
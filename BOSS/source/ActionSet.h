@@ -4,13 +4,17 @@
 #include "Constants.h"
 #include "Array.hpp"
 #include "ActionType.h"
+#include "ActionMask.h"
 
 namespace BOSS
 {
 
+// keeps the order actions were added in, which the searches use as their child ordering
+// the mask of the same actions makes contains and remove constant time checks
 class ActionSet
 {
 	Vec<ActionType, Constants::MAX_ACTION_TYPES> _actionTypes;
+    ActionMask                                   _mask;
 
 public:
 
@@ -21,7 +25,7 @@ public:
     const bool contains(const ActionType & type) const;
 
     const ActionType & operator [] (const size_t & index) const;
-    ActionType & operator [] (const size_t & index);
+    const ActionMask & getMask() const;
 
     void add(const ActionType & action);
     void addAllActions(const RaceID & race);
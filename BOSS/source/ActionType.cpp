@@ -57,16 +57,11 @@ ActionType & ActionType::operator = (const ActionType & rhs)
     return *this;
 }   
 
-const ActionID              ActionType::ID()                    const { return _id; }
-const RaceID                ActionType::getRace()               const { return _race; }
-
 BWAPI::UnitType             ActionType::getUnitType()           const { return ActionTypeData::GetActionTypeData(_race, _id).getUnitType(); }
 BWAPI::UpgradeType          ActionType::getUpgradeType()        const { return ActionTypeData::GetActionTypeData(_race, _id).getUpgradeType(); }
 BWAPI::TechType             ActionType::getTechType()           const { return ActionTypeData::GetActionTypeData(_race, _id).getTechType(); }
 
 BWAPI::UnitType             ActionType::whatBuildsBWAPI()       const { return ActionTypeData::GetActionTypeData(_race, _id).whatBuildsBWAPI(); }
-ActionType		            ActionType::whatBuildsActionType()  const { return ActionTypes::GetActionType(_race, whatBuildsAction()); }
-ActionID                    ActionType::whatBuildsAction()      const { return ActionTypeData::GetActionTypeData(_race, _id).whatBuildsAction(); }	
 
 const PrerequisiteSet &     ActionType::getPrerequisites()      const { return ActionTypeData::GetActionTypeData(_race, _id).getPrerequisites(); }
 const PrerequisiteSet &     ActionType::getRecursivePrerequisites()      const { return ActionTypeData::GetActionTypeData(_race, _id).getRecursivePrerequisites(); }
@@ -76,29 +71,8 @@ const std::string &         ActionType::getName()               const { return A
 const std::string &         ActionType::getShortName()          const { return ActionTypeData::GetActionTypeData(_race, _id).getShortName(); }
 const std::string &         ActionType::getMetaName()           const { return ActionTypeData::GetActionTypeData(_race, _id).getMetaName(); }
 	
-FrameCountType              ActionType::buildTime()             const { return ActionTypeData::GetActionTypeData(_race, _id).buildTime(); }
-ResourceCountType           ActionType::mineralPrice()          const { return ActionTypeData::GetActionTypeData(_race, _id).mineralPrice(); }
 ResourceCountType           ActionType::mineralPriceScaled()    const { return ActionTypeData::GetActionTypeData(_race, _id).mineralPriceScaled(); }
-ResourceCountType           ActionType::gasPrice()              const { return ActionTypeData::GetActionTypeData(_race, _id).gasPrice(); }
 ResourceCountType           ActionType::gasPriceScaled()        const { return ActionTypeData::GetActionTypeData(_race, _id).gasPriceScaled(); }
-SupplyCountType             ActionType::supplyRequired()        const { return ActionTypeData::GetActionTypeData(_race, _id).supplyRequired(); }
-SupplyCountType             ActionType::supplyProvided()        const { return ActionTypeData::GetActionTypeData(_race, _id).supplyProvided(); }
-UnitCountType               ActionType::numProduced()           const { return ActionTypeData::GetActionTypeData(_race, _id).numProduced(); }
-
-bool                        ActionType::isAddon()               const { return ActionTypeData::GetActionTypeData(_race, _id).isAddon(); }
-bool                        ActionType::isRefinery()            const { return ActionTypeData::GetActionTypeData(_race, _id).isRefinery(); }
-bool                        ActionType::isWorker()              const { return ActionTypeData::GetActionTypeData(_race, _id).isWorker(); }
-bool                        ActionType::isBuilding()            const { return ActionTypeData::GetActionTypeData(_race, _id).isBuilding(); }
-bool                        ActionType::isResourceDepot()       const { return ActionTypeData::GetActionTypeData(_race, _id).isResourceDepot(); }
-bool                        ActionType::isSupplyProvider()      const { return ActionTypeData::GetActionTypeData(_race, _id).isSupplyProvider(); }
-bool                        ActionType::isUnit()                const { return ActionTypeData::GetActionTypeData(_race, _id).isUnit(); }
-bool                        ActionType::isTech()                const { return ActionTypeData::GetActionTypeData(_race, _id).isTech(); }
-bool                        ActionType::isUpgrade()             const { return ActionTypeData::GetActionTypeData(_race, _id).isUpgrade(); }
-bool                        ActionType::whatBuildsIsBuilding()  const { return ActionTypeData::GetActionTypeData(_race, _id).whatBuildsIsBuilding(); }
-bool                        ActionType::whatBuildsIsLarva()     const { return ActionTypeData::GetActionTypeData(_race, _id).whatBuildsIsLarva(); }
-bool                        ActionType::canProduce()            const { return ActionTypeData::GetActionTypeData(_race, _id).canProduce(); }
-bool                        ActionType::requiresAddon()         const { return ActionTypeData::GetActionTypeData(_race, _id).requiresAddon(); }
-bool                        ActionType::isMorphed()             const { return ActionTypeData::GetActionTypeData(_race, _id).isMorphed(); }
 
 bool ActionType::canBuild(const ActionType & t) const 
 { 
@@ -142,11 +116,7 @@ bool ActionType::canBuild(const ActionType & t) const
     return false;
 }
 
-ActionType                  ActionType::requiredAddonType()     const { return ActionTypes::GetActionType(_race, ActionTypeData::GetActionTypeData(_race, _id).requiredAddonID()); }
-
-const bool ActionType::operator == (const ActionType & rhs)     const { return _race == rhs._race && _id == rhs._id; }
-const bool ActionType::operator != (const ActionType & rhs)     const { return _race != rhs._race || _id != rhs._id; }
-const bool ActionType::operator <  (const ActionType & rhs)     const { return _id < rhs._id; }
+ActionType                  ActionType::requiredAddonType()     const { return ActionType(_race, ActionTypeTable::Get(_race).requiredAddon[_id]); }
 
 namespace BOSS
 {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common.h"
+#include "ActionTypeTable.h"
 
 namespace BOSS
 {
@@ -34,6 +35,8 @@ public:
 	
 	ActionID                    whatBuildsAction()      const;	
 	const PrerequisiteSet &     getPrerequisites()      const;
+    unsigned long long          getPrerequisiteMask()   const;  // the bits of the ActionMask of getPrerequisites()
+    bool                        hasSinglePrerequisites() const; // true if the mask describes all the prerequisites
     const PrerequisiteSet &     getRecursivePrerequisites()      const;
 	int                         getType()               const;
 	
@@ -73,6 +76,42 @@ public:
     const bool operator <  (const ActionType & rhs)     const;
 };
 
+// the search reads these for every node, so they come straight from the flat table rather than ActionTypeData
+inline ActionID             ActionType::whatBuildsAction()      const { return ActionTypeTable::Get(_race).whatBuilds[_id]; }
+inline ActionType           ActionType::whatBuildsActionType()  const { return ActionType(_race, ActionTypeTable::Get(_race).whatBuilds[_id]); }
+inline unsigned long long   ActionType::getPrerequisiteMask()   const { return ActionTypeTable::Get(_race).prerequisiteMask[_id]; }
+inline bool                 ActionType::hasSinglePrerequisites() const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::SinglePrerequisites) != 0; }
+
+inline FrameCountType       ActionType::buildTime()             const { return ActionTypeTable::Get(_race).buildTime[_id]; }
+inline ResourceCountType    ActionType::mineralPrice()          const { return ActionTypeTable::Get(_race).mineralPrice[_id]; }
+inline ResourceCountType    ActionType::gasPrice()              const { return ActionTypeTable::Get(_race).gasPrice[_id]; }
+inline SupplyCountType      ActionType::supplyRequired()        const { return ActionTypeTable::Get(_race).supplyRequired[_id]; }
+inline SupplyCountType      ActionType::supplyProvided()        const { return ActionTypeTable::Get(_race).supplyProvided[_id]; }
+inline UnitCountType        ActionType::numProduced()           const { return ActionTypeTable::Get(_race).numProduced[_id]; }
+
+inline bool                 ActionType::isRefinery()            const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::Refinery) != 0; }
+inline bool                 ActionType::isWorker()              const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::Worker) != 0; }
+inline bool                 ActionType::isBuilding()            const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::Building) != 0; }
+inline bool                 ActionType::isResourceDepot()       const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::ResourceDepot) != 0; }
+inline bool                 ActionType::isSupplyProvider()      const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::SupplyProvider) != 0; }
+inline bool                 ActionType::isUnit()                const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::Unit) != 0; }
+inline bool                 ActionType::isTech()                const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::Tech) != 0; }
+inline bool                 ActionType::isUpgrade()             const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::Upgrade) != 0; }
+inline bool                 ActionType::isAddon()               const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::Addon) != 0; }
+inline bool                 ActionType::requiresAddon()         const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::RequiresAddon) != 0; }
+inline bool                 ActionType::isMorphed()             const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::Morphed) != 0; }
+inline bool                 ActionType::whatBuildsIsBuilding()  const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::WhatBuildsIsBuilding) != 0; }
+inline bool                 ActionType::whatBuildsIsLarva()     const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::WhatBuildsIsLarva) != 0; }
+inline bool                 ActionType::canProduce()            const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::CanProduce) != 0; }
+inline bool                 ActionType::canAttack()             const { return (ActionTypeTable::Get(_race).flags[_id] & ActionTypeTable::CanAttack) != 0; }
+
+inline const ActionID       ActionType::ID()                    const { return _id; }
+inline const RaceID         ActionType::getRace()               const { return _race; }
+
+inline const bool ActionType::operator == (const ActionType & rhs)     const { return _race == rhs._race && _id == rhs._id; }
+inline const bool ActionType::operator != (const ActionType & rhs)     const { return _race != rhs._race || _id != rhs._id; }
+inline const bool ActionType::operator <  (const ActionType & rhs)     const { return _id < rhs._id; }
+
 class ActionSet;
 
 namespace ActionTypes
@@ -0,0 +1,52 @@
+#include "ActionTypeTable.h"
+#include "ActionTypeData.h"
+
+using namespace BOSS;
+
+ActionTypeTable ActionTypeTable::Tables[Races::None + 1];
+
+// copies the numbers out of ActionTypeData, which must be initialized first
+void ActionTypeTable::Init()
+{
+    for (RaceID r(0); r < Races::NUM_RACES; ++r)
+    {
+        ActionTypeTable & table = Tables[r];
+        table = ActionTypeTable();
+
+        for (ActionID a(0); a < ActionTypeData::GetNumActionTypes(r); ++a)
+        {
+            BOSS_ASSERT(a < Constants::MAX_ACTIONS, "Too many actions for the action type table: %d", (int)a);
+
+            const ActionTypeData & data = ActionTypeData::GetActionTypeData(r, a);
+
+            table.buildTime[a]          = data.buildTime();
+            table.mineralPrice[a]       = data.mineralPrice();
+            table.gasPrice[a]           = data.gasPrice();
+            table.supplyRequired[a]     = data.supplyRequired();
+            table.supplyProvided[a]     = data.supplyProvided();
+            table.numProduced[a]        = data.numProduced();
+            table.whatBuilds[a]         = data.whatBuildsAction();
+            table.requiredAddon[a]      = data.requiredAddonID();
+            table.prerequisiteMask[a]   = data.getPrerequisites().getMask().getMask();
+
+            unsigned int flags = 0;
+            flags |= data.isBuilding()                      ? Building              : 0;
+            flags |= data.isWorker()                        ? Worker                : 0;
+            flags |= data.isRefinery()                      ? Refinery              : 0;
+            flags |= data.isResourceDepot()                 ? ResourceDepot         : 0;
+            flags |= data.isSupplyProvider()                ? SupplyProvider        : 0;
+            flags |= data.isUnit()                          ? Unit                  : 0;
+            flags |= data.isTech()                          ? Tech                  : 0;
+            flags |= data.isUpgrade()                       ? Upgrade               : 0;
+            flags |= data.isAddon()                         ? Addon                 : 0;
+            flags |= data.requiresAddon()                   ? RequiresAddon         : 0;
+            flags |= data.isMorphed()                       ? Morphed               : 0;
+            flags |= data.whatBuildsIsBuilding()            ? WhatBuildsIsBuilding  : 0;
+            flags |= data.whatBuildsIsLarva()               ? WhatBuildsIsLarva     : 0;
+            flags |= data.canProduce()                      ? CanProduce            : 0;
+            flags |= data.canAttack()                       ? CanAttack             : 0;
+            flags |= data.getPrerequisites().hasSingleCounts() ? SinglePrerequisites : 0;
+            table.flags[a] = flags;
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Common.h"
+
+namespace BOSS
+{
+
+// the numbers the search reads about every action, one array per field and one table per race, indexed by ActionID
+// the tables are a few kilobytes in total so they stay in cache, unlike ActionTypeData which also holds the
+// names and BWAPI types. names are only needed for printing and still come from ActionTypeData
+class ActionTypeTable
+{
+public:
+
+    enum Flags
+    {
+        Building                = 1 << 0,
+        Worker                  = 1 << 1,
+        Refinery                = 1 << 2,
+        ResourceDepot           = 1 << 3,
+        SupplyProvider          = 1 << 4,
+        Unit                    = 1 << 5,
+        Tech                    = 1 << 6,
+        Upgrade                 = 1 << 7,
+        Addon                   = 1 << 8,
+        RequiresAddon           = 1 << 9,
+        Morphed                 = 1 << 10,
+        WhatBuildsIsBuilding    = 1 << 11,
+        WhatBuildsIsLarva       = 1 << 12,
+        CanProduce              = 1 << 13,
+        CanAttack               = 1 << 14,
+        SinglePrerequisites     = 1 << 15       // no prerequisite is needed more than once, so the mask describes them all
+    };
+
+    FrameCountType          buildTime[Constants::MAX_ACTIONS];
+    ResourceCountType       mineralPrice[Constants::MAX_ACTIONS];
+    ResourceCountType       gasPrice[Constants::MAX_ACTIONS];
+    SupplyCountType         supplyRequired[Constants::MAX_ACTIONS];
+    SupplyCountType         supplyProvided[Constants::MAX_ACTIONS];
+    UnitCountType           numProduced[Constants::MAX_ACTIONS];
+    ActionID                whatBuilds[Constants::MAX_ACTIONS];
+    ActionID                requiredAddon[Constants::MAX_ACTIONS];
+    unsigned int            flags[Constants::MAX_ACTIONS];
+    unsigned long long      prerequisiteMask[Constants::MAX_ACTIONS];   // same bits as ActionMask
+
+    static void Init();
+
+    // Races::None has a table of zeros, so the None action has no cost, no flags and nothing builds it
+    static const ActionTypeTable & Get(const RaceID race)
+    {
+        return Tables[race];
+    }
+
+private:
+
+    static ActionTypeTable Tables[Races::None + 1];
+};
+
+}
@@ -5,6 +5,7 @@ namespace BOSS
     void init()
     {
         ActionTypeData::Init();
+        ActionTypeTable::Init();
         ActionTypes::init();
     }
 
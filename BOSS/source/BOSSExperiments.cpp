@@ -2,9 +2,136 @@
 
 #include "CombatSearchExperiment.h"
 #include "BOSSPlotBuildOrders.h"
+#include "BOSSParameters.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include <atomic>
+#include <fstream>
+#include <thread>
 
 using namespace BOSS;
 
+namespace
+{
+    // an experiment of a batch run and what it found
+    class BatchExperiment
+    {
+    public:
+
+        std::string                 name;
+        std::string                 type;
+        const rapidjson::Value *    val;
+        std::string                 error;      // empty if the experiment finished
+        double                      timeElapsed;
+        std::vector<CombatSearchExperimentResult> results;
+
+        BatchExperiment()
+            : val(nullptr)
+            , timeElapsed(0)
+        {
+
+        }
+    };
+
+    bool IsExperimentToRun(const rapidjson::Value & val)
+    {
+        return val.HasMember("Run") && val["Run"].IsBool() && (val["Run"].GetBool() == true);
+    }
+
+    void RunBatchExperiment(const std::string & experimentFilename, BatchExperiment & experiment)
+    {
+        Timer timer;
+        timer.start();
+
+        try
+        {
+            BOSSParameters params;
+            params.ParseParameters(experimentFilename);
+
+            if (experiment.type == "CombatSearch")
+            {
+                CombatSearchExperiment exp(experiment.name, *experiment.val, params);
+                exp.run();
+                experiment.results = exp.getResults();
+            }
+            else if (experiment.type == "BuildOrderPlot")
+            {
+                BOSSPlotBuildOrders plot(experiment.name, *experiment.val, params);
+                plot.doPlots();
+            }
+            else
+            {
+                BOSS_ASSERT(false, "Unknown Experiment Type: %s", experiment.type.c_str());
+            }
+        }
+        catch (const std::exception & e)
+        {
+            experiment.error = e.what();
+        }
+
+        experiment.timeElapsed = timer.getElapsedTimeInMilliSec();
+    }
+
+    void WriteBatchResults(const std::vector<BatchExperiment> & experiments, const std::string & resultsFilename, const size_t jobs, const double timeElapsed)
+    {
+        rapidjson::StringBuffer buffer;
+        rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+
+        writer.StartObject();
+        writer.String("Jobs");                  writer.Uint64(jobs);
+        writer.String("TimeMS");                writer.Double(timeElapsed);
+        writer.String("Experiments");
+        writer.StartArray();
+
+        for (size_t e(0); e < experiments.size(); ++e)
+        {
+            const BatchExperiment & experiment = experiments[e];
+
+            writer.StartObject();
+            writer.String("Name");              writer.String(experiment.name.c_str());
+            writer.String("Type");              writer.String(experiment.type.c_str());
+            writer.String("Completed");         writer.Bool(experiment.error.empty());
+            writer.String("Error");             writer.String(experiment.error.c_str());
+            writer.String("TimeMS");            writer.Double(experiment.timeElapsed);
+            writer.String("Searches");
+            writer.StartArray();
+
+            for (size_t s(0); s < experiment.results.size(); ++s)
+            {
+                const CombatSearchExperimentResult & result = experiment.results[s];
+
+                writer.StartObject();
+                writer.String("Search");        writer.String(result.searchType.c_str());
+                writer.String("Solved");        writer.Bool(result.results.solved);
+                writer.String("TimedOut");      writer.Bool(result.results.timedOut);
+                writer.String("NodesExpanded"); writer.Uint64(result.results.nodesExpanded);
+                writer.String("NodesDominated");writer.Uint64(result.results.nodesDominated);
+                writer.String("TimeMS");        writer.Double(result.results.timeElapsed);
+                writer.String("BestEval");      writer.Double(result.bestEval);
+                writer.String("BuildOrder");
+                writer.StartArray();
+                for (size_t a(0); a < result.bestBuildOrder.size(); ++a)
+                {
+                    writer.String(result.bestBuildOrder[a].getName().c_str());
+                }
+                writer.EndArray();
+                writer.EndObject();
+            }
+
+            writer.EndArray();
+            writer.EndObject();
+        }
+
+        writer.EndArray();
+        writer.EndObject();
+
+        std::ofstream fout(resultsFilename.c_str());
+        BOSS_ASSERT(fout.good(), "Couldn't open results file: %s", resultsFilename.c_str());
+        fout << buffer.GetString() << "\n";
+    }
+}
+
 void Experiments::RunExperiments(const std::string & experimentFilename)
 {
     rapidjson::Document document;
@@ -21,7 +148,7 @@ void Experiments::RunExperiments(const std::string & experimentFilename)
         //std::cout << "Found Experiment:   " << name << std::endl;
         BOSS_ASSERT(val.HasMember("Type") && val["Type"].IsString(), "Experiment has no 'Type' string");
 
-        if (val.HasMember("Run") && val["Run"].IsBool() && (val["Run"].GetBool() == true))
+        if (IsExperimentToRun(val))
         {   
             const std::string & type = val["Type"].GetString();
 
@@ -43,6 +170,59 @@ void Experiments::RunExperiments(const std::string & experimentFilename)
     std::cout << "\n\n";
 }
 
+void Experiments::RunExperimentBatch(const std::string & experimentFilename, const std::string & resultsFilename, const size_t jobs)
+{
+    rapidjson::Document document;
+    JSONTools::ParseJSONFile(document, experimentFilename);
+
+    BOSS_ASSERT(document.HasMember("Experiments"), "No 'Experiments' member found");
+
+    std::vector<BatchExperiment> experiments;
+    const rapidjson::Value & experimentsVal = document["Experiments"];
+    for (rapidjson::Value::ConstMemberIterator itr = experimentsVal.MemberBegin(); itr != experimentsVal.MemberEnd(); ++itr)
+    {
+        const rapidjson::Value & val = itr->value;
+        BOSS_ASSERT(val.HasMember("Type") && val["Type"].IsString(), "Experiment has no 'Type' string");
+
+        if (IsExperimentToRun(val))
+        {
+            BatchExperiment experiment;
+            experiment.name = itr->name.GetString();
+            experiment.type = val["Type"].GetString();
+            experiment.val  = &val;
+            experiments.push_back(experiment);
+        }
+    }
+
+    Timer timer;
+    timer.start();
+
+    // each thread takes the next experiment nobody has started, the document is only read while they run
+    const size_t numThreads = std::max((size_t)1, std::min(jobs, experiments.size()));
+    std::atomic<size_t> nextExperiment(0);
+    std::vector<std::thread> threads;
+
+    for (size_t t(0); t < numThreads; ++t)
+    {
+        threads.push_back(std::thread([&]()
+        {
+            for (size_t e = nextExperiment++; e < experiments.size(); e = nextExperiment++)
+            {
+                RunBatchExperiment(experimentFilename, experiments[e]);
+            }
+        }));
+    }
+
+    for (size_t t(0); t < threads.size(); ++t)
+    {
+        threads[t].join();
+    }
+
+    WriteBatchResults(experiments, resultsFilename, numThreads, timer.getElapsedTimeInMilliSec());
+
+    std::cout << "\n\nRan " << experiments.size() << " experiments on " << numThreads << " threads in " << timer.getElapsedTimeInMilliSec() << "ms, results written to " << resultsFilename << "\n";
+}
+
 void Experiments::RunCombatExperiment(const std::string & name, const rapidjson::Value & val)
 {
     CombatSearchExperiment exp(name, val);
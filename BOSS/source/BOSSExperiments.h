@@ -12,6 +12,11 @@ namespace Experiments
 {
     void RunExperiments(const std::string & experimentFilename);
 
+    // runs the experiments on up to jobs threads at once and writes all their results to one json file
+    // each experiment parses its own parameters from the config file, so experiments share no state
+    // an experiment which fails has its error written to the results instead of stopping the batch
+    void RunExperimentBatch(const std::string & experimentFilename, const std::string & resultsFilename, const size_t jobs);
+
     void RunCombatExperiment(const std::string & name, const rapidjson::Value & val);
     void RunBuildOrderPlot(const std::string & name, const rapidjson::Value & val);
 }
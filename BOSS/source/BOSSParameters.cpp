@@ -58,23 +58,26 @@ void BOSSParameters::ParseParameters(const std::string & configFile)
     }
 }
 
-const GameState & BOSSParameters::GetState(const std::string & key)
+const GameState & BOSSParameters::GetState(const std::string & key) const
 {
-    BOSS_ASSERT(_stateMap.find(key) != _stateMap.end(), "Couldn't find state: %s", key.c_str());
+    auto it = _stateMap.find(key);
+    BOSS_ASSERT(it != _stateMap.end(), "Couldn't find state: %s", key.c_str());
 
-    return _stateMap[key];
+    return it->second;
 }
 
-const BuildOrder & BOSSParameters::GetBuildOrder(const std::string & key)
+const BuildOrder & BOSSParameters::GetBuildOrder(const std::string & key) const
 {
-    BOSS_ASSERT(_buildOrderMap.find(key) != _buildOrderMap.end(), "Couldn't find build order: %s", key.c_str());
+    auto it = _buildOrderMap.find(key);
+    BOSS_ASSERT(it != _buildOrderMap.end(), "Couldn't find build order: %s", key.c_str());
 
-    return _buildOrderMap[key];
+    return it->second;
 }
 
-const BuildOrderSearchGoal & BOSSParameters::GetBuildOrderSearchGoalMap(const std::string & key)
+const BuildOrderSearchGoal & BOSSParameters::GetBuildOrderSearchGoalMap(const std::string & key) const
 {
-    BOSS_ASSERT(_buildOrderSearchGoalMap.find(key) != _buildOrderSearchGoalMap.end(), "Couldn't find state: %s", key.c_str());
+    auto it = _buildOrderSearchGoalMap.find(key);
+    BOSS_ASSERT(it != _buildOrderSearchGoalMap.end(), "Couldn't find state: %s", key.c_str());
 
-    return _buildOrderSearchGoalMap[key];
+    return it->second;
 }
\ No newline at end of file
@@ -16,16 +16,17 @@ class BOSSParameters
     std::map<std::string, GameState>            _stateMap;
     std::map<std::string, BuildOrder>           _buildOrderMap;
     std::map<std::string, BuildOrderSearchGoal> _buildOrderSearchGoalMap;
-    
-    BOSSParameters();
 
 public:
 
+    // experiments run in a batch each parse their own parameters instead of sharing the instance
+    BOSSParameters();
+
     static BOSSParameters & Instance();
     void ParseParameters(const std::string & configFile);
 
-    const GameState &               GetState(const std::string & key);
-    const BuildOrder &              GetBuildOrder(const std::string & key);
-    const BuildOrderSearchGoal &    GetBuildOrderSearchGoalMap(const std::string & key);
+    const GameState &               GetState(const std::string & key) const;
+    const BuildOrder &              GetBuildOrder(const std::string & key) const;
+    const BuildOrderSearchGoal &    GetBuildOrderSearchGoalMap(const std::string & key) const;
 };
 }
@@ -8,6 +8,8 @@
 namespace BOSS
 {
 
+class BOSSParameters;
+
 class BOSSPlotBuildOrders
 {
     std::vector<GameState>      _states;
@@ -18,6 +20,7 @@ class BOSSPlotBuildOrders
 public:
 
     BOSSPlotBuildOrders(const std::string & name, const rapidjson::Value & experimentVal);
+    BOSSPlotBuildOrders(const std::string & name, const rapidjson::Value & experimentVal, const BOSSParameters & bossParams);
     
     void doPlots();
 };
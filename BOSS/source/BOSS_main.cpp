@@ -35,11 +35,29 @@ int main2()
     return 0;
 }
 
+// BOSS [--jobs N] [--results BOSS_Results.json]
+// with --jobs the experiments are run as a batch on up to N threads, and their results written to one json file
 int main(int argc, char *argv[])
 {
+    size_t jobs = 0;
+    std::string resultsFile = "BOSS_Results.json";
+
+    for (int i(1); i + 1 < argc; i += 2)
+    {
+        const std::string arg(argv[i]);
+        if      (arg == "--jobs")    { jobs = std::max(atoi(argv[i + 1]), 1); }
+        else if (arg == "--results") { resultsFile = argv[i + 1]; }
+    }
+
     // Initialize all the BOSS internal data
     BOSS::init();
 
+    if (jobs > 0)
+    {
+        BOSS::Experiments::RunExperimentBatch("BOSS_Config.txt", resultsFile, jobs);
+        return 0;
+    }
+
     // Read in the config parameters that will be used for experiments
     BOSS::BOSSParameters::Instance().ParseParameters("BOSS_Config.txt");
     
@@ -0,0 +1,233 @@
+#include "BeamBuildOrderSearch.h"
+#include "DFBB_BuildOrderStackSearch.h"
+#include "Tools.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+using namespace BOSS;
+
+BeamBuildOrderSearch::BeamBuildOrderSearch(const DFBB_BuildOrderSearchParameters & p)
+    : _params(p)
+    , _lowerBound(p.goal)
+    , _beamIndex(0)
+    , _width(0)
+    , _budgetStartNodes(0)
+    , _firstSearch(true)
+    , _finished(false)
+{
+
+}
+
+void BeamBuildOrderSearch::search()
+{
+    search(_params.getBudget());
+}
+
+// searches until the last pass is finished or the budget is used up, and returns true if it finished
+// a paused search keeps its beam, so the next call carries on from the state it stopped at
+bool BeamBuildOrderSearch::search(const DFBB_SearchBudget & budget)
+{
+    _searchTimer.start();
+    _budget = budget;
+    _budgetStartNodes = _results.nodesExpanded;
+
+    if (_finished)
+    {
+        return true;
+    }
+
+    if (_firstSearch)
+    {
+        BOSS_ASSERT(_params.initialState.getRace() != Races::None, "Beam search initial state has no race");
+
+        _firstSearch = false;
+        _width = std::max((size_t)1, _params.beamWidth);
+
+        // a build order has to beat the naive one to count as a solution, the same as in DFBB
+        _results.upperBound = _params.initialUpperBound ? _params.initialUpperBound : Tools::GetUpperBound(_params.initialState, _params.goal);
+
+        if (_params.goal.isAchievedBy(_params.initialState))
+        {
+            _finished = true;
+            _results.solved = true;
+            _results.solutionFound = true;
+            _results.finalState = _params.initialState;
+            _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+            return true;
+        }
+
+        startPass();
+    }
+
+    _results.timedOut = false;
+
+    while (true)
+    {
+        while (_beamIndex < _beam.size())
+        {
+            if (isOutOfBudget())
+            {
+                _results.timedOut = true;
+                _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+                return false;
+            }
+
+            expand(_beam[_beamIndex++]);
+        }
+
+        // go one action deeper with the best of the children
+        if (!_children.empty())
+        {
+            selectBeam();
+            continue;
+        }
+
+        // every state in the beam reached the goal or was pruned, so this pass is over
+        _width *= 2;
+        if (_width > _params.maxBeamWidth)
+        {
+            break;
+        }
+
+        startPass();
+    }
+
+    // the beam proves nothing about the states it cut, so the search is finished but not solved
+    _finished = true;
+    _results.solved = false;
+    _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+
+    return true;
+}
+
+const DFBB_BuildOrderSearchResults & BeamBuildOrderSearch::getResults() const
+{
+    return _results;
+}
+
+bool BeamBuildOrderSearch::isOutOfBudget()
+{
+    const unsigned long long nodes = _results.nodesExpanded - _budgetStartNodes;
+
+    if (_budget.nodeLimit && (nodes >= _budget.nodeLimit))
+    {
+        return true;
+    }
+
+    // a beam node copies a state for every child, so the clock is cheap enough to read every node
+    return (_budget.timeLimit > 0) && (_searchTimer.getElapsedTimeInMilliSec() > _budget.timeLimit);
+}
+
+void BeamBuildOrderSearch::startPass()
+{
+    _beam.assign(1, BeamSearchNode());
+    _beam[0].state = _params.initialState;
+    _beamIndex = 0;
+    _children.clear();
+}
+
+// adds the children of the node which could still beat the best build order so far
+// children which reach the goal are solutions and aren't searched any further
+void BeamBuildOrderSearch::expand(const BeamSearchNode & node)
+{
+    _results.nodesExpanded++;
+    BOSS_STATS(_results.stats.addNode(node.buildOrder.size()));
+
+    const RaceID race = node.state.getRace();
+    const FrameCountType heuristicTime = node.state.getCurrentFrame() + _lowerBound.get(node.state);
+
+    ActionMask legal(DFBB_BuildOrderStackSearch::GetLegalActions(_params, node.state, &_results.stats));
+    while (!legal.isEmpty())
+    {
+        const ActionType & actionType = ActionTypes::GetActionType(race, legal.popFirst());
+        const FrameCountType actionFinishTime = BOSS_STATS_CALL(&_results.stats, StateCalls::WhenCanPerform, node.state.whenCanPerform(actionType)) + actionType.buildTime();
+
+        if (std::max(actionFinishTime, heuristicTime) >= _results.upperBound)
+        {
+            BOSS_STATS(_results.stats.addPruned(PruneReasons::UpperBound));
+            continue;
+        }
+
+        BOSS_STATS(_results.stats.addChild(node.buildOrder.size()));
+
+        _children.push_back(node);
+        BeamSearchNode & child = _children[_children.size() - 1];
+        BOSS_STATS_CALL(&_results.stats, StateCalls::DoAction, child.state.doAction(actionType));
+        child.buildOrder.add(actionType);
+
+        if (_params.goal.isAchievedBy(child.state))
+        {
+            updateResults(child);
+            _children.pop_back();
+            continue;
+        }
+
+        child.bound = std::max(child.state.getLastActionFinishTime(), child.state.getCurrentFrame() + _lowerBound.get(child.state));
+        if (child.bound >= _results.upperBound)
+        {
+            _children.pop_back();
+        }
+    }
+}
+
+// the next beam is the children with the lowest bounds, earlier frames first when the bounds are equal
+// children with the same units as one already taken are left out so the beam doesn't fill up with
+// different orderings of the same actions
+void BeamBuildOrderSearch::selectBeam()
+{
+    std::vector<size_t> order(_children.size());
+    for (size_t i(0); i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [this](const size_t a, const size_t b)
+    {
+        if (_children[a].bound != _children[b].bound)
+        {
+            return _children[a].bound < _children[b].bound;
+        }
+
+        return _children[a].state.getCurrentFrame() < _children[b].state.getCurrentFrame();
+    });
+
+    std::unordered_set<HashType> taken;
+
+    _beam.clear();
+    for (size_t i(0); (i < order.size()) && (_beam.size() < _width); ++i)
+    {
+        BeamSearchNode & child = _children[order[i]];
+
+        if (!taken.insert(child.state.getHash().getValue(0)).second)
+        {
+            continue;
+        }
+
+        _beam.push_back(std::move(child));
+    }
+
+    _children.clear();
+    _beamIndex = 0;
+}
+
+void BeamBuildOrderSearch::updateResults(const BeamSearchNode & node)
+{
+    const FrameCountType finishTime = node.state.getLastActionFinishTime();
+
+    if (finishTime >= _results.upperBound)
+    {
+        return;
+    }
+
+    _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+    if (!_results.solutionFound)
+    {
+        _results.firstSolutionTime = _results.timeElapsed;
+    }
+
+    _results.upperBound = finishTime;
+    _results.solutionFound = true;
+    _results.finalState = node.state;
+    _results.buildOrder = node.buildOrder;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "BuildOrder.h"
+#include "DFBB_BuildOrderSearchParameters.h"
+#include "DFBB_BuildOrderSearchResults.h"
+#include "DFBB_LowerBound.h"
+#include "Timer.hpp"
+
+namespace BOSS
+{
+
+class BeamSearchNode
+{
+public:
+
+    GameState           state;
+    BuildOrder          buildOrder;
+    FrameCountType      bound;          // the earliest frame the goal could be reached from this state
+
+    BeamSearchNode()
+        : bound(0)
+    {
+
+    }
+};
+
+// an anytime beam search for goals too large for DFBB to finish
+// each pass keeps only the best states at every depth, ordered by the same lower bound DFBB prunes with,
+// so it finds a build order in a fixed number of nodes but doesn't prove it is the best one
+// later passes use a wider beam and the best build order so far as the upper bound
+class BeamBuildOrderSearch
+{
+    DFBB_BuildOrderSearchParameters     _params;
+    DFBB_BuildOrderSearchResults        _results;
+    DFBB_LowerBound                     _lowerBound;
+
+    Timer                               _searchTimer;
+
+    std::vector<BeamSearchNode>         _beam;          // the states at the current depth
+    std::vector<BeamSearchNode>         _children;      // their children, cut down to the next beam once the depth is done
+    size_t                              _beamIndex;     // the next state in the beam to expand
+    size_t                              _width;
+
+    DFBB_SearchBudget                   _budget;
+    unsigned long long                  _budgetStartNodes;
+
+    bool                                _firstSearch;
+    bool                                _finished;
+
+    bool                                isOutOfBudget();
+    void                                startPass();
+    void                                expand(const BeamSearchNode & node);
+    void                                selectBeam();
+    void                                updateResults(const BeamSearchNode & node);
+
+public:
+
+    BeamBuildOrderSearch(const DFBB_BuildOrderSearchParameters & p);
+
+    void search();
+    bool search(const DFBB_SearchBudget & budget);
+    const DFBB_BuildOrderSearchResults & getResults() const;
+};
+
+}
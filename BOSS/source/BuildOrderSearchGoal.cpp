@@ -110,6 +110,21 @@ std::string BuildOrderSearchGoal::toString() const
 }
 
 bool BuildOrderSearchGoal::isAchievedBy(const GameState & state)
+{
+    for (size_t a(0); a < ActionTypes::GetAllActionTypes(state.getRace()).size(); ++a)
+    {
+        if (getNumRemaining(state, ActionTypes::GetActionType(state.getRace(), a)) > 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// how many more of the action the state needs to reach the goal
+// zerg buildings count as the buildings they were morphed from, so a hive is also a lair and a hatchery
+UnitCountType BuildOrderSearchGoal::getNumRemaining(const GameState & state, const ActionType & actionType) const
 {
     static const ActionType & Hatchery      = ActionTypes::GetActionType("Zerg_Hatchery");
     static const ActionType & Lair          = ActionTypes::GetActionType("Zerg_Lair");
@@ -117,34 +132,24 @@ bool BuildOrderSearchGoal::isAchievedBy(const GameState & state)
     static const ActionType & Spire         = ActionTypes::GetActionType("Zerg_Spire");
     static const ActionType & GreaterSpire  = ActionTypes::GetActionType("Zerg_Greater_Spire");
 
-    for (size_t a(0); a < ActionTypes::GetAllActionTypes(state.getRace()).size(); ++a)
-    {
-        const ActionType & actionType = ActionTypes::GetActionType(state.getRace(), a);
-
-        int have = state.getUnitData().getNumTotal(actionType);
+    int have = state.getUnitData().getNumTotal(actionType);
 
-        if (state.getRace() == Races::Zerg)
+    if (state.getRace() == Races::Zerg)
+    {
+        if (actionType == Hatchery)
         {
-            if (actionType == Hatchery)
-            {
-                have += state.getUnitData().getNumTotal(Lair);
-                have += state.getUnitData().getNumTotal(Hive);
-            }
-            else if (actionType == Lair)
-            {
-                have += state.getUnitData().getNumTotal(Hive);
-            }
-            else if (actionType == Spire)
-            {
-                have += state.getUnitData().getNumTotal(GreaterSpire);
-            }
+            have += state.getUnitData().getNumTotal(Lair);
+            have += state.getUnitData().getNumTotal(Hive);
         }
-
-        if (have < getGoal(actionType))
+        else if (actionType == Lair)
         {
-            return false;
+            have += state.getUnitData().getNumTotal(Hive);
+        }
+        else if (actionType == Spire)
+        {
+            have += state.getUnitData().getNumTotal(GreaterSpire);
         }
     }
 
-    return true;
-}
\ No newline at end of file
+    return have < getGoal(actionType) ? (UnitCountType)(getGoal(actionType) - have) : 0;
+}
@@ -25,6 +25,7 @@ public:
 	bool                operator == (const BuildOrderSearchGoal & g);
 	bool                hasGoal() const;
     bool                isAchievedBy(const GameState & state);
+    UnitCountType       getNumRemaining(const GameState & state, const ActionType & a) const;
 
 	SupplyCountType     supplyRequired() const;
 	UnitCountType       operator [] (const ActionID & a) const;
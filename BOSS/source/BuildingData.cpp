@@ -1,4 +1,5 @@
 #include "BuildingData.h"
+#include "GameStateUndo.h"
 
 using namespace BOSS;
 
@@ -104,7 +105,6 @@ void BuildingStatus::fastForward(const FrameCountType frames)
     // if we fastforward more than the current time remaining, we will complete the action
     bool willComplete = _timeRemaining <= frames;
     int timeWasRemaining = _timeRemaining;
-    const std::string & name = _type.getName();
 
     if ((_timeRemaining > 0) && willComplete)
     {
@@ -133,9 +133,35 @@ void BuildingStatus::fastForward(const FrameCountType frames)
 }
 
 BuildingData::BuildingData() 
+    : _framesElapsed(0)
 {
 }
 
+void BuildingData::addHash(const BuildingStatus & building)
+{
+    _hash.add(Hash::Building, getHashTypes(building), getFreeFrame(building));
+}
+
+void BuildingData::removeHash(const BuildingStatus & building)
+{
+    _hash.remove(Hash::Building, getHashTypes(building), getFreeFrame(building));
+}
+
+HashType BuildingData::getHashTypes(const BuildingStatus & building) const
+{
+    return Hash::ActionKey(building._type) | (Hash::ActionKey(building._addon) << 16) | (Hash::ActionKey(building._isConstructing) << 32);
+}
+
+FrameCountType BuildingData::getFreeFrame(const BuildingStatus & building) const
+{
+    return building._timeRemaining > 0 ? _framesElapsed + building._timeRemaining : 0;
+}
+
+const HashValues & BuildingData::getHash() const
+{
+    return _hash;
+}
+
 const size_t & BuildingData::size() const
 {
     return _buildings.size();
@@ -146,6 +172,7 @@ void BuildingData::addBuilding(const ActionType & action, const ActionType & add
 	BOSS_ASSERT(action.isBuilding(), "Trying to add a non-building to the building data");
 	
     _buildings.push_back(BuildingStatus(action, addon));
+    addHash(_buildings[_buildings.size()-1]);
 }
 
 void BuildingData::removeBuilding(const ActionType & action, const ActionType & addon)
@@ -156,6 +183,7 @@ void BuildingData::removeBuilding(const ActionType & action, const ActionType &
 	{
 		if (_buildings[i]._type == action)
 		{
+            removeHash(_buildings[i]);
 			_buildings.remove(i);
 			break;
 		}
@@ -167,6 +195,7 @@ void BuildingData::addBuilding(const ActionType & action, const FrameCountType t
 	BOSS_ASSERT(action.isBuilding(), "Trying to add a non-building to the building data");
 	
     _buildings.push_back(BuildingStatus(action, timeUntilFree, constructing, addon));
+    addHash(_buildings[_buildings.size()-1]);
 }
 
 const BuildingStatus & BuildingData::getBuilding(const UnitCountType i) const
@@ -197,13 +226,20 @@ const FrameCountType BuildingData::getTimeUntilCanBuild(const ActionType & actio
     return min;
 }
 
-void BuildingData::queueAction(const ActionType & action)
+void BuildingData::queueAction(const ActionType & action, GameStateUndo * undo)
 {	
 	for (size_t i=0; i<_buildings.size(); ++i)
 	{
 		if (_buildings[i].canBuildNow(action))
 		{
+            if (undo)
+            {
+                undo->buildingsChanged.push_back(std::make_pair(i, _buildings[i]));
+            }
+
+            removeHash(_buildings[i]);
 			_buildings[i].queueActionType(action);
+            addHash(_buildings[i]);
 			return;
 		}
 	}
@@ -213,12 +249,51 @@ void BuildingData::queueAction(const ActionType & action)
 }
 	
 // fast forward all the building states by amount: frames
-void BuildingData::fastForwardBuildings(const FrameCountType frames)
+void BuildingData::fastForwardBuildings(const FrameCountType frames, GameStateUndo * undo)
 {
 	for (size_t i=0; i<_buildings.size(); ++i)
 	{
-        _buildings[i].fastForward(frames);
+        // only busy buildings change when fast forwarding
+        if (undo && (_buildings[i]._timeRemaining > 0))
+        {
+            undo->buildingsChanged.push_back(std::make_pair(i, _buildings[i]));
+        }
+
+        // a building that stays busy keeps the same free frame, so only finishing buildings change the hash
+        if ((_buildings[i]._timeRemaining > 0) && (_buildings[i]._timeRemaining <= frames))
+        {
+            removeHash(_buildings[i]);
+            _buildings[i].fastForward(frames);
+            addHash(_buildings[i]);
+        }
+        else
+        {
+            _buildings[i].fastForward(frames);
+        }
 	}
+
+    _framesElapsed += frames;
+}
+
+void BuildingData::saveUndo(GameStateUndo & undo) const
+{
+    undo.buildingHash = _hash;
+    undo.buildingFramesElapsed = _framesElapsed;
+    undo.numBuildings = _buildings.size();
+    undo.buildingsChanged.clear();
+}
+
+// buildings added since the undo was saved are at the back, so they are removed by the resize
+void BuildingData::restore(const GameStateUndo & undo)
+{
+    for (size_t i(undo.buildingsChanged.size()); i > 0; --i)
+    {
+        _buildings[undo.buildingsChanged[i-1].first] = undo.buildingsChanged[i-1].second;
+    }
+
+    _buildings.resize(undo.numBuildings);
+    _framesElapsed = undo.buildingFramesElapsed;
+    _hash = undo.buildingHash;
 }
 
 std::string BuildingData::toString() const
@@ -9,9 +9,12 @@
 #include "PrerequisiteSet.h"
 #include "Array.hpp"
 #include "ActionType.h"
+#include "Hash.h"
 
 namespace BOSS
 {
+
+class GameStateUndo;
     
 class BuildingStatus
 {
@@ -43,6 +46,14 @@ class BuildingData
 {
 	Vec<BuildingStatus, Constants::MAX_BUILDINGS> _buildings;
 
+    FrameCountType  _framesElapsed;     // total frames fast forwarded, used to hash busy buildings by the frame they become free
+    HashValues      _hash;
+
+    void addHash(const BuildingStatus & building);
+    void removeHash(const BuildingStatus & building);
+    HashType getHashTypes(const BuildingStatus & building) const;
+    FrameCountType getFreeFrame(const BuildingStatus & building) const;
+
 public:
 
 	BuildingData();
@@ -56,14 +67,18 @@ public:
     const FrameCountType getTimeUntilCanBuild(const ActionType & action) const;
 
 	// queue an action
-	void queueAction(const ActionType & action);
-	void fastForwardBuildings(const FrameCountType frames);
+	void queueAction(const ActionType & action, GameStateUndo * undo = nullptr);
+	void fastForwardBuildings(const FrameCountType frames, GameStateUndo * undo = nullptr);
+    void saveUndo(GameStateUndo & undo) const;
+    void restore(const GameStateUndo & undo);
 	void printBuildingInformation() const;
     const size_t & size() const;
 
     const bool canBuildNow(const ActionType & action) const;
     const bool canBuildEventually(const ActionType & action) const;
 
+    const HashValues & getHash() const;
+
     std::string toString() const;
 };
 }
\ No newline at end of file
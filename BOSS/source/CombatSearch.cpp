@@ -1,7 +1,23 @@
 #include "CombatSearch.h"
 
+#include <thread>
+
 using namespace BOSS;
 
+namespace
+{
+    // the search is split one level deeper at a time until there are this many tasks per thread
+    const size_t TasksPerThread = 16;
+    const size_t MaxSplitDepth  = 32;
+}
+
+CombatSearch::CombatSearch()
+    : _upperBound(0)
+    , _splitDepth(0)
+    , _stop(nullptr)
+{
+
+}
 
 // function which is called to do the actual search
 void CombatSearch::search()
@@ -15,7 +31,14 @@ void CombatSearch::search()
 
     try
     {
-        recurse(initialState, 0);
+        if (_params.getNumThreads() > 1)
+        {
+            searchParallel(initialState);
+        }
+        else
+        {
+            recurse(initialState, 0);
+        }
     
         _results.solved = true;
     }
@@ -30,6 +53,143 @@ void CombatSearch::search()
     _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
 }
 
+// splits the search into tasks which are searched by several threads
+// the states above the split depth are searched by this thread first, keeping their results here, and the
+// result of each task is merged into them as soon as it is done. results which are equally good are ordered
+// by where the search on one thread would have visited them, so the merged results are the same as the
+// results of that search no matter which order the tasks finish in
+void CombatSearch::searchParallel(const GameState & initialState)
+{
+    const size_t numThreads = (size_t)_params.getNumThreads();
+
+    for (_splitDepth = 1; _splitDepth <= MaxSplitDepth; ++_splitDepth)
+    {
+        startSplit();
+        recurse(initialState, 0);
+
+        // if there are no tasks the whole tree was above the split depth and has already been searched
+        if (_tasks.empty() || (_tasks.size() >= TasksPerThread * numThreads))
+        {
+            break;
+        }
+    }
+
+    _splitDepth = 0;
+
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> nextTask(0);
+    std::mutex mergeMutex;
+    _stop = &stop;
+
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(numThreads);
+
+    for (size_t t(0); t < numThreads; ++t)
+    {
+        threads.push_back(std::thread(&CombatSearch::workerThread, this, std::ref(nextTask), std::ref(mergeMutex), std::ref(errors[t])));
+    }
+
+    for (size_t t(0); t < threads.size(); ++t)
+    {
+        threads[t].join();
+    }
+
+    _stop = nullptr;
+    _tasks.clear();
+
+    for (size_t t(0); t < errors.size(); ++t)
+    {
+        if (errors[t])
+        {
+            std::rethrow_exception(errors[t]);
+        }
+    }
+
+    // the results merged so far are kept, the same as when the search on one thread times out
+    if (stop)
+    {
+        throw BOSS_COMBATSEARCH_TIMEOUT;
+    }
+}
+
+// each thread takes the next task not yet started, searches it with a worker of its own and merges the worker's results
+void CombatSearch::workerThread(std::atomic<size_t> & nextTask, std::mutex & mergeMutex, std::exception_ptr & error)
+{
+    try
+    {
+        for (size_t task = nextTask++; (task < _tasks.size()) && !(*_stop); task = nextTask++)
+        {
+            std::shared_ptr<CombatSearch> worker = createWorker(task);
+            worker->_searchTimer = _searchTimer;
+            worker->_buildOrder = _tasks[task].buildOrder;
+            worker->_stop = _stop;
+
+            try
+            {
+                worker->recurse(_tasks[task].state, _tasks[task].depth);
+            }
+            catch (int e)
+            {
+                if (e != BOSS_COMBATSEARCH_TIMEOUT)
+                {
+                    throw;
+                }
+
+                *_stop = true;
+            }
+
+            std::lock_guard<std::mutex> lock(mergeMutex);
+            _results.nodesExpanded += worker->_results.nodesExpanded;
+            _results.dominanceChecks += worker->_results.dominanceChecks;
+            _results.nodesDominated += worker->_results.nodesDominated;
+            mergeWorker(*worker);
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+        *_stop = true;
+    }
+}
+
+bool CombatSearch::isSplitNode(const size_t depth) const
+{
+    return (_splitDepth > 0) && (depth == _splitDepth);
+}
+
+// called before the states above the split depth are searched, a search which can be split also clears its results here
+void CombatSearch::startSplit()
+{
+    _tasks.clear();
+    _results.nodesExpanded = 0;
+    _results.dominanceChecks = 0;
+    _results.nodesDominated = 0;
+}
+
+// called by recurse instead of searching a state at the split depth
+void CombatSearch::addTask(const GameState & state, const size_t depth)
+{
+    CombatSearchTask task;
+    task.state = state;
+    task.buildOrder = _buildOrder;
+    task.depth = depth;
+
+    _tasks.push_back(task);
+}
+
+// a search which never calls addTask has no tasks, so it is searched on one thread and needs no workers
+std::shared_ptr<CombatSearch> CombatSearch::createWorker(const size_t)
+{
+    BOSS_ASSERT(false, "This CombatSearch can't be split into tasks");
+
+    return std::shared_ptr<CombatSearch>();
+}
+
+void CombatSearch::mergeWorker(const CombatSearch &)
+{
+
+}
+
 // This functio generates the legal actions from a GameState based on the input search parameters
 void CombatSearch::generateLegalActions(const GameState & state, ActionSet & legalActions, const CombatSearchParameters & params)
 {
@@ -102,8 +262,27 @@ const CombatSearchResults & CombatSearch::getResults() const
     return _results;
 }
 
+double CombatSearch::getBestEval() const
+{
+    BOSS_ASSERT(false, "Base CombatSearch getBestEval() should never be called");
+
+    return 0;
+}
+
+const BuildOrder & CombatSearch::getBestBuildOrder() const
+{
+    BOSS_ASSERT(false, "Base CombatSearch getBestBuildOrder() should never be called");
+
+    return _buildOrder;
+}
+
 bool CombatSearch::timeLimitReached()
 {
+    if (_stop && _stop->load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+
     return (_params.getSearchTimeLimit() && (_results.nodesExpanded % 100 == 0) && (_searchTimer.getElapsedTimeInMilliSec() > _params.getSearchTimeLimit()));
 }
 
@@ -7,12 +7,33 @@
 #include "CombatSearchParameters.h"
 #include "CombatSearchResults.h"
 
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+
 namespace BOSS
 {
 
 #define BOSS_COMBATSEARCH_TIMEOUT -1
 #define MAX_COMBAT_SEARCH_DEPTH 100
 
+// a subtree of a parallel combat search which is searched on its own by one thread
+// tasks are numbered in the order the search on one thread would visit them
+class CombatSearchTask
+{
+public:
+
+    GameState           state;
+    BuildOrder          buildOrder;     // actions leading from the initial state to this state
+    size_t              depth;
+
+    CombatSearchTask()
+        : depth(0)
+    {
+
+    }
+};
 
 class CombatSearch
 {
@@ -26,6 +47,20 @@ protected:
 
     BuildOrder                  _buildOrder;
 
+    size_t                      _splitDepth;        // states at this depth are left as tasks instead of searched, 0 if not splitting
+    std::vector<CombatSearchTask> _tasks;
+    std::atomic<bool> *         _stop;              // set when a thread of a parallel search times out, so the rest stop too
+
+    void                        searchParallel(const GameState & initialState);
+    void                        workerThread(std::atomic<size_t> & nextTask, std::mutex & mergeMutex, std::exception_ptr & error);
+    bool                        isSplitNode(const size_t depth) const;
+
+    // a search which can be split overrides these, see searchParallel
+    virtual void                startSplit();
+    virtual void                addTask(const GameState & state, const size_t depth);
+    virtual std::shared_ptr<CombatSearch> createWorker(const size_t task);
+    virtual void                mergeWorker(const CombatSearch & worker);
+
     virtual void                recurse(const GameState & s,size_t depth);
     virtual void                generateLegalActions(const GameState & state,ActionSet & legalActions,const CombatSearchParameters & params);
 
@@ -37,11 +72,17 @@ protected:
 
 public:
 
+    CombatSearch();
+
     virtual void                search();
     virtual void                printResults();
     virtual void                writeResultsFile(const std::string & prefix);
 
     virtual const CombatSearchResults & getResults() const;
+
+    // the best value the search found, in resources like printResults shows it, and the build order it came from
+    virtual double              getBestEval() const;
+    virtual const BuildOrder &  getBestBuildOrder() const;
 };
 
 }
\ No newline at end of file
@@ -10,6 +10,12 @@ CombatSearchExperiment::CombatSearchExperiment()
 }
 
 CombatSearchExperiment::CombatSearchExperiment(const std::string & name, const rapidjson::Value & val)
+    : CombatSearchExperiment(name, val, BOSSParameters::Instance())
+{
+
+}
+
+CombatSearchExperiment::CombatSearchExperiment(const std::string & name, const rapidjson::Value & val, const BOSSParameters & bossParams)
     : _race(Races::None)
     , _name(name)
 {
@@ -25,7 +31,7 @@ CombatSearchExperiment::CombatSearchExperiment(const std::string & name, const r
     _race = Races::GetRaceID(val["Race"].GetString());
 
     BOSS_ASSERT(val.HasMember("State") && val["State"].IsString(), "CombatSearchExperiment must have a 'State' string");
-    _params.setInitialState(BOSSParameters::Instance().GetState(val["State"].GetString()));
+    _params.setInitialState(bossParams.GetState(val["State"].GetString()));
 
     BOSS_ASSERT(val.HasMember("FrameTimeLimit") && val["FrameTimeLimit"].IsInt(), "CombatSearchExperiment must have a 'FrameTimeLimit' int");
     _params.setFrameTimeLimit(val["FrameTimeLimit"].GetInt());
@@ -75,10 +81,24 @@ CombatSearchExperiment::CombatSearchExperiment(const std::string & name, const r
         _params.setAlwaysMakeWorkers(val["AlwaysMakeWorkers"].GetBool());
     }
 
+    if (val.HasMember("NumThreads"))
+    {
+        BOSS_ASSERT(val["NumThreads"].IsInt() && (val["NumThreads"].GetInt() > 0), "NumThreads should be a positive int");
+
+        _params.setNumThreads(val["NumThreads"].GetInt());
+    }
+
+    if (val.HasMember("DominancePruning"))
+    {
+        BOSS_ASSERT(val["DominancePruning"].IsBool(), "DominancePruning should be a bool");
+
+        _params.setDominancePruning(val["DominancePruning"].GetBool());
+    }
+
     if (val.HasMember("OpeningBuildOrder"))
     {
         BOSS_ASSERT(val["OpeningBuildOrder"].IsString(), "OpeningBuildOrder should be a string");
-        _params.setOpeningBuildOrder(BOSSParameters::Instance().GetBuildOrder(val["OpeningBuildOrder"].GetString()));
+        _params.setOpeningBuildOrder(bossParams.GetBuildOrder(val["OpeningBuildOrder"].GetString()));
     }
 
     if (val.HasMember("BestResponseParams"))
@@ -90,16 +110,18 @@ CombatSearchExperiment::CombatSearchExperiment(const std::string & name, const r
         BOSS_ASSERT(brVal.HasMember("EnemyBuildOrder"), "bestResponseParams must have 'enemyBuildOrder' string");
 
         BOSS_ASSERT(brVal.HasMember("EnemyState") && brVal["EnemyState"].IsString(), "bestResponseParams must have a 'EnemyState' string");
-        _params.setEnemyInitialState(BOSSParameters::Instance().GetState(brVal["EnemyState"].GetString()));
+        _params.setEnemyInitialState(bossParams.GetState(brVal["EnemyState"].GetString()));
 
         BOSS_ASSERT(brVal.HasMember("EnemyBuildOrder") && brVal["EnemyBuildOrder"].IsString(), "BestResponseParams must have a 'EnemyBuildOrder' string");
-        _params.setEnemyBuildOrder(BOSSParameters::Instance().GetBuildOrder(brVal["EnemyBuildOrder"].GetString()));
+        _params.setEnemyBuildOrder(bossParams.GetBuildOrder(brVal["EnemyBuildOrder"].GetString()));
     }
 }
 
 void CombatSearchExperiment::run()
 {
     static std::string stars = "************************************************";
+    _results.clear();
+
     for (size_t i(0); i < _searchTypes.size(); ++i)
     {
         std::shared_ptr<CombatSearch> combatSearch;
@@ -132,5 +154,17 @@ void CombatSearchExperiment::run()
         combatSearch->writeResultsFile(resultsFile);
         const CombatSearchResults & results = combatSearch->getResults();
         std::cout << "\nSearched " << results.nodesExpanded << " nodes in " << results.timeElapsed << "ms @ " << (1000.0*results.nodesExpanded/results.timeElapsed) << " nodes/sec\n\n";
+
+        CombatSearchExperimentResult result;
+        result.searchType = _searchTypes[i];
+        result.results = results;
+        result.bestEval = combatSearch->getBestEval();
+        result.bestBuildOrder = combatSearch->getBestBuildOrder();
+        _results.push_back(result);
     }
+}
+
+const std::vector<CombatSearchExperimentResult> & CombatSearchExperiment::getResults() const
+{
+    return _results;
 }
\ No newline at end of file
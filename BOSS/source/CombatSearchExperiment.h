@@ -9,6 +9,25 @@
 namespace BOSS
 {
 
+class BOSSParameters;
+
+// what one search of an experiment found
+class CombatSearchExperimentResult
+{
+public:
+
+    std::string                 searchType;
+    CombatSearchResults         results;
+    double                      bestEval;
+    BuildOrder                  bestBuildOrder;
+
+    CombatSearchExperimentResult()
+        : bestEval(0)
+    {
+
+    }
+};
+
 class CombatSearchExperiment
 {
     std::string                 _name;
@@ -19,11 +38,17 @@ class CombatSearchExperiment
     RaceID                      _enemyRace;
     BuildOrder                  _enemyBuildOrder;
 
+    std::vector<CombatSearchExperimentResult> _results;
+
 public:
 
     CombatSearchExperiment();
     CombatSearchExperiment(const std::string & name, const rapidjson::Value & experimentVal);
+    CombatSearchExperiment(const std::string & name, const rapidjson::Value & experimentVal, const BOSSParameters & bossParams);
 
     void run();
+
+    // one result for each search type, in the order they were run
+    const std::vector<CombatSearchExperimentResult> & getResults() const;
 };
 }
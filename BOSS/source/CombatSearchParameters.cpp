@@ -20,6 +20,8 @@ CombatSearchParameters::CombatSearchParameters()
     , _repetitionValues              (Constants::MAX_ACTIONS, 1)
     , _repetitionThresholds          (Constants::MAX_ACTIONS, 0)
     , _printNewBest                  (false)
+    , _numThreads                    (1)
+    , _useDominancePruning           (false)
 {
     
 }
@@ -124,6 +126,26 @@ FrameCountType CombatSearchParameters::getFrameTimeLimit() const
     return _frameTimeLimit;
 }
 
+void CombatSearchParameters::setNumThreads(const int numThreads)
+{
+    _numThreads = numThreads;
+}
+
+int CombatSearchParameters::getNumThreads() const
+{
+    return _numThreads;
+}
+
+void CombatSearchParameters::setDominancePruning(const bool flag)
+{
+    _useDominancePruning = flag;
+}
+
+bool CombatSearchParameters::getDominancePruning() const
+{
+    return _useDominancePruning;
+}
+
 
 
 void CombatSearchParameters::print()
@@ -137,6 +159,7 @@ void CombatSearchParameters::print()
     printf("%s", _useResourceLowerBoundHeuristic ?    "\tUSE      Resource Lower Bound\n" : "");
     printf("%s", _useAlwaysMakeWorkers ?              "\tUSE      Always Make Workers\n" : "");
     printf("%s", _useSupplyBounding ?                 "\tUSE      Supply Bounding\n" : "");
+    printf("%s", _useDominancePruning ?               "\tUSE      Dominance Pruning\n" : "");
     printf("\n");
 
     //for (int a = 0; a < ACTIONS.size(); ++a)
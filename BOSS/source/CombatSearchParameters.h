@@ -102,6 +102,25 @@ class CombatSearchParameters
     FrameCountType          _frameTimeLimit;
     bool                    _printNewBest;
 
+	//      Number of threads used by the search
+	//      If numThreads is greater than one, the integral and bucket searches split the search
+	//          tree into tasks which are searched by that many threads. When run to completion
+	//          they return the same results as the search on one thread.
+	int     _numThreads;
+
+	//      Flag which determines whether or not the bucket search prunes dominated states
+	//      A state is dominated if a state searched before it in the same frame bucket was at the
+	//          same or an earlier frame and had at least as many resources and units of every type.
+	//          Pruning these makes long searches much faster but may miss the best build order,
+	//          since a dominated state can still have better actions in progress. The states are
+	//          checked either way, and CombatSearchResults counts the dominated ones. With
+	//          several threads each task prunes with the states above the split and its own
+	//          states, so results are the same between runs with the same number of threads.
+	//
+	//      true:  dominated states are pruned
+	//      false: dominated states are searched
+	bool    _useDominancePruning;
+
 
 
 public:
@@ -138,6 +157,12 @@ public:
 
     void                setAlwaysMakeWorkers(const bool flag);
     const bool          getAlwaysMakeWorkers() const;
+
+    void                setNumThreads(const int numThreads);
+    int                 getNumThreads() const;
+
+    void                setDominancePruning(const bool flag);
+    bool                getDominancePruning() const;
 	
 	void print();
 };
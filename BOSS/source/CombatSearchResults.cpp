@@ -9,6 +9,8 @@ CombatSearchResults::CombatSearchResults()
     , upperBound(-1)
     , lowerBound(-1)
     , nodesExpanded(0)
+    , dominanceChecks(0)
+    , nodesDominated(0)
     , timeElapsed(0)
     , avgBranch(0)
     , minerals(0)
@@ -21,6 +21,8 @@ public:
     int                 lowerBound;		// lower bound of first node
 
     unsigned long long  nodesExpanded;	// number of nodes expanded in the search
+    unsigned long long  dominanceChecks;    // number of nodes checked against the dominance index
+    unsigned long long  nodesDominated;     // number of those found dominated, which are pruned if dominance pruning is on
 
     double              timeElapsed;	// time elapsed in milliseconds
     double              avgBranch;		// avg branching factor
@@ -59,4 +59,14 @@ void CombatSearch_BestResponse::writeResultsFile(const std::string & filename)
 
     plot2.writeRectanglePlot(filename + "_EnemyBuildOrder");
     plot2.writeArmyValuePlot(filename + "_EnemyArmyValue");
-}
\ No newline at end of file
+}
+
+double CombatSearch_BestResponse::getBestEval() const
+{
+    return _bestResponseData.getBestEval() / Constants::RESOURCE_SCALE;
+}
+
+const BuildOrder & CombatSearch_BestResponse::getBestBuildOrder() const
+{
+    return _bestResponseData.getBestBuildOrder();
+}
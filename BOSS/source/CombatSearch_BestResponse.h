@@ -29,6 +29,9 @@ public:
     virtual void printResults();
 
     virtual void writeResultsFile(const std::string & filename);
+
+    virtual double getBestEval() const;
+    virtual const BuildOrder & getBestBuildOrder() const;
 };
 
 }
\ No newline at end of file
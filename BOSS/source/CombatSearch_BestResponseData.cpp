@@ -66,7 +66,8 @@ double CombatSearch_BestResponseData::compareBuildOrder(const GameState & initia
             selfIndex = si;
         }
     
-        double selfVal = _selfArmyValues[selfIndex].second;
+        // the empty build order at the root of the search has no army values yet
+        double selfVal = _selfArmyValues.empty() ? 0 : _selfArmyValues[selfIndex].second;
         double diff = enemyVal - selfVal;
         maxDiff = std::max(maxDiff, diff);
     }
@@ -95,6 +96,11 @@ size_t CombatSearch_BestResponseData::getStateIndex(const GameState & state)
     return 0;
 }
 
+double CombatSearch_BestResponseData::getBestEval() const
+{
+    return _bestEval;
+}
+
 const BuildOrder & CombatSearch_BestResponseData::getBestBuildOrder() const
 {
     return _bestBuildOrder;
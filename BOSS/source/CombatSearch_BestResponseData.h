@@ -32,6 +32,7 @@ public:
 
     void update(const GameState & initialState, const GameState & currentState, const BuildOrder & buildOrder);
 
+    double getBestEval() const;
     const BuildOrder & getBestBuildOrder() const;
 
 };
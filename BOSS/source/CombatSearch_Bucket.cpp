@@ -9,13 +9,19 @@ CombatSearch_Bucket::CombatSearch_Bucket(const CombatSearchParameters p)
    
     BOSS_ASSERT(_params.getInitialState().getRace() != Races::None, "Combat search initial state is invalid");
 }
-void CombatSearch_Bucket::doSearch(const GameState & state, size_t depth)
+void CombatSearch_Bucket::recurse(const GameState & state, size_t depth)
 {
     if (timeLimitReached())
     {
         throw BOSS_COMBATSEARCH_TIMEOUT;
     }
 
+    if (isSplitNode(depth))
+    {
+        addTask(state, depth);
+        return;
+    }
+
     updateResults(state);
     _bucket.update(state, _buildOrder);
 
@@ -24,9 +30,15 @@ void CombatSearch_Bucket::doSearch(const GameState & state, size_t depth)
         return;
     }
 
-    if (_bucket.isDominated(state))
+    _results.dominanceChecks++;
+    if (isDominated(state))
     {
-        //return;
+        _results.nodesDominated++;
+
+        if (_params.getDominancePruning())
+        {
+            return;
+        }
     }
 
     ActionSet legalActions;
@@ -38,15 +50,64 @@ void CombatSearch_Bucket::doSearch(const GameState & state, size_t depth)
         child.doAction(legalActions[a]);
         _buildOrder.add(legalActions[a]);
         
-        doSearch(child,depth+1);
+        recurse(child,depth+1);
 
         _buildOrder.pop_back();
     }
 }
 
+// the threads of a parallel search share one index, unless they prune with it, which would make
+// the results depend on the order the threads get to the states
+bool CombatSearch_Bucket::isDominated(const GameState & state)
+{
+    return _sharedBuckets ? _sharedBuckets->isDominated(state) : _bucket.isDominated(state);
+}
+
+void CombatSearch_Bucket::startSplit()
+{
+    CombatSearch::startSplit();
+
+    _bucket = CombatSearch_BucketData(_params.getFrameTimeLimit(), _bucket.numBuckets());
+
+    if (!_params.getDominancePruning())
+    {
+        _sharedBuckets = std::shared_ptr<CombatSearch_SharedBucketData>(new CombatSearch_SharedBucketData(_params.getFrameTimeLimit(), _bucket.numBuckets()));
+    }
+}
+
+// the states this search visits after a task come after the task's states, see CombatSearch_Integral::addTask
+void CombatSearch_Bucket::addTask(const GameState & state, const size_t depth)
+{
+    CombatSearch::addTask(state, depth);
+
+    _bucket.setOrder(2 * _tasks.size());
+}
+
+// a task which prunes starts with the states above the split in its index, so it prunes the same states every time
+std::shared_ptr<CombatSearch> CombatSearch_Bucket::createWorker(const size_t task)
+{
+    std::shared_ptr<CombatSearch_Bucket> worker(new CombatSearch_Bucket(_params));
+    worker->_bucket.setOrder(2 * task + 1);
+    worker->_sharedBuckets = _sharedBuckets;
+
+    if (_params.getDominancePruning())
+    {
+        worker->_bucket.setDominanceIndex(_bucket.getDominanceIndex());
+    }
+
+    return worker;
+}
+
+void CombatSearch_Bucket::mergeWorker(const CombatSearch & worker)
+{
+    _bucket.merge(static_cast<const CombatSearch_Bucket &>(worker)._bucket);
+}
+
 void CombatSearch_Bucket::printResults()
 {
     _bucket.print();
+
+    printf("\n%llu of %llu states checked were dominated%s\n", _results.nodesDominated, _results.dominanceChecks, _params.getDominancePruning() ? " and pruned" : "");
 }
 
 #include "BuildOrderPlot.h"
@@ -58,4 +119,14 @@ void CombatSearch_Bucket::writeResultsFile(const std::string & filename)
     BuildOrderPlot plot(_params.getInitialState(), _bucket.getBucket(_bucket.numBuckets()-1).buildOrder);
     plot.writeArmyValuePlot(filename + "_FinalBucketArmyPlot");
     plot.writeRectanglePlot(filename + "_FinalBucketBuildOrder");
-}
\ No newline at end of file
+}
+
+double CombatSearch_Bucket::getBestEval() const
+{
+    return _bucket.getBestBucket().eval / Constants::RESOURCE_SCALE;
+}
+
+const BuildOrder & CombatSearch_Bucket::getBestBuildOrder() const
+{
+    return _bucket.getBestBucket().buildOrder;
+}
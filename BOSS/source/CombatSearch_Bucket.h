@@ -15,8 +15,15 @@ namespace BOSS
 class CombatSearch_Bucket : public CombatSearch
 {
     CombatSearch_BucketData     _bucket;
+    std::shared_ptr<CombatSearch_SharedBucketData> _sharedBuckets;    // the dominance index of all threads of a parallel search which doesn't prune
 
-	virtual void                doSearch(const GameState & s, size_t depth);
+	virtual void                recurse(const GameState & s, size_t depth);
+    bool                        isDominated(const GameState & state);
+
+    virtual void                startSplit();
+    virtual void                addTask(const GameState & state, const size_t depth);
+    virtual std::shared_ptr<CombatSearch> createWorker(const size_t task);
+    virtual void                mergeWorker(const CombatSearch & worker);
 
 public:
 	
@@ -24,6 +31,9 @@ public:
 
     virtual void printResults();
     virtual void writeResultsFile(const std::string & filename);
+
+    virtual double getBestEval() const;
+    virtual const BuildOrder & getBestBuildOrder() const;
 };
 
 }
\ No newline at end of file
@@ -9,9 +9,16 @@ using namespace BOSS;
 // The number of buckets and the frame limit determine the size of the buckets
 
 
+namespace
+{
+    const size_t NumSharedBucketLocks = 16;
+}
+
 CombatSearch_BucketData::CombatSearch_BucketData(const FrameCountType frameLimit, const size_t numBuckets)
         : _buckets(numBuckets, BucketData())
         , _frameLimit(frameLimit)
+        , _order(0)
+        , _dominance(frameLimit, numBuckets)
 {
     
 }
@@ -48,28 +55,88 @@ void CombatSearch_BucketData::update(const GameState & state, const BuildOrder &
         // update every bucket for which this is a new record
         for (size_t b=bucketIndex; b < _buckets.size(); ++b)
         {
-            if (_buckets[b].eval >= eval)
+            if (!updateBucket(b, eval, state, buildOrder))
             {
                 break;
             }
+        }
+    }
+}
+
+// returns false if the bucket already has a state with at least this value
+bool CombatSearch_BucketData::updateBucket(const size_t index, const double eval, const GameState & state, const BuildOrder & buildOrder)
+{
+    BucketData & bucket = _buckets[index];
+    if (bucket.eval >= eval)
+    {
+        return false;
+    }
+
+    bucket.eval = eval;
+    bucket.buildOrder = buildOrder;
+    bucket.state = state;
+    bucket.order = _order;
+    return true;
+}
 
-            _buckets[b].eval = eval;
-            _buckets[b].buildOrder = buildOrder;
-            _buckets[b].state = state;
+void CombatSearch_BucketData::setOrder(const size_t order)
+{
+    _order = order;
+}
+
+// a bucket only takes a state with a higher value, so when two are equal the one found first is kept
+void CombatSearch_BucketData::merge(const CombatSearch_BucketData & other)
+{
+    BOSS_ASSERT(other._buckets.size() == _buckets.size(), "Can't merge bucket data with different sizes: (%d %d)", (int)other._buckets.size(), (int)_buckets.size());
+
+    for (size_t b(0); b < _buckets.size(); ++b)
+    {
+        const BucketData & otherBucket = other._buckets[b];
+
+        if ((otherBucket.eval > _buckets[b].eval) || ((otherBucket.eval == _buckets[b].eval) && (otherBucket.order < _buckets[b].order)))
+        {
+            _buckets[b] = otherBucket;
         }
     }
 }
 
 bool CombatSearch_BucketData::isDominated(const GameState & state)
 {
-    return Eval::StateDominates(getBucketData(state).state, state);
+    const DominanceQuery query(state);
+    const size_t bucketIndex = _dominance.getBucketIndex(state);
+
+    if (_dominance.isDominated(query, bucketIndex))
+    {
+        return true;
+    }
+
+    _dominance.store(query, bucketIndex);
+    return false;
+}
+
+const CombatSearch_DominanceIndex & CombatSearch_BucketData::getDominanceIndex() const
+{
+    return _dominance;
+}
+
+void CombatSearch_BucketData::setDominanceIndex(const CombatSearch_DominanceIndex & index)
+{
+    _dominance = index;
 }
 
-BucketData & CombatSearch_BucketData::getBucketData(const GameState & state)
+// the earliest bucket with the highest eval
+const BucketData & CombatSearch_BucketData::getBestBucket() const
 {
-    BOSS_ASSERT(getBucketIndex(state) < _buckets.size(), "State goes over bucket limit");
+    size_t best = 0;
+    for (size_t b(1); b < _buckets.size(); ++b)
+    {
+        if (_buckets[b].eval > _buckets[best].eval)
+        {
+            best = b;
+        }
+    }
 
-    return _buckets[getBucketIndex(state)];
+    return _buckets[best];
 }
 
 void CombatSearch_BucketData::print() const
@@ -119,4 +186,28 @@ std::string CombatSearch_BucketData::getBucketResultsString()
     }
 
     return ss.str();
+}
+
+CombatSearch_SharedBucketData::CombatSearch_SharedBucketData(const FrameCountType frameLimit, const size_t numBuckets)
+    : _dominance(frameLimit, numBuckets)
+    , _locks(NumSharedBucketLocks)
+{
+
+}
+
+// the same as CombatSearch_BucketData::isDominated, holding the lock of the state's bucket
+bool CombatSearch_SharedBucketData::isDominated(const GameState & state)
+{
+    const DominanceQuery query(state);
+    const size_t bucketIndex = _dominance.getBucketIndex(state);
+
+    std::lock_guard<std::mutex> lock(_locks[bucketIndex % _locks.size()]);
+
+    if (_dominance.isDominated(query, bucketIndex))
+    {
+        return true;
+    }
+
+    _dominance.store(query, bucketIndex);
+    return false;
 }
\ No newline at end of file
@@ -4,6 +4,10 @@
 #include "Common.h"
 #include "GameState.h"
 #include "Eval.h"
+#include "CombatSearch_DominanceIndex.h"
+
+#include <limits>
+#include <mutex>
 
 namespace BOSS
 {
@@ -14,9 +18,11 @@ public:
     double                      eval;
     BuildOrder                  buildOrder;
     GameState                   state;
+    size_t                      order;      // where the state comes from in the search on one thread, see CombatSearch::searchParallel
 
     BucketData()
         : eval(0)
+        , order(std::numeric_limits<size_t>::max())
     {
     }
 };
@@ -25,23 +31,45 @@ class CombatSearch_BucketData
 {
     std::vector<BucketData>     _buckets;
     FrameCountType              _frameLimit;
-
-    BucketData & getBucketData(const GameState & state);
+    size_t                      _order;
+    CombatSearch_DominanceIndex _dominance;
 
 public:
 
     CombatSearch_BucketData(const FrameCountType frameLimit, const size_t numBuckets);
 
     const BucketData & getBucket(const size_t index) const;
+    const BucketData & getBestBucket() const;
     const size_t numBuckets() const;
     const size_t getBucketIndex(const GameState & state) const;
         
     void update(const GameState & state, const BuildOrder & buildOrder);
+    bool updateBucket(const size_t index, const double eval, const GameState & state, const BuildOrder & buildOrder);
+    void setOrder(const size_t order);
+    void merge(const CombatSearch_BucketData & other);
 
+    // returns true if a state checked before dominates this one, and stores it in the index if not
     bool isDominated(const GameState & state);
+    const CombatSearch_DominanceIndex & getDominanceIndex() const;
+    void setDominanceIndex(const CombatSearch_DominanceIndex & index);
 
     void print() const;
     std::string getBucketResultsString();
 };
 
+// the dominance index of a parallel search, shared by all its threads
+// each frame bucket is guarded by one of a fixed number of locks, so threads only wait for each other
+// when they check states in buckets with the same lock
+class CombatSearch_SharedBucketData
+{
+    CombatSearch_DominanceIndex _dominance;
+    std::vector<std::mutex>     _locks;
+
+public:
+
+    CombatSearch_SharedBucketData(const FrameCountType frameLimit, const size_t numBuckets);
+
+    bool isDominated(const GameState & state);
+};
+
 }
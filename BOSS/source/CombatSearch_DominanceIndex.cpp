@@ -0,0 +1,251 @@
+#include "CombatSearch_DominanceIndex.h"
+
+using namespace BOSS;
+
+namespace
+{
+    // a bucket stops taking new states when it holds this many, which bounds the index at a few megabytes
+    const size_t MaxStatesPerBucket = 1024;
+}
+
+DominanceGroup::DominanceGroup(const ActionMaskType s)
+    : signature(s)
+    , numTypes(0)
+{
+    std::fill(position, position + Constants::MAX_ACTIONS, 0);
+
+    ActionMask types(signature);
+    while (!types.isEmpty())
+    {
+        position[types.popFirst()] = (ActionID)numTypes++;
+    }
+}
+
+size_t DominanceGroup::size() const
+{
+    return frames.size();
+}
+
+void DominanceGroup::add(const FrameCountType frame, const ResourceCountType m, const ResourceCountType g, const UnitCountType * total, const UnitCountType * completed)
+{
+    frames.push_back(frame);
+    minerals.push_back(m);
+    gas.push_back(g);
+
+    ActionMask types(signature);
+    while (!types.isEmpty())
+    {
+        const ActionID a = types.popFirst();
+        counts.push_back(total[a]);
+        counts.push_back(completed[a]);
+    }
+}
+
+// moves the last state into the removed one's place
+void DominanceGroup::remove(const size_t index)
+{
+    const size_t last = size() - 1;
+
+    frames[index]   = frames[last];
+    minerals[index] = minerals[last];
+    gas[index]      = gas[last];
+    std::copy(counts.begin() + 2 * numTypes * last, counts.end(), counts.begin() + 2 * numTypes * index);
+
+    frames.pop_back();
+    minerals.pop_back();
+    gas.pop_back();
+    counts.resize(2 * numTypes * last);
+}
+
+DominanceQuery::DominanceQuery(const GameState & state)
+    : signature(0)
+    , frame(state.getCurrentFrame())
+    , minerals(state.getMinerals())
+    , gas(state.getGas())
+{
+    std::fill(total, total + Constants::MAX_ACTIONS, 0);
+    std::fill(completed, completed + Constants::MAX_ACTIONS, 0);
+
+    const RaceID race = state.getRace();
+    const UnitData & units = state.getUnitData();
+
+    for (ActionID a(0); a < ActionTypes::GetAllActionTypes(race).size(); ++a)
+    {
+        const ActionType & actionType = ActionTypes::GetActionType(race, a);
+
+        total[a]     = units.getNumTotal(actionType);
+        completed[a] = units.getNumCompleted(actionType);
+
+        if (total[a] > 0)
+        {
+            signature |= ActionMask::Bit(a);
+        }
+    }
+}
+
+CombatSearch_DominanceIndex::CombatSearch_DominanceIndex(const FrameCountType frameLimit, const size_t numBuckets)
+    : _groups(numBuckets)
+    , _groupIndex(numBuckets)
+    , _bucketSizes(numBuckets, 0)
+    , _frameLimit(frameLimit)
+    , _size(0)
+{
+
+}
+
+size_t CombatSearch_DominanceIndex::numBuckets() const
+{
+    return _groups.size();
+}
+
+// the same buckets as CombatSearch_BucketData, a state at or past the frame limit gets numBuckets()
+size_t CombatSearch_DominanceIndex::getBucketIndex(const GameState & state) const
+{
+    if (state.getCurrentFrame() >= _frameLimit)
+    {
+        return numBuckets();
+    }
+
+    return (size_t)(((double)state.getCurrentFrame() / (double)_frameLimit) * numBuckets());
+}
+
+size_t CombatSearch_DominanceIndex::size() const
+{
+    return _size;
+}
+
+// the stored state's group has every type the query has, so only the query's types need comparing
+bool CombatSearch_DominanceIndex::dominates(const DominanceGroup & group, const size_t index, const DominanceQuery & query) const
+{
+    if ((group.frames[index] > query.frame) || (group.minerals[index] < query.minerals) || (group.gas[index] < query.gas))
+    {
+        return false;
+    }
+
+    const UnitCountType * counts = &group.counts[2 * group.numTypes * index];
+
+    ActionMask types(query.signature);
+    while (!types.isEmpty())
+    {
+        const ActionID a = types.popFirst();
+        const size_t p = group.position[a];
+
+        if ((counts[2 * p] < query.total[a]) || (counts[2 * p + 1] < query.completed[a]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// the query has every type the stored state's group has, so only the group's types need comparing
+bool CombatSearch_DominanceIndex::isDominatedBy(const DominanceQuery & query, const DominanceGroup & group, const size_t index) const
+{
+    if ((query.frame > group.frames[index]) || (query.minerals < group.minerals[index]) || (query.gas < group.gas[index]))
+    {
+        return false;
+    }
+
+    const UnitCountType * counts = &group.counts[2 * group.numTypes * index];
+
+    ActionMask types(group.signature);
+    while (!types.isEmpty())
+    {
+        const ActionID a = types.popFirst();
+        const size_t p = group.position[a];
+
+        if ((query.total[a] < counts[2 * p]) || (query.completed[a] < counts[2 * p + 1]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CombatSearch_DominanceIndex::isDominated(const GameState & state) const
+{
+    return isDominated(DominanceQuery(state), getBucketIndex(state));
+}
+
+bool CombatSearch_DominanceIndex::isDominated(const DominanceQuery & query, const size_t bucketIndex) const
+{
+    if (bucketIndex >= numBuckets())
+    {
+        return false;
+    }
+
+    const std::vector<DominanceGroup> & groups = _groups[bucketIndex];
+    for (size_t g(0); g < groups.size(); ++g)
+    {
+        if ((groups[g].signature & query.signature) != query.signature)
+        {
+            continue;
+        }
+
+        for (size_t i(0); i < groups[g].size(); ++i)
+        {
+            if (dominates(groups[g], i, query))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void CombatSearch_DominanceIndex::store(const GameState & state)
+{
+    store(DominanceQuery(state), getBucketIndex(state));
+}
+
+void CombatSearch_DominanceIndex::store(const DominanceQuery & query, const size_t bucketIndex)
+{
+    if (bucketIndex >= numBuckets())
+    {
+        return;
+    }
+
+    // remove the states the new one dominates, which can only be in groups with a subset of its types
+    std::vector<DominanceGroup> & groups = _groups[bucketIndex];
+    for (size_t g(0); g < groups.size(); ++g)
+    {
+        if ((groups[g].signature & query.signature) != groups[g].signature)
+        {
+            continue;
+        }
+
+        for (size_t i(0); i < groups[g].size(); )
+        {
+            if (isDominatedBy(query, groups[g], i))
+            {
+                groups[g].remove(i);
+                _bucketSizes[bucketIndex]--;
+                _size--;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    if (_bucketSizes[bucketIndex] >= MaxStatesPerBucket)
+    {
+        return;
+    }
+
+    std::unordered_map<ActionMaskType, size_t> & groupIndex = _groupIndex[bucketIndex];
+    auto it = groupIndex.find(query.signature);
+    if (it == groupIndex.end())
+    {
+        it = groupIndex.insert(std::make_pair(query.signature, groups.size())).first;
+        groups.push_back(DominanceGroup(query.signature));
+    }
+
+    groups[it->second].add(query.frame, query.minerals, query.gas, query.total, query.completed);
+    _bucketSizes[bucketIndex]++;
+    _size++;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "ActionMask.h"
+
+#include <unordered_map>
+
+namespace BOSS
+{
+
+// the states of one frame bucket which have the same unit types, stored as columns
+// the counts of each state are stored for the signature's unit types only, in the order of the mask bits
+class DominanceGroup
+{
+public:
+
+    ActionMaskType                  signature;      // the unit types these states have at least one of
+    ActionID                        position[Constants::MAX_ACTIONS];   // where each signature type's counts are in a state's counts
+    size_t                          numTypes;
+
+    std::vector<FrameCountType>     frames;
+    std::vector<ResourceCountType>  minerals;
+    std::vector<ResourceCountType>  gas;
+    std::vector<UnitCountType>      counts;         // total then completed for each signature type, numTypes pairs per state
+
+    DominanceGroup(const ActionMaskType s);
+
+    size_t size() const;
+    void add(const FrameCountType frame, const ResourceCountType m, const ResourceCountType g, const UnitCountType * total, const UnitCountType * completed);
+    void remove(const size_t index);
+};
+
+// a state with its counts laid out by action id, the form a state is compared in
+class DominanceQuery
+{
+public:
+
+    ActionMaskType                  signature;
+    FrameCountType                  frame;
+    ResourceCountType               minerals;
+    ResourceCountType               gas;
+    UnitCountType                   total[Constants::MAX_ACTIONS];
+    UnitCountType                   completed[Constants::MAX_ACTIONS];
+
+    DominanceQuery(const GameState & state);
+};
+
+// the states of a combat search which no other stored state dominates, split into frame buckets
+// a state dominates another in the same bucket if it is at the same or an earlier frame and has at least as many
+// minerals, gas and total and completed units of every type, as in Eval::StateDominates
+// a state can only be dominated by a state with every unit type it has, so each bucket keeps its states in groups
+// keyed by the set of unit types they have, and a query only looks at the groups whose set contains its own.
+// storing a state removes the states it dominates, so each bucket holds the skyline of the states stored in it
+class CombatSearch_DominanceIndex
+{
+    std::vector< std::vector<DominanceGroup> >                  _groups;        // the groups of each frame bucket
+    std::vector< std::unordered_map<ActionMaskType, size_t> >   _groupIndex;    // where each signature's group is in its bucket
+    std::vector<size_t>                                         _bucketSizes;
+    FrameCountType                                              _frameLimit;
+    size_t                                                      _size;
+
+    bool                            dominates(const DominanceGroup & group, const size_t index, const DominanceQuery & query) const;
+    bool                            isDominatedBy(const DominanceQuery & query, const DominanceGroup & group, const size_t index) const;
+
+public:
+
+    CombatSearch_DominanceIndex(const FrameCountType frameLimit = 0, const size_t numBuckets = 0);
+
+    size_t                          numBuckets() const;
+    size_t                          getBucketIndex(const GameState & state) const;
+    size_t                          size() const;
+
+    // returns true if a stored state dominates this one, states past the frame limit are never dominated
+    bool                            isDominated(const GameState & state) const;
+    bool                            isDominated(const DominanceQuery & query, const size_t bucketIndex) const;
+
+    // stores the state and removes the states it dominates, once a bucket is full new states are not stored
+    void                            store(const GameState & state);
+    void                            store(const DominanceQuery & query, const size_t bucketIndex);
+};
+
+}
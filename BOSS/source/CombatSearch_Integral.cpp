@@ -9,13 +9,19 @@ CombatSearch_Integral::CombatSearch_Integral(const CombatSearchParameters p)
     BOSS_ASSERT(_params.getInitialState().getRace() != Races::None, "Combat search initial state is invalid");
 }
 
-void CombatSearch_Integral::doSearch(const GameState & state, size_t depth)
+void CombatSearch_Integral::recurse(const GameState & state, size_t depth)
 {
     if (timeLimitReached())
     {
         throw BOSS_COMBATSEARCH_TIMEOUT;
     }
 
+    if (isSplitNode(depth))
+    {
+        addTask(state, depth);
+        return;
+    }
+
     updateResults(state);
 
     if (isTerminalNode(state, depth))
@@ -35,13 +41,47 @@ void CombatSearch_Integral::doSearch(const GameState & state, size_t depth)
         _buildOrder.add(legalActions[index]);
         _integral.update(state, _buildOrder);
         
-        doSearch(child,depth+1);
+        recurse(child,depth+1);
 
         _buildOrder.pop_back();
         _integral.pop();
     }
 }
 
+void CombatSearch_Integral::startSplit()
+{
+    CombatSearch::startSplit();
+
+    _integral = CombatSearch_IntegralData();
+    _integral.setPrintNewBest(false);
+    _taskIntegrals.clear();
+}
+
+// the updates of task t are ordered 2t+1, and the updates this search makes between tasks t-1 and t are ordered 2t
+void CombatSearch_Integral::addTask(const GameState & state, const size_t depth)
+{
+    CombatSearch::addTask(state, depth);
+
+    _taskIntegrals.push_back(_integral);
+    _taskIntegrals.back().clearBest();
+    _taskIntegrals.back().setOrder(2 * _tasks.size() - 1);
+
+    _integral.setOrder(2 * _tasks.size());
+}
+
+std::shared_ptr<CombatSearch> CombatSearch_Integral::createWorker(const size_t task)
+{
+    std::shared_ptr<CombatSearch_Integral> worker(new CombatSearch_Integral(_params));
+    worker->_integral = _taskIntegrals[task];
+
+    return worker;
+}
+
+void CombatSearch_Integral::mergeWorker(const CombatSearch & worker)
+{
+    _integral.merge(static_cast<const CombatSearch_Integral &>(worker)._integral);
+}
+
 void CombatSearch_Integral::printResults()
 {
     _integral.print();
@@ -55,4 +95,14 @@ void CombatSearch_Integral::writeResultsFile(const std::string & filename)
     plot.writeResourcePlot(filename + "_Resources");
     plot.writeRectanglePlot(filename + "_BuildOrder");
     plot.writeArmyValuePlot(filename + "_ArmyValue");
-}
\ No newline at end of file
+}
+
+double CombatSearch_Integral::getBestEval() const
+{
+    return _integral.getBestValue() / Constants::RESOURCE_SCALE;
+}
+
+const BuildOrder & CombatSearch_Integral::getBestBuildOrder() const
+{
+    return _integral.getBestBuildOrder();
+}
@@ -15,8 +15,14 @@ namespace BOSS
 class CombatSearch_Integral : public CombatSearch
 {
     CombatSearch_IntegralData   _integral;
+    std::vector<CombatSearch_IntegralData> _taskIntegrals;     // the integral stack each task starts from
 
-	virtual void                doSearch(const GameState & s, size_t depth);
+	virtual void                recurse(const GameState & s, size_t depth);
+
+    virtual void                startSplit();
+    virtual void                addTask(const GameState & state, const size_t depth);
+    virtual std::shared_ptr<CombatSearch> createWorker(const size_t task);
+    virtual void                mergeWorker(const CombatSearch & worker);
 
 public:
 	
@@ -24,6 +30,9 @@ public:
 	
     virtual void printResults();
     virtual void writeResultsFile(const std::string & filename);
+
+    virtual double getBestEval() const;
+    virtual const BuildOrder & getBestBuildOrder() const;
 };
 
 }
\ No newline at end of file
@@ -1,9 +1,14 @@
 #include "CombatSearch_IntegralData.h"
 
+#include <limits>
+
 using namespace BOSS;
 
 CombatSearch_IntegralData::CombatSearch_IntegralData()
     : _bestIntegralValue(0)
+    , _order(0)
+    , _bestOrder(std::numeric_limits<size_t>::max())
+    , _printNewBest(true)
 {
     _integralStack.push_back(IntegralData(0,0,0));
 }
@@ -16,18 +21,61 @@ void CombatSearch_IntegralData::update(const GameState & state, const BuildOrder
     IntegralData entry(value, _integralStack.back().integral + valueToAdd, state.getCurrentFrame());
     _integralStack.push_back(entry);
 
-    // we have found a new best if:
-    // 1. the new army integral is higher than the previous best
-    // 2. the new army integral is the same as the old best but the build order is 'better'
-    if (    (_integralStack.back().integral >  _bestIntegralValue) 
-        || ((_integralStack.back().integral == _bestIntegralValue) && Eval::BuildOrderBetter(buildOrder, _bestIntegralBuildOrder)))
+    if (isBetter(_integralStack.back().integral, buildOrder))
     {
         _bestIntegralValue = _integralStack.back().integral;
         _bestIntegralStack = _integralStack;
         _bestIntegralBuildOrder = buildOrder;
+        _bestOrder = _order;
 
         // print the newly found best to console
-        printIntegralData(_integralStack.size()-1);
+        if (_printNewBest)
+        {
+            printIntegralData(_integralStack.size()-1);
+        }
+    }
+}
+
+// we have found a new best if:
+// 1. the new army integral is higher than the previous best
+// 2. the new army integral is the same as the old best but the build order is 'better'
+bool CombatSearch_IntegralData::isBetter(const double integral, const BuildOrder & buildOrder) const
+{
+    return (integral > _bestIntegralValue) || ((integral == _bestIntegralValue) && Eval::BuildOrderBetter(buildOrder, _bestIntegralBuildOrder));
+}
+
+void CombatSearch_IntegralData::setOrder(const size_t order)
+{
+    _order = order;
+}
+
+void CombatSearch_IntegralData::setPrintNewBest(const bool print)
+{
+    _printNewBest = print;
+}
+
+// keeps the integral stack, so a search can carry on from the same state with no best found yet
+void CombatSearch_IntegralData::clearBest()
+{
+    _bestIntegralStack.clear();
+    _bestIntegralValue = 0;
+    _bestIntegralBuildOrder = BuildOrder();
+    _bestOrder = std::numeric_limits<size_t>::max();
+}
+
+// takes the other best if it is better, or if neither is better and the other one would have been found first
+void CombatSearch_IntegralData::merge(const CombatSearch_IntegralData & other)
+{
+    const bool otherFirst = other._bestOrder < _bestOrder;
+    const bool otherWorse = (other._bestIntegralValue < _bestIntegralValue) 
+                         || ((other._bestIntegralValue == _bestIntegralValue) && Eval::BuildOrderBetter(_bestIntegralBuildOrder, other._bestIntegralBuildOrder));
+
+    if (isBetter(other._bestIntegralValue, other._bestIntegralBuildOrder) || (otherFirst && !otherWorse))
+    {
+        _bestIntegralValue = other._bestIntegralValue;
+        _bestIntegralStack = other._bestIntegralStack;
+        _bestIntegralBuildOrder = other._bestIntegralBuildOrder;
+        _bestOrder = other._bestOrder;
     }
 }
 
@@ -53,6 +101,11 @@ void CombatSearch_IntegralData::print() const
     }
 }
 
+double CombatSearch_IntegralData::getBestValue() const
+{
+    return _bestIntegralValue;
+}
+
 const BuildOrder & CombatSearch_IntegralData::getBestBuildOrder() const
 {
     return _bestIntegralBuildOrder;
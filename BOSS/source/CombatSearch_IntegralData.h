@@ -40,6 +40,12 @@ class CombatSearch_IntegralData
     double                          _bestIntegralValue;
     BuildOrder                      _bestIntegralBuildOrder;
 
+    size_t                          _order;             // where the updates come from in the search on one thread, see CombatSearch::searchParallel
+    size_t                          _bestOrder;
+    bool                            _printNewBest;
+
+    bool isBetter(const double integral, const BuildOrder & buildOrder) const;
+
 public:
 
     CombatSearch_IntegralData();
@@ -47,9 +53,15 @@ public:
     void update(const GameState & state, const BuildOrder & buildOrder);
     void pop();
 
+    void setOrder(const size_t order);
+    void setPrintNewBest(const bool print);
+    void clearBest();
+    void merge(const CombatSearch_IntegralData & other);
+
     void printIntegralData(const size_t index) const;
     void print() const;
 
+    double getBestValue() const;
     const BuildOrder & getBestBuildOrder() const;
 };
 
@@ -16,8 +16,6 @@ namespace BOSS
 
         const size_t BUILDING_ERROR         = -2;        // building error return code
 
-        const size_t MAX_HATCHERIES         = 16;      // maximum number of hatcheries allowed
-
         const size_t ZERG_LARVA_TIMER       = 336;     // number of frames between zerg larva spawn
 
         const size_t BUILDING_PLACEMENT     = 24 * 5;  // number of frames to use for building placement
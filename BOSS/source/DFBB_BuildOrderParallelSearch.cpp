@@ -0,0 +1,343 @@
+#include "DFBB_BuildOrderParallelSearch.h"
+
+using namespace BOSS;
+
+namespace
+{
+    // how many tasks to split the search into per thread, more tasks balance better but
+    // states above the split depth are not in the transposition table
+    const size_t TasksPerThread     = 32;
+    const size_t MaxSplitDepth      = 4;
+    const size_t NumTableLocks      = 1024;
+    const size_t TimeCheckInterval  = 16;
+}
+
+DFBB_ParallelSearchData::DFBB_ParallelSearchData()
+    : _upperBound(0)
+    , _stop(false)
+    , _resultsTask(0)
+    , _tableLocks(NumTableLocks)
+    , _searchTimeLimit(0)
+{
+
+}
+
+void DFBB_ParallelSearchData::init(const int upperBound, const size_t transpositionTableSize)
+{
+    _upperBound = upperBound;
+
+    _results = DFBB_BuildOrderSearchResults();
+    _results.upperBound = upperBound;
+    _resultsTask = std::numeric_limits<size_t>::max();
+
+    if (transpositionTableSize > 0)
+    {
+        _transpositionTable.init(transpositionTableSize);
+    }
+}
+
+void DFBB_ParallelSearchData::start(const double timeLimit)
+{
+    _stop = false;
+    _searchTimeLimit = timeLimit;
+    _searchStart = std::chrono::steady_clock::now();
+}
+
+void DFBB_ParallelSearchData::stop()
+{
+    _stop = true;
+}
+
+int DFBB_ParallelSearchData::getUpperBound() const
+{
+    return _upperBound.load(std::memory_order_relaxed);
+}
+
+// the stop flag is checked every node so all threads stop as soon as one of them times out
+bool DFBB_ParallelSearchData::isTimeOut(const unsigned long long nodesExpanded)
+{
+    if (_stop.load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+
+    if ((_searchTimeLimit > 0) && (nodesExpanded % TimeCheckInterval == 0))
+    {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - _searchStart;
+
+        if (elapsed.count() > _searchTimeLimit)
+        {
+            _stop = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DFBB_ParallelSearchData::checkTranspositionTable(const GameState & state, const size_t depth, const size_t task)
+{
+    const HashValues hash = state.getHash();
+
+    std::lock_guard<std::mutex> lock(_tableLocks[_transpositionTable.getBucketIndex(hash) % _tableLocks.size()]);
+
+    if (_transpositionTable.isDominated(state, hash, task))
+    {
+        return true;
+    }
+
+    _transpositionTable.store(state, hash, depth, task);
+    return false;
+}
+
+// the sequential search keeps the first solution it finds with the best finish time, which is the one
+// from the lowest task, so equal finish times from an earlier task also replace the current solution
+void DFBB_ParallelSearchData::updateResults(const GameState & state, const BuildOrder & buildOrder, const size_t task)
+{
+    std::lock_guard<std::mutex> lock(_resultsMutex);
+
+    FrameCountType finishTime = state.getLastActionFinishTime();
+
+    if ((finishTime < _results.upperBound) || (_results.solutionFound && (finishTime == _results.upperBound) && (task < _resultsTask)))
+    {
+        if (!_results.solutionFound)
+        {
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - _searchStart;
+            _results.firstSolutionTime = elapsed.count();
+        }
+
+        _results.upperBound = finishTime;
+        _results.solutionFound = true;
+        _results.finalState = state;
+        _results.buildOrder = buildOrder;
+        _resultsTask = task;
+
+        _upperBound = finishTime;
+
+        _results.printResults(true);
+    }
+}
+
+DFBB_BuildOrderSearchResults DFBB_ParallelSearchData::getResults()
+{
+    std::lock_guard<std::mutex> lock(_resultsMutex);
+
+    return _results;
+}
+
+DFBB_BuildOrderParallelSearch::DFBB_BuildOrderParallelSearch(const DFBB_BuildOrderSearchParameters & p)
+    : _params(p)
+    , _workerTask(std::max(p.numThreads, 1), -1)
+    , _queues(std::max(p.numThreads, 1))
+    , _queueLocks(std::max(p.numThreads, 1))
+    , _firstSearch(true)
+    , _splitNodes(0)
+{
+    for (size_t w(0); w < _workerTask.size(); ++w)
+    {
+        _workers.push_back(DFBB_BuildOrderStackSearch(_params));
+        _workers.back().setSharedData(&_shared);
+    }
+}
+
+void DFBB_BuildOrderParallelSearch::setTimeLimit(double ms)
+{
+    _params.searchTimeLimit = ms;
+}
+
+// splits the search tree breadth first until there are enough tasks, keeping the tasks in the
+// order the sequential search would visit them
+void DFBB_BuildOrderParallelSearch::generateTasks()
+{
+    DFBB_BuildOrderStackSearch splitter(_params);
+    splitter.setSharedData(&_shared);
+
+    _tasks = std::vector<DFBB_SearchTask>(1);
+    _tasks[0].state = _params.initialState;
+
+    for (size_t depth(0); (depth < MaxSplitDepth) && (_tasks.size() < TasksPerThread * _workers.size()); ++depth)
+    {
+        std::vector<DFBB_SearchTask> children;
+
+        for (size_t t(0); t < _tasks.size(); ++t)
+        {
+            // solutions are leaves of the search tree so they can't be split any further
+            if ((_tasks[t].depth > 0) && _params.goal.isAchievedBy(_tasks[t].state))
+            {
+                children.push_back(_tasks[t]);
+            }
+            else
+            {
+                splitter.expandTask(_tasks[t], children);
+            }
+        }
+
+        _tasks = children;
+    }
+
+    // deal the tasks out round robin so every thread starts on one of the most promising tasks
+    for (size_t t(0); t < _tasks.size(); ++t)
+    {
+        _tasks[t].index = t;
+        _queues[t % _queues.size()].push_back(t);
+    }
+
+    _splitNodes = splitter.getResults().nodesExpanded;
+    BOSS_STATS(_splitStats = splitter.getResults().stats);
+}
+
+// threads take tasks from the front of their own queue and steal from the back of other queues
+bool DFBB_BuildOrderParallelSearch::getNextTask(const size_t worker, size_t & task)
+{
+    for (size_t i(0); i < _queues.size(); ++i)
+    {
+        const size_t q = (worker + i) % _queues.size();
+
+        std::lock_guard<std::mutex> lock(_queueLocks[q]);
+
+        if (_queues[q].empty())
+        {
+            continue;
+        }
+
+        if (q == worker)
+        {
+            task = _queues[q].front();
+            _queues[q].pop_front();
+        }
+        else
+        {
+            task = _queues[q].back();
+            _queues[q].pop_back();
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void DFBB_BuildOrderParallelSearch::workerThread(const size_t worker, std::exception_ptr & error)
+{
+    try
+    {
+        while (true)
+        {
+            if (_workerTask[worker] < 0)
+            {
+                size_t task = 0;
+                if (!getNextTask(worker, task))
+                {
+                    return;
+                }
+
+                _workers[worker].setTask(_tasks[task]);
+                _workerTask[worker] = (int)task;
+            }
+
+            // if the search ran out of budget the task stays with this worker so the next search call resumes it
+            if (!_workers[worker].searchTask())
+            {
+                return;
+            }
+
+            _workerTask[worker] = -1;
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+        _shared.stop();
+    }
+}
+
+void DFBB_BuildOrderParallelSearch::search()
+{
+    search(_params.getBudget());
+}
+
+// the time limit is shared by all threads and the node limit is split evenly between them
+bool DFBB_BuildOrderParallelSearch::search(const DFBB_SearchBudget & budget)
+{
+    _searchTimer.start();
+
+    if (_results.solved)
+    {
+        return true;
+    }
+
+    _shared.start(budget.timeLimit);
+
+    const unsigned long long workerNodes = budget.nodeLimit ? std::max(budget.nodeLimit / _workers.size(), 1ull) : 0;
+    for (size_t w(0); w < _workers.size(); ++w)
+    {
+        _workers[w].setBudget(DFBB_SearchBudget(0, workerNodes));
+    }
+
+    if (_firstSearch)
+    {
+        int upperBound = _params.initialUpperBound ? _params.initialUpperBound : Tools::GetUpperBound(_params.initialState, _params.goal);
+
+        // add one frame to the upper bound so our strictly lesser than check still works if we have an exact upper bound
+        _shared.init(upperBound + 1, _params.useTranspositionTable ? _params.transpositionTableSize : 0);
+        generateTasks();
+        _firstSearch = false;
+
+        std::cout << "Upper bound is: " << (upperBound + 1) << ", " << _tasks.size() << " tasks" << std::endl;
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(_workers.size());
+
+    for (size_t w(0); w < _workers.size(); ++w)
+    {
+        threads.push_back(std::thread(&DFBB_BuildOrderParallelSearch::workerThread, this, w, std::ref(errors[w])));
+    }
+
+    for (size_t w(0); w < threads.size(); ++w)
+    {
+        threads[w].join();
+    }
+
+    for (size_t w(0); w < errors.size(); ++w)
+    {
+        if (errors[w])
+        {
+            std::rethrow_exception(errors[w]);
+        }
+    }
+
+    bool finished = true;
+    for (size_t w(0); w < _workers.size(); ++w)
+    {
+        finished = finished && (_workerTask[w] < 0) && _queues[w].empty();
+    }
+
+    const DFBB_BuildOrderSearchResults best = _shared.getResults();
+    _results.buildOrder     = best.buildOrder;
+    _results.finalState     = best.finalState;
+    _results.upperBound     = best.upperBound;
+    _results.solutionFound  = best.solutionFound;
+    _results.firstSolutionTime = best.firstSolutionTime;
+
+    _results.nodesExpanded = _splitNodes;
+    _results.transpositionHits = 0;
+    BOSS_STATS(_results.stats = _splitStats);
+    for (size_t w(0); w < _workers.size(); ++w)
+    {
+        _results.nodesExpanded += _workers[w].getResults().nodesExpanded;
+        _results.transpositionHits += _workers[w].getResults().transpositionHits;
+        BOSS_STATS(_results.stats.add(_workers[w].getResults().stats));
+    }
+
+    _results.timedOut = !finished;
+    _results.solved = finished;
+    _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+
+    return _results.solved;
+}
+
+const DFBB_BuildOrderSearchResults & DFBB_BuildOrderParallelSearch::getResults() const
+{
+    return _results;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Common.h"
+#include "DFBB_BuildOrderStackSearch.h"
+#include "DFBB_TranspositionTable.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace BOSS
+{
+
+// a subtree of the search which is searched on its own by one worker thread
+// tasks are numbered in the order the sequential search would visit them
+class DFBB_SearchTask
+{
+public:
+
+    GameState           state;
+    BuildOrder          buildOrder;     // actions leading from the initial state to this state
+    size_t              depth;
+    size_t              index;
+
+    DFBB_SearchTask()
+        : depth(0)
+        , index(0)
+    {
+
+    }
+};
+
+// the data shared by all worker threads of a parallel search
+class DFBB_ParallelSearchData
+{
+    std::atomic<int>                    _upperBound;
+    std::atomic<bool>                   _stop;
+
+    std::mutex                          _resultsMutex;
+    DFBB_BuildOrderSearchResults        _results;           // best solution, ties go to the lowest task index
+    size_t                              _resultsTask;
+
+    DFBB_TranspositionTable             _transpositionTable;
+    std::vector<std::mutex>             _tableLocks;
+
+    std::chrono::steady_clock::time_point _searchStart;     // Timer is not safe to read from several threads
+    double                              _searchTimeLimit;
+
+public:
+
+    DFBB_ParallelSearchData();
+
+    void                                init(const int upperBound, const size_t transpositionTableSize);
+    void                                start(const double timeLimit);
+    void                                stop();
+
+    int                                 getUpperBound() const;
+    bool                                isTimeOut(const unsigned long long nodesExpanded);
+    bool                                checkTranspositionTable(const GameState & state, const size_t depth, const size_t task);
+    void                                updateResults(const GameState & state, const BuildOrder & buildOrder, const size_t task);
+
+    DFBB_BuildOrderSearchResults        getResults();
+};
+
+class DFBB_BuildOrderParallelSearch
+{
+    DFBB_BuildOrderSearchParameters     _params;
+    DFBB_BuildOrderSearchResults        _results;
+    DFBB_ParallelSearchData             _shared;
+
+    std::vector<DFBB_SearchTask>        _tasks;
+    std::vector<DFBB_BuildOrderStackSearch> _workers;
+    std::vector<int>                    _workerTask;        // task each worker is in the middle of, -1 if none
+    std::vector<std::deque<size_t>>     _queues;            // tasks not yet started, one queue per worker
+    std::vector<std::mutex>             _queueLocks;
+
+    Timer                               _searchTimer;
+    bool                                _firstSearch;
+    unsigned long long                  _splitNodes;
+    DFBB_SearchStats                    _splitStats;            // the splitter's part of the stats
+
+    void                                generateTasks();
+    bool                                getNextTask(const size_t worker, size_t & task);
+    void                                workerThread(const size_t worker, std::exception_ptr & error);
+
+public:
+
+    DFBB_BuildOrderParallelSearch(const DFBB_BuildOrderSearchParameters & p);
+
+    void                                setTimeLimit(double ms);
+    void                                search();
+    bool                                search(const DFBB_SearchBudget & budget);
+    const DFBB_BuildOrderSearchResults & getResults() const;
+};
+
+}
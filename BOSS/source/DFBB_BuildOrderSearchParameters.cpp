@@ -12,7 +12,17 @@ DFBB_BuildOrderSearchParameters::DFBB_BuildOrderSearchParameters(const RaceID &
     , supplyBoundingThreshold(1)
     , useLandmarkLowerBoundHeuristic(true)
     , useResourceLowerBoundHeuristic(true)
+    , useTranspositionTable(false)
+    , transpositionTableSize(1 << 19)
     , searchTimeLimit(0)
+    , searchNodeLimit(0)
+    , numThreads(1)
+    , beamWidth(8)
+    , maxBeamWidth(256)
+    , milestoneSize(12)
+    , milestoneTimeLimit(50)
+    , useLocalImprovement(true)
+    , wholeGoalTimeLimit(500)
     , initialUpperBound(0)
     , repetitionValues(Constants::MAX_ACTIONS, 1)
     , repetitionThresholds(Constants::MAX_ACTIONS, 0)
@@ -21,6 +31,11 @@ DFBB_BuildOrderSearchParameters::DFBB_BuildOrderSearchParameters(const RaceID &
     
 }
 
+DFBB_SearchBudget DFBB_BuildOrderSearchParameters::getBudget() const
+{
+    return DFBB_SearchBudget(searchTimeLimit, searchNodeLimit);
+}
+
 void DFBB_BuildOrderSearchParameters::setRepetitions(const ActionType & a, const UnitCountType & repetitions)
 { 
     BOSS_ASSERT(a.ID() >= 0 && a.ID() < repetitionValues.size(), "Action type not valid");
@@ -67,6 +82,8 @@ std::string DFBB_BuildOrderSearchParameters::toString() const
     ss << (useResourceLowerBoundHeuristic ?    "\tUSE      Resource Lower Bound\n" : "");
     ss << (useAlwaysMakeWorkers ?              "\tUSE      Always Make Workers\n" : "");
     ss << (useSupplyBounding ?                 "\tUSE      Supply Bounding\n" : "");
+    ss << (useTranspositionTable ?             "\tUSE      Transposition Table\n" : "");
+    ss << (numThreads > 1 ?                    "\tUSE      " + std::to_string(numThreads) + " Threads\n" : "");
     ss << ("\n");
 
     for (ActionID a(0); a < repetitionValues.size(); ++a)
@@ -93,6 +110,11 @@ std::string DFBB_BuildOrderSearchParameters::toString() const
         ss << "Relevant:   " << relevantActions[i].getName() << "\n";
     }
 
+    if (!seedBuildOrder.empty())
+    {
+        ss << "\nSeed:       " << seedBuildOrder.getNameString() << "\n";
+    }
+
     ss << "\n\n" << initialState.getUnitData().getBuildingData().toString();
 
     return ss.str();
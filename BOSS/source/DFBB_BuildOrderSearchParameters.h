@@ -3,11 +3,28 @@
 #include "Common.h"
 #include "BuildOrderSearchGoal.h"
 #include "GameState.h"
+#include "BuildOrder.h"
 #include "DFBB_BuildOrderSearchSaveState.h"
 
 namespace BOSS
 {
 
+// how long a single call to search() may run before it pauses, zero means no limit
+class DFBB_SearchBudget
+{
+public:
+
+    double              timeLimit;      // milliseconds
+    unsigned long long  nodeLimit;
+
+    DFBB_SearchBudget(const double timeLimitMS = 0, const unsigned long long nodes = 0)
+        : timeLimit(timeLimitMS)
+        , nodeLimit(nodes)
+    {
+
+    }
+};
+
 class DFBB_BuildOrderSearchParameters
 {
 
@@ -71,19 +88,74 @@ public:
     bool useLandmarkLowerBoundHeuristic;
     bool useResourceLowerBoundHeuristic;
 
+    //      Flag which determines whether or not we use a transposition table in our search
+    //      Different orderings of the same actions often lead to the same state. With the
+    //          transposition table enabled, a state is not expanded again if an identical state
+    //          with at least as many resources was already expanded at an earlier or equal frame.
+    //          transpositionTableSize is the number of table entries, rounded to a power of two.
+    //
+    //      true:  the transposition table is used
+    //      false: the transposition table is not used
+    bool useTranspositionTable;
+    size_t transpositionTableSize;
+
     //      Search time limit measured in milliseconds
     //      If searchTimeLimit is set to a value greater than zero, the search will effectively
-    //          time out and the best solution so far will be used in the results. This is
-    //          accomplished by throwing an exception if the time limit is hit. Time is checked
-    //          once every 1000 nodes expanded, as checking the time is slow.
+    //          time out and the best solution so far will be used in the results. The search
+    //          pauses before expanding the next node and continues from that node the next
+    //          time search() is called. Time is checked once every 16 nodes expanded, so
+    //          limits well under a millisecond are kept.
     double searchTimeLimit;
 
+    //      Search node limit
+    //      If searchNodeLimit is set to a value greater than zero, each call to search()
+    //          pauses after expanding that many nodes, in the same way as the time limit.
+    unsigned long long searchNodeLimit;
+
+    //      Number of threads used by the search
+    //      If numThreads is greater than one, DFBB_BuildOrderSmartSearch uses a parallel search
+    //          which splits the search tree into tasks and shares the upper bound between
+    //          threads. When run to completion it returns the same build order as the
+    //          sequential search.
+    int numThreads;
+
+    //      Beam widths for BeamBuildOrderSearch
+    //      The beam search keeps the beamWidth best states at each depth and returns the best
+    //          build order it reaches. It then searches again with twice the width, keeping the
+    //          best build order of all passes, until the width passes maxBeamWidth.
+    //          The first pass gives a build order quickly, the rest improve it while time remains.
+    size_t beamWidth;
+    size_t maxBeamWidth;
+
+    //      Milestones for MilestoneBuildOrderSearch
+    //      The milestone search splits the goal into milestones of at most milestoneSize actions,
+    //          with prerequisites in earlier milestones than what they are needed for, and solves
+    //          each milestone with DFBB from the state the previous one ended in. A milestone is
+    //          searched for at most milestoneTimeLimit milliseconds, 0 meaning until it is solved,
+    //          after which the best build order found for it is used.
+    //      If useLocalImprovement is set, adjacent actions of the joined build order are then
+    //          swapped wherever that makes it finish sooner, within the search budget.
+    //      Milestones give worse build orders than DFBB on the whole goal, so the whole goal is
+    //          first searched with DFBB for wholeGoalTimeLimit milliseconds, 0 meaning not at all,
+    //          and split into milestones only if that search doesn't finish.
+    size_t milestoneSize;
+    double milestoneTimeLimit;
+    bool useLocalImprovement;
+    double wholeGoalTimeLimit;
+
     //      Initial upper bound for the DFBB search
     //      If this value is set to zero, DFBB search will automatically determine an
     //          appropriate upper bound using an upper bound heuristic. If it is non-zero,
     //          it will use the value as an initial bound.
     int initialUpperBound;
 
+    //      Seed build order for the DFBB search
+    //      If it is not empty, the child that follows the seed is searched first at every node
+    //          on the seed's path, so a solution at least as good as the seed is found early.
+    //          The seed should reach the goal from the initial state and its completion time
+    //          should be used as initialUpperBound.
+    BuildOrder seedBuildOrder;
+
     //      StarcraftSearchGoal used for the search. See StarcraftSearchGoal.hpp for details
     BuildOrderSearchGoal goal;
 
@@ -96,6 +168,8 @@ public:
     // alternate constructor
     DFBB_BuildOrderSearchParameters(const RaceID & r = Races::None);
 
+    DFBB_SearchBudget getBudget() const;
+
     void setMaxActions(const ActionType & a,const UnitCountType & max);
     void setRepetitions(const ActionType & a,const UnitCountType & repetitions);
     void setRepetitionThreshold(const ActionType & a,const UnitCountType & thresh);
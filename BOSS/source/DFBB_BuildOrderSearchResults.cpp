@@ -8,7 +8,9 @@ DFBB_BuildOrderSearchResults::DFBB_BuildOrderSearchResults()
     , solutionFound(false)
     , upperBound(0)
     , nodesExpanded(0)
+    , transpositionHits(0)
     , timeElapsed(0)
+    , firstSolutionTime(0)
 {
 }
 
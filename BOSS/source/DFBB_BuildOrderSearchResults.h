@@ -4,6 +4,7 @@
 #include "ActionType.h"
 #include "GameState.h"
 #include "BuildOrder.h"
+#include "DFBB_SearchStats.h"
 
 namespace BOSS
 {
@@ -21,10 +22,14 @@ public:
 	int					        upperBound;		// upper bound of first node
 	
 	unsigned long long 	        nodesExpanded;	// number of nodes expanded in the search
+    unsigned long long          transpositionHits; // number of nodes pruned by the transposition table
 	
 	double 				        timeElapsed;	// time elapsed in milliseconds
+    double                      firstSolutionTime;  // milliseconds until the first solution was found
 
     GameState                   finalState;
+
+    DFBB_SearchStats            stats;          // filled in if BOSS_SEARCH_STATS is defined
 	
 	DFBB_BuildOrderSearchResults();
 	DFBB_BuildOrderSearchResults(bool s, int len, unsigned long long n, double t, std::vector<ActionType> solution);
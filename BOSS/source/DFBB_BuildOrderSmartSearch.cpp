@@ -1,5 +1,7 @@
 #include "DFBB_BuildOrderSmartSearch.h"
 
+#include <algorithm>
+
 using namespace BOSS;
 
 DFBB_BuildOrderSmartSearch::DFBB_BuildOrderSmartSearch(const RaceID race) 
@@ -8,18 +10,32 @@ DFBB_BuildOrderSmartSearch::DFBB_BuildOrderSmartSearch(const RaceID race)
     , _goal(race)
     , _stackSearch(race)
     , _searchTimeLimit(30)
+    , _numThreads(1)
+    , _initialUpperBound(0)
+    , _engine(SearchEngines::DFBB)
 {
 }
 
-void DFBB_BuildOrderSmartSearch::doSearch()
+void DFBB_BuildOrderSmartSearch::doSearch(const DFBB_SearchBudget & budget)
 {
     BOSS_ASSERT(_initialState.getRace() != Races::None, "Must set initial state before performing search");
 
     // if we are resuming a search
-    if (_stackSearch.getResults().timedOut)
+    if (_milestoneSearch && _milestoneSearch->getResults().timedOut)
+    {
+        _milestoneSearch->search(budget);
+    }
+    else if (_beamSearch && _beamSearch->getResults().timedOut)
+    {
+        _beamSearch->search(budget);
+    }
+    else if (_parallelSearch && _parallelSearch->getResults().timedOut)
+    {
+        _parallelSearch->search(budget);
+    }
+    else if (!_parallelSearch && _stackSearch.getResults().timedOut)
     {
-        _stackSearch.setTimeLimit(_searchTimeLimit);
-        _stackSearch.search();
+        _stackSearch.search(budget);
     }
     else
     {
@@ -31,15 +47,83 @@ void DFBB_BuildOrderSmartSearch::doSearch()
         _params.useAlwaysMakeWorkers 		= true;
         _params.useSupplyBounding 			= true;
         _params.supplyBoundingThreshold     = 1.5;
+        _params.useTranspositionTable       = true;
         _params.relevantActions             = _relevantActions;
         _params.searchTimeLimit             = _searchTimeLimit;
+        _params.numThreads                  = _numThreads;
+        _params.initialUpperBound           = _initialUpperBound;
+        setSeedBuildOrder();
 
         // BWAPI::Broodwar->printf("Constructing new search object time limit is %lf", _params.searchTimeLimit);
-        _stackSearch = DFBB_BuildOrderStackSearch(_params);
-        _stackSearch.search();
+        if (_engine == SearchEngines::Milestones)
+        {
+            _parallelSearch.reset();
+            _beamSearch.reset();
+            _milestoneSearch = std::shared_ptr<MilestoneBuildOrderSearch>(new MilestoneBuildOrderSearch(_params));
+            _milestoneSearch->search(budget);
+        }
+        else if (_engine == SearchEngines::Beam)
+        {
+            _parallelSearch.reset();
+            _milestoneSearch.reset();
+            _beamSearch = std::shared_ptr<BeamBuildOrderSearch>(new BeamBuildOrderSearch(_params));
+            _beamSearch->search(budget);
+        }
+        else if (_numThreads > 1)
+        {
+            _beamSearch.reset();
+            _milestoneSearch.reset();
+            _parallelSearch = std::shared_ptr<DFBB_BuildOrderParallelSearch>(new DFBB_BuildOrderParallelSearch(_params));
+            _parallelSearch->search(budget);
+        }
+        else
+        {
+            _parallelSearch.reset();
+            _beamSearch.reset();
+            _milestoneSearch.reset();
+            _stackSearch = DFBB_BuildOrderStackSearch(_params);
+            _stackSearch.search(budget);
+        }
     }
 
-    _results = _stackSearch.getResults();
+    // a beam that reaches the goal in none of its passes would leave only the naive build order
+    // so the rest of the budget goes to the milestone search, which first tries DFBB on the whole goal
+    if (_beamSearch && !_beamSearch->getResults().timedOut && !_beamSearch->getResults().solutionFound)
+    {
+        DFBB_SearchBudget rest(budget);
+        if (budget.timeLimit > 0)
+        {
+            // at least a little, since a time limit of 0 means no limit
+            rest.timeLimit = std::max(budget.timeLimit - _beamSearch->getResults().timeElapsed, 1.0);
+        }
+
+        _beamSearch.reset();
+        _milestoneSearch = std::shared_ptr<MilestoneBuildOrderSearch>(new MilestoneBuildOrderSearch(_params));
+        _milestoneSearch->search(rest);
+    }
+
+    if (_milestoneSearch)
+    {
+        _results = _milestoneSearch->getResults();
+    }
+    else if (_beamSearch)
+    {
+        _results = _beamSearch->getResults();
+    }
+    else
+    {
+        _results = _parallelSearch ? _parallelSearch->getResults() : _stackSearch.getResults();
+    }
+
+    // the search only looks for build orders at least as good as the seed, so if it has none the seed is the best we know
+    if (!_results.solutionFound && !_params.seedBuildOrder.empty())
+    {
+        _results.solutionFound = true;
+        _results.buildOrder = _params.seedBuildOrder;
+        _results.finalState = _params.initialState;
+        _params.seedBuildOrder.doActions(_results.finalState);
+        _results.upperBound = _results.finalState.getLastActionFinishTime();
+    }
 
     if (_results.solved && !_results.solutionFound)
     {
@@ -187,6 +271,31 @@ void DFBB_BuildOrderSmartSearch::setPrerequisiteGoalMax()
         _goal.setGoalMax(ActionTypes::GetActionType("Zerg_Lair"), 1);
         _goal.setGoalMax(ActionTypes::GetActionType("Zerg_Spire"), 1);
         _goal.setGoalMax(ActionTypes::GetActionType("Zerg_Hydralisk_Den"), 1);
+
+        // the goal itself and hive tech such as the queen's nest and the hive have to be in the max too,
+        // otherwise a goal with more hatcheries or extractors than we have or with hive units can't be reached
+        for (const auto & actionType : ActionTypes::GetAllActionTypes(getRace()))
+        {
+            if (_goal.getGoal(actionType) == 0)
+            {
+                continue;
+            }
+
+            _goal.setGoalMax(actionType, std::max(_goal.getGoal(actionType), _goal.getGoalMax(actionType)));
+
+            PrerequisiteSet recursivePrerequisites = actionType.getRecursivePrerequisites();
+            for (size_t a(0); a < recursivePrerequisites.size(); ++a)
+            {
+                const ActionType & prerequisite = recursivePrerequisites.getActionType(a);
+
+                if (prerequisite == ActionTypes::GetResourceDepot(getRace()) || prerequisite.isWorker() || prerequisite.isSupplyProvider() || prerequisite.isRefinery())
+                {
+                    continue;
+                }
+
+                _goal.setGoalMax(prerequisite, std::max((UnitCountType)1, _goal.getGoalMax(prerequisite)));
+            }
+        }
     }
 }
 
@@ -302,14 +411,112 @@ void DFBB_BuildOrderSmartSearch::setState(const GameState & state)
 }
 
 
-void DFBB_BuildOrderSmartSearch::setTimeLimit(int n)
+void DFBB_BuildOrderSmartSearch::setTimeLimit(double ms)
 {
-    _searchTimeLimit = n;
+    _searchTimeLimit = ms;
+}
+
+void DFBB_BuildOrderSmartSearch::setNumThreads(int n)
+{
+    _numThreads = n;
+}
+
+// the frame a known build order reaches the goal by, used instead of the naive build order's completion time
+// the search then only finds build orders at least as good as the known one
+void DFBB_BuildOrderSmartSearch::setUpperBound(const FrameCountType frame)
+{
+    _initialUpperBound = frame;
+}
+
+// a build order which is expected to reach the goal, such as the previous solution for a similar goal
+// seeds are checked when the search starts, so they have to be added before the first call to search
+void DFBB_BuildOrderSmartSearch::addSeed(const BuildOrder & buildOrder)
+{
+    _seeds.push_back(buildOrder);
+}
+
+// DFBB by default, the engine is picked when the search starts so it has to be set before the first call to search
+void DFBB_BuildOrderSmartSearch::setEngine(const SearchEngines::SearchEngine engine)
+{
+    _engine = engine;
+}
+
+SearchEngines::SearchEngine DFBB_BuildOrderSmartSearch::getEngine() const
+{
+    return _engine;
+}
+
+// simulates each seed from the initial state and keeps the one that reaches the goal first
+// a seed is cut off as soon as it reaches the goal, and seeds that become illegal or never reach it are dropped
+// the kept seed's completion time becomes the initial upper bound if it is better than the one we were given
+void DFBB_BuildOrderSmartSearch::setSeedBuildOrder()
+{
+    _params.seedBuildOrder.clear();
+    FrameCountType bestFinishTime = 0;
+
+    if (_seeds.empty())
+    {
+        return;
+    }
+
+    // the naive build order is what the search would start from without seeds, so a seed has to beat it
+    std::vector<BuildOrder> seeds(_seeds);
+    if (!_params.initialUpperBound)
+    {
+        NaiveBuildOrderSearch naiveSearch(_params.initialState, _params.goal);
+        seeds.push_back(naiveSearch.solve());
+    }
+
+    for (const BuildOrder & seed : seeds)
+    {
+        GameState state(_params.initialState);
+        BuildOrder buildOrder;
+        bool reachedGoal = false;
+
+        for (size_t i(0); !reachedGoal && (i < seed.size()); ++i)
+        {
+            if ((seed[i].getRace() != getRace()) || !state.isLegal(seed[i]))
+            {
+                break;
+            }
+
+            state.doAction(seed[i]);
+            buildOrder.add(seed[i]);
+            reachedGoal = _params.goal.isAchievedBy(state);
+        }
+
+        if (!reachedGoal)
+        {
+            continue;
+        }
+
+        const FrameCountType finishTime = state.getLastActionFinishTime();
+        if (_params.seedBuildOrder.empty() || (finishTime < bestFinishTime))
+        {
+            _params.seedBuildOrder = buildOrder;
+            bestFinishTime = finishTime;
+        }
+    }
+
+    if (!_params.seedBuildOrder.empty() && (!_params.initialUpperBound || (bestFinishTime < _params.initialUpperBound)))
+    {
+        _params.initialUpperBound = bestFinishTime;
+    }
 }
 
 void DFBB_BuildOrderSmartSearch::search()
 {
-    doSearch();
+    doSearch(DFBB_SearchBudget(_searchTimeLimit));
+}
+
+// starts or resumes the search and pauses it once the budget is used up
+// returns true once the search is finished, the results hold the best build order found so far either way
+// a finished search is solved if its build order is proven the best, which the beam and milestone searches' never are
+bool DFBB_BuildOrderSmartSearch::search(const DFBB_SearchBudget & budget)
+{
+    doSearch(budget);
+
+    return !_results.timedOut;
 }
 
 const DFBB_BuildOrderSearchResults & DFBB_BuildOrderSmartSearch::getResults() const
@@ -3,10 +3,25 @@
 #include "Common.h"
 #include "GameState.h"
 #include "DFBB_BuildOrderStackSearch.h"
+#include "DFBB_BuildOrderParallelSearch.h"
+#include "NaiveBuildOrderSearch.h"
+#include "BeamBuildOrderSearch.h"
+#include "MilestoneBuildOrderSearch.h"
 #include "Timer.hpp"
 
+#include <memory>
+
 namespace BOSS
 {
+
+// DFBB finds the best build order but may not finish in time for a large goal
+// the beam search always finishes, with a good build order rather than the best one, and hands over to the milestone search if it finds none
+// the milestone search solves the goal a few actions at a time with DFBB, in about the time of those small searches
+namespace SearchEngines
+{
+    enum SearchEngine { DFBB, Beam, Milestones };
+}
+
 class DFBB_BuildOrderSmartSearch
 {
     RaceID                              _race;
@@ -18,20 +33,28 @@ class DFBB_BuildOrderSmartSearch
 
 	GameState					        _initialState;
 	
-	int 							    _searchTimeLimit;
+	double 							    _searchTimeLimit;
+    int                                 _numThreads;
+    FrameCountType                      _initialUpperBound;     // 0 means use the naive build order
+    std::vector<BuildOrder>             _seeds;                 // known build orders, the best one is used to start the search
 
 	Timer							    _searchTimer;
 
     DFBB_BuildOrderStackSearch          _stackSearch;
+    std::shared_ptr<DFBB_BuildOrderParallelSearch> _parallelSearch;    // used instead of _stackSearch if _numThreads > 1
+    std::shared_ptr<BeamBuildOrderSearch> _beamSearch;          // used instead of both if the engine is SearchEngines::Beam
+    std::shared_ptr<MilestoneBuildOrderSearch> _milestoneSearch; // used instead of all three if the engine is SearchEngines::Milestones, or after a beam search that found nothing
+    SearchEngines::SearchEngine         _engine;
 
     DFBB_BuildOrderSearchResults        _results;
 	
-	void doSearch();
+	void doSearch(const DFBB_SearchBudget & budget);
 	void calculateSearchSettings();
 	void setPrerequisiteGoalMax();
 	void recurseOverStrictDependencies(const ActionType & action);
     void setRelevantActions();
 	void setRepetitions();
+    void setSeedBuildOrder();
 	
 	UnitCountType calculateSupplyProvidersRequired();
 	UnitCountType calculateRefineriesRequired();
@@ -46,9 +69,15 @@ public:
 	void setGoal(const BuildOrderSearchGoal & goal);
 	void setState(const GameState & state);
 	void print();
-	void setTimeLimit(int n);
+	void setTimeLimit(double ms);
+    void setNumThreads(int n);
+    void setUpperBound(const FrameCountType frame);
+    void addSeed(const BuildOrder & buildOrder);
+    void setEngine(const SearchEngines::SearchEngine engine);
+    SearchEngines::SearchEngine getEngine() const;
 	
 	void search();
+    bool search(const DFBB_SearchBudget & budget);
 
     const DFBB_BuildOrderSearchResults & getResults() const;
 	const DFBB_BuildOrderSearchParameters & getParameters();
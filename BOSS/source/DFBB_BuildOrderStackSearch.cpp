@@ -1,17 +1,42 @@
 #include "DFBB_BuildOrderStackSearch.h"
+#include "DFBB_BuildOrderParallelSearch.h"
 
 using namespace BOSS;
 
+namespace
+{
+    // reading the clock costs far less than expanding a node, so it can be checked often
+    const unsigned long long TimeCheckInterval = 16;
+}
+
 DFBB_BuildOrderStackSearch::DFBB_BuildOrderStackSearch(const DFBB_BuildOrderSearchParameters & p)
     : _params(p)
     , _depth(0)
     , _firstSearch(true)
     , _wasInterrupted(false)
     , _stack(100, StackData())
+    , _shared(nullptr)
+    , _taskIndex(0)
+    , _rootDepth(0)
+    , _budgetStartNodes(0)
+    , _searchFunction(GetSearchFunction(p.initialState.getRace()))
+    , _lowerBound(p.goal)
 {
     
 }
 
+// the search runs entirely on the race specific GameState functions, so the race is only looked at here
+DFBB_BuildOrderStackSearch::SearchFunction DFBB_BuildOrderStackSearch::GetSearchFunction(const RaceID race)
+{
+    switch (race)
+    {
+        case Races::Protoss:    return &DFBB_BuildOrderStackSearch::DFBB<Races::Protoss>;
+        case Races::Terran:     return &DFBB_BuildOrderStackSearch::DFBB<Races::Terran>;
+        case Races::Zerg:       return &DFBB_BuildOrderStackSearch::DFBB<Races::Zerg>;
+        default:                return nullptr;
+    }
+}
+
 void DFBB_BuildOrderStackSearch::setTimeLimit(double ms)
 {
     _params.searchTimeLimit = ms;
@@ -19,8 +44,16 @@ void DFBB_BuildOrderStackSearch::setTimeLimit(double ms)
 
 // function which is called to do the actual search
 void DFBB_BuildOrderStackSearch::search()
+{
+    search(_params.getBudget());
+}
+
+// searches until the search is finished or the budget is used up, and returns true if it finished
+// a paused search keeps its stack and state, so the next call carries on from the node it stopped at
+bool DFBB_BuildOrderStackSearch::search(const DFBB_SearchBudget & budget)
 {
     _searchTimer.start();
+    setBudget(budget);
 
     if (!_results.solved)
     {
@@ -31,32 +64,34 @@ void DFBB_BuildOrderStackSearch::search()
             // add one frame to the upper bound so our strictly lesser than check still works if we have an exact upper bound
             _results.upperBound += 1;
 
-            _stack[0].state = _params.initialState;
+            _state = _params.initialState;
             _firstSearch = false;
-            //BWAPI::Broodwar->printf("Upper bound is %d", _results.upperBound);
-            std::cout << "Upper bound is: " << _results.upperBound << std::endl;
-        }
-
-        try 
-        {
-            // search on the initial state
-            DFBB();
 
-            _results.timedOut = false;
-        }
-        catch (int e) 
-        {
-            if (e == DFBB_TIMEOUT_EXCEPTION)
+            // the table is allocated here rather than in the constructor since search objects get copied around
+            if (_params.useTranspositionTable)
             {
-                //BWAPI::Broodwar->printf("I timed out!");
-                _results.timedOut = true;
+                _transpositionTable.init(_params.transpositionTableSize);
             }
+
+            //BWAPI::Broodwar->printf("Upper bound is %d", _results.upperBound);
+            std::cout << "Upper bound is: " << _results.upperBound << std::endl;
         }
+
+        // search on the initial state
+        _results.timedOut = !DFBB();
         
         double ms = _searchTimer.getElapsedTimeInMilliSec();
         _results.solved = !_results.timedOut;
         _results.timeElapsed = ms;
     }
+
+    return _results.solved;
+}
+
+void DFBB_BuildOrderStackSearch::setBudget(const DFBB_SearchBudget & budget)
+{
+    _budget = budget;
+    _budgetStartNodes = _results.nodesExpanded;
 }
 
 const DFBB_BuildOrderSearchResults & DFBB_BuildOrderStackSearch::getResults() const
@@ -64,66 +99,187 @@ const DFBB_BuildOrderSearchResults & DFBB_BuildOrderStackSearch::getResults() co
     return _results;
 }
 
-void DFBB_BuildOrderStackSearch::generateLegalActions(const GameState & state, ActionSet & legalActions)
+void DFBB_BuildOrderStackSearch::setSharedData(DFBB_ParallelSearchData * shared)
+{
+    _shared = shared;
+}
+
+void DFBB_BuildOrderStackSearch::setTask(const DFBB_SearchTask & task)
+{
+    _state          = task.state;
+    _buildOrder     = task.buildOrder;
+    _taskIndex      = task.index;
+    _rootDepth      = task.depth;
+    _depth          = 0;
+}
+
+// searches the current task, returns false if the search ran out of budget and the task has to be resumed
+bool DFBB_BuildOrderStackSearch::searchTask()
+{
+    // tasks which were split off as leaves of the search tree are solutions on their own
+    if ((_rootDepth > 0) && _params.goal.isAchievedBy(_state))
+    {
+        updateResults(_state);
+        return true;
+    }
+
+    return DFBB();
+}
+
+// generates the children of a task exactly as DFBB would, in the same order
+void DFBB_BuildOrderStackSearch::expandTask(const DFBB_SearchTask & task, std::vector<DFBB_SearchTask> & children)
+{
+    _results.nodesExpanded++;
+    BOSS_STATS(_results.stats.addNode(task.depth));
+
+    ActionSet legalActions;
+    generateLegalActions(task.state, task.buildOrder, legalActions);
+
+    for (size_t a(0); a < legalActions.size(); ++a)
+    {
+        const ActionType & actionType = legalActions[a];
+
+        FrameCountType actionFinishTime = BOSS_STATS_CALL(&_results.stats, StateCalls::WhenCanPerform, task.state.whenCanPerform(actionType)) + actionType.buildTime();
+        FrameCountType heuristicTime    = task.state.getCurrentFrame() + _lowerBound.get(task.state);
+
+        if (std::max(actionFinishTime, heuristicTime) > getUpperBound())
+        {
+            BOSS_STATS(_results.stats.addPruned(PruneReasons::UpperBound));
+            continue;
+        }
+
+        BOSS_STATS(_results.stats.addChild(task.depth));
+
+        DFBB_SearchTask child;
+        child.state         = task.state;
+        child.buildOrder    = task.buildOrder;
+        child.depth         = task.depth + 1;
+
+        UnitCountType repetitions = getRepetitions(task.state, actionType);
+        for (UnitCountType r(0); r < repetitions; ++r)
+        {
+            if (BOSS_STATS_CALL(&_results.stats, StateCalls::IsLegal, child.state.isLegal(actionType)))
+            {
+                child.buildOrder.add(actionType);
+                BOSS_STATS_CALL(&_results.stats, StateCalls::DoAction, child.state.doAction(actionType));
+                BOSS_STATS(if (r > 0) _results.stats.addPruned(PruneReasons::Repetitions));
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        children.push_back(child);
+    }
+}
+
+// legal actions are gathered in a mask and added to legalActions in ActionID order,
+// which is the order the relevant actions are set in by the smart search
+// the one exception is the next action of the seed build order, which goes first while we follow the seed
+void DFBB_BuildOrderStackSearch::generateLegalActions(const GameState & state, const BuildOrder & buildOrder, ActionSet & legalActions)
+{
+    BOSS_RACE_DISPATCH(state.getRace(), generateLegalActions, state, buildOrder, legalActions);
+}
+
+template <RaceID race>
+void DFBB_BuildOrderStackSearch::generateLegalActions(const GameState & state, const BuildOrder & buildOrder, ActionSet & legalActions)
 {
     legalActions.clear();
-    BuildOrderSearchGoal & goal = _params.goal;
-    const ActionType & worker = ActionTypes::GetWorker(state.getRace());
+    ActionMask legal(GetLegalActions<race>(_params, state, &_results.stats));
+
+    if (isOnSeedPath(buildOrder))
+    {
+        const ActionType & seedAction = _params.seedBuildOrder[buildOrder.size()];
+        if (legal.contains(seedAction))
+        {
+            legalActions.add(seedAction);
+            legal.remove(seedAction);
+        }
+    }
+
+    while (!legal.isEmpty())
+    {
+        legalActions.add(ActionTypes::GetActionType(race, legal.popFirst()));
+    }
+}
+
+// the relevant actions which are legal in the state and allowed by the goal and the search abstractions
+// used by DFBB to generate its children and by BeamBuildOrderSearch, so both search the same actions
+// the actions left out are counted in stats by the reason they were left out, if stats isn't null
+ActionMask DFBB_BuildOrderStackSearch::GetLegalActions(const DFBB_BuildOrderSearchParameters & params, const GameState & state, DFBB_SearchStats * stats)
+{
+    BOSS_RACE_DISPATCH(state.getRace(), GetLegalActions, params, state, stats);
+
+    return ActionMask();
+}
+
+template <RaceID race>
+ActionMask DFBB_BuildOrderStackSearch::GetLegalActions(const DFBB_BuildOrderSearchParameters & params, const GameState & state, DFBB_SearchStats * BOSS_STATS_PARAM(stats))
+{
+    const BuildOrderSearchGoal & goal = params.goal;
+    const ActionType & worker = ActionTypes::GetWorker(race);
+
+    ActionMask legal;
     
     // add all legal relevant actions that are in the goal
-    for (size_t a(0); a < _params.relevantActions.size(); ++a)
+    ActionMask relevant(params.relevantActions.getMask());
+    while (!relevant.isEmpty())
     {
-        const ActionType & actionType = _params.relevantActions[a];
-        const std::string & actionName = actionType.getName();
+        const ActionType & actionType = ActionTypes::GetActionType(race, relevant.popFirst());
         const size_t numTotal = state.getUnitData().getNumTotal(actionType);
 
-        if (state.isLegal(actionType))
+        // if there's none of this action in the goal it's not legal
+        if (!goal.getGoal(actionType) && !goal.getGoalMax(actionType))
         {
-            // if there's none of this action in the goal it's not legal
-            if (!goal.getGoal(actionType) && !goal.getGoalMax(actionType))
-            {
-                continue;
-            }
+            continue;
+        }
 
-            // if we already have more than the goal it's not legal
-            if (goal.getGoal(actionType) && (numTotal >= goal.getGoal(actionType)))
-            {
-                continue;
-            }
+        // if we already have more than the goal it's not legal
+        if (goal.getGoal(actionType) && (numTotal >= goal.getGoal(actionType)))
+        {
+            BOSS_STATS(if (stats) stats->addPruned(PruneReasons::GoalMax));
+            continue;
+        }
 
-            // if we already have more than the goal max it's not legal
-            if (goal.getGoalMax(actionType) && (numTotal >= goal.getGoalMax(actionType)))
-            {
-                continue;
-            }
-            
-            legalActions.add(_params.relevantActions[a]);
+        // if we already have more than the goal max it's not legal
+        if (goal.getGoalMax(actionType) && (numTotal >= goal.getGoalMax(actionType)))
+        {
+            BOSS_STATS(if (stats) stats->addPruned(PruneReasons::GoalMax));
+            continue;
+        }
+
+        if (BOSS_STATS_CALL(stats, StateCalls::IsLegal, state.isLegal<race>(actionType)))
+        {
+            legal.add(actionType);
         }
     }
 
     // if we enabled the supply bounding flag
-    if (_params.useSupplyBounding)
+    if (params.useSupplyBounding)
     {
         UnitCountType supplySurplus = state.getUnitData().getMaxSupply() + state.getUnitData().getSupplyInProgress() - state.getUnitData().getCurrentSupply();
-        UnitCountType threshold = (UnitCountType)(ActionTypes::GetSupplyProvider(state.getRace()).supplyProvided() * _params.supplyBoundingThreshold);
+        UnitCountType threshold = (UnitCountType)(ActionTypes::GetSupplyProvider(race).supplyProvided() * params.supplyBoundingThreshold);
 
         if (supplySurplus >= threshold)
         {
-            legalActions.remove(ActionTypes::GetSupplyProvider(state.getRace()));
+            BOSS_STATS(if (stats && legal.contains(ActionTypes::GetSupplyProvider(race))) stats->addPruned(PruneReasons::SupplyBounding));
+            legal.remove(ActionTypes::GetSupplyProvider(race));
         }
     }
     
     // if we enabled the always make workers flag, and workers are legal
-    if (_params.useAlwaysMakeWorkers && legalActions.contains(worker))
+    if (params.useAlwaysMakeWorkers && legal.contains(worker))
     {
         bool actionLegalBeforeWorker = false;
-        ActionSet legalEqualWorker;
-        FrameCountType workerReady = state.whenCanPerform(worker);
+        ActionMask legalEqualWorker;
+        FrameCountType workerReady = BOSS_STATS_CALL(stats, StateCalls::WhenCanPerform, state.whenCanPerform<race>(worker));
 
-        for (size_t a(0); a < legalActions.size(); ++a)
+        ActionMask remaining(legal);
+        while (!remaining.isEmpty())
         {
-            const ActionType & actionType = legalActions[a];
-            const FrameCountType whenCanPerformAction = state.whenCanPerform(actionType);
+            const ActionType & actionType = ActionTypes::GetActionType(race, remaining.popFirst());
+            const FrameCountType whenCanPerformAction = BOSS_STATS_CALL(stats, StateCalls::WhenCanPerform, state.whenCanPerform<race>(actionType));
             if (whenCanPerformAction < workerReady)
             {
                 actionLegalBeforeWorker = true;
@@ -138,13 +294,36 @@ void DFBB_BuildOrderStackSearch::generateLegalActions(const GameState & state, A
 
         if (actionLegalBeforeWorker)
         {
-            legalActions.remove(worker);
+            BOSS_STATS(if (stats) stats->addPruned(PruneReasons::AlwaysMakeWorkers));
+            legal.remove(worker);
         }
         else
         {
-            legalActions = legalEqualWorker;
+            BOSS_STATS(if (stats) stats->addPruned(PruneReasons::AlwaysMakeWorkers, legal.size() - legalEqualWorker.size()));
+            legal = legalEqualWorker;
         }
     }
+
+    return legal;
+}
+
+// true if the build order is the start of the seed build order and the seed has actions left
+bool DFBB_BuildOrderStackSearch::isOnSeedPath(const BuildOrder & buildOrder) const
+{
+    if (buildOrder.size() >= _params.seedBuildOrder.size())
+    {
+        return false;
+    }
+
+    for (size_t i(0); i < buildOrder.size(); ++i)
+    {
+        if (buildOrder[i] != _params.seedBuildOrder[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 UnitCountType DFBB_BuildOrderStackSearch::getRepetitions(const GameState & state, const ActionType & a)
@@ -172,19 +351,86 @@ UnitCountType DFBB_BuildOrderStackSearch::getRepetitions(const GameState & state
     return repeat;
 }
 
-bool DFBB_BuildOrderStackSearch::isTimeOut()
+// records the undo for each action at the same index as the action in the build order
+template <RaceID race>
+void DFBB_BuildOrderStackSearch::doAction(const ActionType & action)
 {
-    return (_params.searchTimeLimit && (_results.nodesExpanded % 200 == 0) && (_searchTimer.getElapsedTimeInMilliSec() > _params.searchTimeLimit));
+    _buildOrder.add(action);
+
+    if (_undo.size() < _buildOrder.size())
+    {
+        _undo.resize(_buildOrder.size());
+    }
+
+    BOSS_STATS_CALL(&_results.stats, StateCalls::DoAction, _state.doAction<race>(action, _undo[_buildOrder.size()-1]));
+}
+
+void DFBB_BuildOrderStackSearch::undoAction()
+{
+    _state.undoAction(_undo[_buildOrder.size()-1]);
+    _buildOrder.pop_back();
+}
+
+bool DFBB_BuildOrderStackSearch::isOutOfBudget()
+{
+    const unsigned long long nodes = _results.nodesExpanded - _budgetStartNodes;
+
+    if (_budget.nodeLimit && (nodes >= _budget.nodeLimit))
+    {
+        return true;
+    }
+
+    if (_shared)
+    {
+        return _shared->isTimeOut(nodes);
+    }
+
+    return (_budget.timeLimit > 0) && (nodes % TimeCheckInterval == 0) && (_searchTimer.getElapsedTimeInMilliSec() > _budget.timeLimit);
+}
+
+int DFBB_BuildOrderStackSearch::getUpperBound() const
+{
+    return _shared ? _shared->getUpperBound() : _results.upperBound;
+}
+
+// returns true if the state can be skipped, otherwise stores it in the table
+bool DFBB_BuildOrderStackSearch::checkTranspositionTable(const GameState & state)
+{
+    if (_shared)
+    {
+        return _shared->checkTranspositionTable(state, _rootDepth + _depth, _taskIndex);
+    }
+
+    const HashValues hash = state.getHash();
+
+    if (_transpositionTable.isDominated(state, hash))
+    {
+        return true;
+    }
+
+    _transpositionTable.store(state, hash, _depth);
+    return false;
 }
 
 void DFBB_BuildOrderStackSearch::updateResults(const GameState & state)
 {
+    if (_shared)
+    {
+        _shared->updateResults(state, _buildOrder, _taskIndex);
+        return;
+    }
+
     FrameCountType finishTime = state.getLastActionFinishTime();
 
     // new best solution
     if (finishTime < _results.upperBound)
     {
         _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+        if (!_results.solutionFound)
+        {
+            _results.firstSolutionTime = _results.timeElapsed;
+        }
+
         _results.upperBound = finishTime;
         _results.solutionFound = true;
         _results.finalState = state;
@@ -195,18 +441,26 @@ void DFBB_BuildOrderStackSearch::updateResults(const GameState & state)
 }
 
 #define ACTION_TYPE     _stack[_depth].currentActionType
-#define STATE           _stack[_depth].state
-#define CHILD_STATE     _stack[_depth+1].state
+#define STATE           _state
 #define CHILD_NUM       _stack[_depth].currentChildIndex
 #define LEGAL_ACTINS    _stack[_depth].legalActions
 #define REPETITIONS     _stack[_depth].repetitionValue
 #define COMPLETED_REPS  _stack[_depth].completedRepetitions
 
-#define DFBB_CALL_RETURN  if (_depth == 0) { return; } else { --_depth; goto SEARCH_RETURN; }
+#define DFBB_CALL_RETURN  if (_depth == 0) { return true; } else { --_depth; goto SEARCH_RETURN; }
 #define DFBB_CALL_RECURSE { ++_depth; goto SEARCH_BEGIN; }
 
-// recursive function which does all search logic
-void DFBB_BuildOrderStackSearch::DFBB()
+bool DFBB_BuildOrderStackSearch::DFBB()
+{
+    BOSS_ASSERT(_searchFunction != nullptr, "DFBB initial state has no race");
+
+    return (this->*_searchFunction)();
+}
+
+// recursive function which does all search logic, written as an explicit stack so it can pause
+// returns true when the search is finished and false when it paused because the budget ran out
+template <RaceID race>
+bool DFBB_BuildOrderStackSearch::DFBB()
 {
     FrameCountType actionFinishTime = 0;
     FrameCountType heuristicTime = 0;
@@ -214,39 +468,51 @@ void DFBB_BuildOrderStackSearch::DFBB()
 
 SEARCH_BEGIN:
 
+    // the budget is checked before the node is expanded, so a paused search starts again right here
+    // with the state, build order and stack exactly as they are now
+    if (isOutOfBudget())
+    {
+        return false;
+    }
+
     _results.nodesExpanded++;
+    BOSS_STATS(_results.stats.addNode(_rootDepth + _depth));
 
-    if (isTimeOut())
+    // skip this state if an equal or better one has already been searched
+    if (_params.useTranspositionTable && ((_rootDepth + _depth) > 0) && checkTranspositionTable(STATE))
     {
-        throw DFBB_TIMEOUT_EXCEPTION;
+        _results.transpositionHits++;
+        DFBB_CALL_RETURN;
     }
 
-    generateLegalActions(STATE, LEGAL_ACTINS);
+    generateLegalActions<race>(STATE, _buildOrder, LEGAL_ACTINS);
     for (CHILD_NUM = 0; CHILD_NUM < LEGAL_ACTINS.size(); ++CHILD_NUM)
     {
         ACTION_TYPE = LEGAL_ACTINS[CHILD_NUM];
 
-        actionFinishTime = STATE.whenCanPerform(ACTION_TYPE) + ACTION_TYPE.buildTime();
-        heuristicTime    = STATE.getCurrentFrame() + Tools::GetLowerBound(STATE, _params.goal);
+        actionFinishTime = BOSS_STATS_CALL(&_results.stats, StateCalls::WhenCanPerform, STATE.whenCanPerform<race>(ACTION_TYPE)) + ACTION_TYPE.buildTime();
+        heuristicTime    = STATE.getCurrentFrame() + _lowerBound.get(STATE);
         maxHeuristic     = (actionFinishTime > heuristicTime) ? actionFinishTime : heuristicTime;
 
-        if (maxHeuristic > _results.upperBound)
+        if (maxHeuristic > getUpperBound())
         {
+            BOSS_STATS(_results.stats.addPruned(PruneReasons::UpperBound));
             continue;
         }
 
+        BOSS_STATS(_results.stats.addChild(_rootDepth + _depth));
+
         REPETITIONS = getRepetitions(STATE, ACTION_TYPE);
         BOSS_ASSERT(REPETITIONS > 0, "Can't have zero repetitions!");
                 
         // do the action as many times as legal to to 'repeat'
-        CHILD_STATE = STATE;
         COMPLETED_REPS = 0;
         for (; COMPLETED_REPS < REPETITIONS; ++COMPLETED_REPS)
         {
-            if (CHILD_STATE.isLegal(ACTION_TYPE))
+            if (BOSS_STATS_CALL(&_results.stats, StateCalls::IsLegal, STATE.isLegal<race>(ACTION_TYPE)))
             {
-                _buildOrder.add(ACTION_TYPE);
-                CHILD_STATE.doAction(ACTION_TYPE);
+                doAction<race>(ACTION_TYPE);
+                BOSS_STATS(if (COMPLETED_REPS > 0) _results.stats.addPruned(PruneReasons::Repetitions));
             }
             else
             {
@@ -254,9 +520,9 @@ SEARCH_BEGIN:
             }
         }
 
-        if (_params.goal.isAchievedBy(CHILD_STATE))
+        if (_params.goal.isAchievedBy(STATE))
         {
-            updateResults(CHILD_STATE);
+            updateResults(STATE);
         }
         else
         {
@@ -267,7 +533,7 @@ SEARCH_RETURN:
 
         for (size_t r(0); r < COMPLETED_REPS; ++r)
         {
-            _buildOrder.pop_back();
+            undoAction();
         }
     }
 
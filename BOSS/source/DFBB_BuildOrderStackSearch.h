@@ -7,18 +7,20 @@
 #include "Timer.hpp"
 #include "Tools.h"
 #include "BuildOrder.h"
-
-#define DFBB_TIMEOUT_EXCEPTION 1
+#include "DFBB_TranspositionTable.h"
+#include "DFBB_LowerBound.h"
 
 namespace BOSS
 {
 
+class DFBB_ParallelSearchData;
+class DFBB_SearchTask;
+
 class StackData
 {
 public:
 
     size_t              currentChildIndex;
-    GameState           state;
     ActionSet           legalActions;
     ActionType          currentActionType;
     UnitCountType       repetitionValue;
@@ -35,37 +37,73 @@ public:
 
 class DFBB_BuildOrderStackSearch
 {
+    typedef bool (DFBB_BuildOrderStackSearch::*SearchFunction)();
+
 	DFBB_BuildOrderSearchParameters     _params;                      //parameters that will be used in this search
 	DFBB_BuildOrderSearchResults        _results;                     //the results of the search so far
 					
     Timer                               _searchTimer;
     BuildOrder                          _buildOrder;
 
+    // the search does and undoes actions on a single state, keeping an undo record for each action in the build order
+    GameState                           _state;
+    std::vector<GameStateUndo>          _undo;
+
     std::vector<StackData>              _stack;
     size_t                              _depth;
 
+    DFBB_TranspositionTable             _transpositionTable;
+    DFBB_LowerBound                     _lowerBound;
+
+    DFBB_ParallelSearchData *           _shared;                      // set when this is a worker of a parallel search
+    size_t                              _taskIndex;
+    size_t                              _rootDepth;
+
+    DFBB_SearchBudget                   _budget;
+    unsigned long long                  _budgetStartNodes;
+
     bool                                _firstSearch;
 
     bool                                _wasInterrupted;
+
+    SearchFunction                      _searchFunction;              // DFBB for the race of the initial state, picked once on construction
     
     void                                updateResults(const GameState & state);
-    bool                                isTimeOut();
+    bool                                isOutOfBudget();
+    int                                 getUpperBound() const;
+    bool                                checkTranspositionTable(const GameState & state);
     void                                calculateRecursivePrerequisites(const ActionType & action, ActionSet & all);
-    void                                generateLegalActions(const GameState & state, ActionSet & legalActions);
+    void                                generateLegalActions(const GameState & state, const BuildOrder & buildOrder, ActionSet & legalActions);
+    template <RaceID race> void         generateLegalActions(const GameState & state, const BuildOrder & buildOrder, ActionSet & legalActions);
+    bool                                isOnSeedPath(const BuildOrder & buildOrder) const;
 	std::vector<ActionType>             getBuildOrder(GameState & state);
     UnitCountType                       getRepetitions(const GameState & state, const ActionType & a);
+    template <RaceID race> void         doAction(const ActionType & action);
+    void                                undoAction();
     ActionSet                           calculateRelevantActions();
 
+    template <RaceID race> bool         DFBB();
+    static SearchFunction               GetSearchFunction(const RaceID race);
+
 public:
 	
 	DFBB_BuildOrderStackSearch(const DFBB_BuildOrderSearchParameters & p);
 	
     void setTimeLimit(double ms);
 	void search();
+    bool search(const DFBB_SearchBudget & budget);
     const DFBB_BuildOrderSearchResults & getResults() const;
+
+    // used by DFBB_BuildOrderParallelSearch to split the search and to search the resulting tasks
+    void setSharedData(DFBB_ParallelSearchData * shared);
+    void setBudget(const DFBB_SearchBudget & budget);
+    void setTask(const DFBB_SearchTask & task);
+    bool searchTask();
+    void expandTask(const DFBB_SearchTask & task, std::vector<DFBB_SearchTask> & children);
 	
-	void DFBB();
-	
-	
+	bool DFBB();
+
+    static ActionMask GetLegalActions(const DFBB_BuildOrderSearchParameters & params, const GameState & state, DFBB_SearchStats * stats = nullptr);
+    template <RaceID race> static ActionMask GetLegalActions(const DFBB_BuildOrderSearchParameters & params, const GameState & state, DFBB_SearchStats * stats = nullptr);
 };
 }
\ No newline at end of file
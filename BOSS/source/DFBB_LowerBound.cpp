@@ -0,0 +1,303 @@
+#include "DFBB_LowerBound.h"
+#include "ActionTypeTable.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace BOSS;
+
+// larger than any real frame, but small enough to add to the current frame
+const FrameCountType DFBB_LowerBound::Unreachable = std::numeric_limits<FrameCountType>::max() / 4;
+
+namespace
+{
+    // the table is cleared when it gets this big, a search normally needs a few thousand entries
+    const size_t MaxTableSize = 1 << 16;
+}
+
+DFBB_LowerBound::DFBB_LowerBound(const BuildOrderSearchGoal & goal)
+    : _goal(goal)
+    , _race(Races::None)
+    , _goalActions(0)
+    , _chainActions(0)
+    , _scannedActions(0)
+{
+
+}
+
+void DFBB_LowerBound::init(const RaceID race)
+{
+    const ActionTypeTable & table = ActionTypeTable::Get(race);
+
+    _race = race;
+    _goalActions = 0;
+    for (ActionID a(0); a < ActionTypes::GetAllActionTypes(race).size(); ++a)
+    {
+        if (_goal.getGoal(ActionTypes::GetActionType(race, a)) > 0)
+        {
+            _goalActions |= ActionMask::Bit(a);
+        }
+    }
+
+    // add prerequisites until there are no new ones
+    _chainActions = _goalActions;
+    ActionMaskType added = _goalActions;
+    while (added)
+    {
+        ActionMaskType prerequisites = 0;
+        ActionMask actions(added);
+        while (!actions.isEmpty())
+        {
+            prerequisites |= table.prerequisiteMask[actions.popFirst()];
+        }
+
+        added = prerequisites & ~_chainActions;
+        _chainActions |= added;
+    }
+
+    _scannedActions = _chainActions;
+    if (race == Races::Zerg)
+    {
+        _scannedActions |= ActionMask::Bit(ActionTypes::GetActionType("Zerg_Lair"));
+        _scannedActions |= ActionMask::Bit(ActionTypes::GetActionType("Zerg_Hive"));
+        _scannedActions |= ActionMask::Bit(ActionTypes::GetActionType("Zerg_Greater_Spire"));
+    }
+}
+
+size_t DFBB_LowerBound::size() const
+{
+    return _table.size();
+}
+
+FrameCountType DFBB_LowerBound::get(const GameState & state)
+{
+    static const ActionMaskType Hatchery      = ActionMask::Bit(ActionTypes::GetActionType("Zerg_Hatchery"));
+    static const ActionMaskType Lair          = ActionMask::Bit(ActionTypes::GetActionType("Zerg_Lair"));
+    static const ActionMaskType Hive          = ActionMask::Bit(ActionTypes::GetActionType("Zerg_Hive"));
+    static const ActionMaskType Spire         = ActionMask::Bit(ActionTypes::GetActionType("Zerg_Spire"));
+    static const ActionMaskType GreaterSpire  = ActionMask::Bit(ActionTypes::GetActionType("Zerg_Greater_Spire"));
+
+    const RaceID race = state.getRace();
+    const UnitData & units = state.getUnitData();
+    const ActionTypeTable & table = ActionTypeTable::Get(race);
+
+    if (race != _race)
+    {
+        init(race);
+    }
+
+    LowerBoundKey key = { 0, 0, 0 };
+    ResourceCountType minerals = 0;
+    ResourceCountType gas = 0;
+
+    // nothing outside the prerequisites of the goal changes the bound
+    ActionMask scanned(_scannedActions);
+    while (!scanned.isEmpty())
+    {
+        const ActionID a = scanned.popFirst();
+        const ActionType & actionType = ActionTypes::GetActionType(race, a);
+
+        if (units.getNumCompleted(actionType) > 0)
+        {
+            key.completed |= ActionMask::Bit(a);
+        }
+        else if (units.getNumInProgress(actionType) > 0)
+        {
+            key.inProgress |= ActionMask::Bit(a);
+        }
+
+        if (!(_goalActions & ActionMask::Bit(a)))
+        {
+            continue;
+        }
+
+        if (_goal.getGoal(actionType) > units.getNumTotal(actionType))
+        {
+            key.wanted |= ActionMask::Bit(a);
+        }
+
+        // the rest of the goal has to be paid for, a pair of zerglings costing the same as one
+        const UnitCountType remaining = _goal.getNumRemaining(state, actionType);
+        if (remaining > 0)
+        {
+            const int numActions = (remaining + table.numProduced[a] - 1) / table.numProduced[a];
+            minerals += numActions * table.mineralPrice[a];
+            gas      += numActions * table.gasPrice[a];
+        }
+    }
+
+    // a zerg building that was morphed has to have had the building it came from
+    if (race == Races::Zerg)
+    {
+        const ActionMaskType have = key.completed | key.inProgress;
+        const ActionMaskType morphedFrom = ((have & (Lair | Hive)) ? Hatchery : 0) | ((have & Hive) ? Lair : 0) | ((have & GreaterSpire) ? Spire : 0);
+
+        key.completed  |= morphedFrom;
+        key.inProgress &= ~morphedFrom;
+    }
+
+    key.completed  &= _chainActions;
+    key.inProgress &= _chainActions;
+
+    const LowerBoundEntry & entry = getEntry(race, key);
+
+    FrameCountType criticalPath = entry.criticalPath;
+    for (size_t i(0); i < entry.inProgressPaths.size(); ++i)
+    {
+        const ActionType & actionType = ActionTypes::GetActionType(race, entry.inProgressPaths[i].first);
+        const FrameCountType time = entry.inProgressPaths[i].second + units.getFinishTime(actionType) - state.getCurrentFrame();
+
+        criticalPath = std::max(criticalPath, time);
+    }
+
+    const FrameCountType resourceBound = getResourceBound(state, minerals + entry.prerequisiteMinerals, gas + entry.prerequisiteGas);
+
+    return std::max(criticalPath, resourceBound);
+}
+
+// the fewest frames to gather the resources, if we were already mining with every worker the goal allows
+// gas workers only come from refineries, three each, so the refineries the goal allows bound them
+FrameCountType DFBB_LowerBound::getResourceBound(const GameState & state, ResourceCountType minerals, ResourceCountType gas) const
+{
+    const UnitData & units = state.getUnitData();
+    const ActionType & worker = ActionTypes::GetWorker(state.getRace());
+    const ActionType & refinery = ActionTypes::GetRefinery(state.getRace());
+
+    minerals -= state.getMinerals();
+    gas -= state.getGas();
+
+    FrameCountType bound = 0;
+
+    // the workers we have or are making could all be mining now, the rest can't start before one worker build time has passed
+    if (minerals > 0)
+    {
+        const int workers = std::max((int)units.getNumTotal(worker), (int)(units.getNumMineralWorkers() + units.getNumGasWorkers() + units.getNumBuildingWorkers()));
+        const int maxWorkers = std::max({ workers, (int)_goal.getGoal(worker), (int)_goal.getGoalMax(worker) });
+        const ResourceCountType perFrame = workers * (ResourceCountType)Constants::MPWPF;
+        const ResourceCountType maxPerFrame = maxWorkers * (ResourceCountType)Constants::MPWPF;
+        const FrameCountType workerTime = worker.buildTime();
+
+        if (maxPerFrame == 0)
+        {
+            return Unreachable;
+        }
+        else if (minerals <= perFrame * workerTime)
+        {
+            bound = (minerals + perFrame - 1) / perFrame;
+        }
+        else
+        {
+            // minerals <= perFrame * t + (maxPerFrame - perFrame) * (t - workerTime)
+            const ResourceCountType later = (maxPerFrame - perFrame) * workerTime;
+            bound = (minerals + later + maxPerFrame - 1) / maxPerFrame;
+        }
+    }
+
+    if (gas > 0)
+    {
+        const int maxRefineries = std::max({ (int)units.getNumTotal(refinery), (int)_goal.getGoal(refinery), (int)_goal.getGoalMax(refinery) });
+        const int maxGasWorkers = units.getNumGasWorkers() + 3 * std::max(0, maxRefineries - (int)units.getNumCompleted(refinery));
+        const ResourceCountType perFrame = maxGasWorkers * (ResourceCountType)Constants::GPWPF;
+
+        bound = std::max(bound, perFrame > 0 ? (gas + perFrame - 1) / perFrame : Unreachable);
+    }
+
+    return bound;
+}
+
+const LowerBoundEntry & DFBB_LowerBound::getEntry(const RaceID race, const LowerBoundKey & key)
+{
+    auto it = _table.find(key);
+    if (it != _table.end())
+    {
+        return it->second;
+    }
+
+    if (_table.size() >= MaxTableSize)
+    {
+        _table.clear();
+    }
+
+    LowerBoundEntry & entry = _table[key];
+    const ActionTypeTable & table = ActionTypeTable::Get(race);
+
+    FrameCountType longest[Constants::MAX_ACTIONS];
+    FrameCountType inProgressPaths[Constants::MAX_ACTIONS];
+    std::fill(longest, longest + Constants::MAX_ACTIONS, -1);
+    std::fill(inProgressPaths, inProgressPaths + Constants::MAX_ACTIONS, -1);
+    ActionMaskType missing = 0;
+
+    ActionMask wanted(key.wanted);
+    while (!wanted.isEmpty())
+    {
+        addChains(race, key, wanted.popFirst(), 0, longest, inProgressPaths, missing, entry);
+    }
+
+    ActionMask inProgress(key.inProgress);
+    while (!inProgress.isEmpty())
+    {
+        const ActionID a = inProgress.popFirst();
+        if (inProgressPaths[a] >= 0)
+        {
+            entry.inProgressPaths.push_back(std::make_pair(a, inProgressPaths[a]));
+        }
+    }
+
+    // each missing prerequisite has to be built at least once, the ones in the goal were paid for with the goal
+    ActionMask missingPrerequisites(missing);
+    while (!missingPrerequisites.isEmpty())
+    {
+        const ActionID a = missingPrerequisites.popFirst();
+        if (_goal.getGoal(ActionTypes::GetActionType(race, a)) == 0)
+        {
+            entry.prerequisiteMinerals += table.mineralPrice[a];
+            entry.prerequisiteGas      += table.gasPrice[a];
+        }
+    }
+
+    return entry;
+}
+
+// follows every prerequisite chain down from the action, as Tools::CalculatePrerequisitesLowerBound does
+// chains end at an action we have, at one in progress, whose finish time is added per state, or at one with no prerequisites
+// longest holds the longest time each action has been reached with, a chain reaching it again with no more time can't be longer
+void DFBB_LowerBound::addChains(const RaceID race, const LowerBoundKey & key, const ActionID action, const FrameCountType timeSoFar,
+                                FrameCountType * longest, FrameCountType * inProgressPaths, ActionMaskType & missing, LowerBoundEntry & entry) const
+{
+    const ActionMaskType bit = ActionMask::Bit(action);
+
+    if (key.completed & bit)
+    {
+        entry.criticalPath = std::max(entry.criticalPath, timeSoFar);
+        return;
+    }
+
+    if (key.inProgress & bit)
+    {
+        inProgressPaths[action] = std::max(inProgressPaths[action], timeSoFar);
+        return;
+    }
+
+    if (timeSoFar <= longest[action])
+    {
+        return;
+    }
+
+    longest[action] = timeSoFar;
+    missing |= bit;
+
+    const ActionTypeTable & table = ActionTypeTable::Get(race);
+    const FrameCountType time = timeSoFar + table.buildTime[action];
+
+    ActionMask prerequisites(table.prerequisiteMask[action]);
+    if (prerequisites.isEmpty())
+    {
+        entry.criticalPath = std::max(entry.criticalPath, time);
+        return;
+    }
+
+    while (!prerequisites.isEmpty())
+    {
+        addChains(race, key, prerequisites.popFirst(), time, longest, inProgressPaths, missing, entry);
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "BuildOrderSearchGoal.h"
+#include "ActionMask.h"
+
+#include <unordered_map>
+
+namespace BOSS
+{
+
+class LowerBoundKey
+{
+public:
+
+    ActionMaskType      wanted;         // goal actions we don't have enough of
+    ActionMaskType      completed;      // actions with at least one completed, zerg morphs counting as what they came from
+    ActionMaskType      inProgress;     // actions with some in progress and none completed
+
+    bool operator == (const LowerBoundKey & rhs) const
+    {
+        return (wanted == rhs.wanted) && (completed == rhs.completed) && (inProgress == rhs.inProgress);
+    }
+};
+
+class LowerBoundKeyHash
+{
+public:
+
+    size_t operator () (const LowerBoundKey & key) const
+    {
+        return (size_t)((key.wanted * 0x9E3779B97F4A7C15ull) ^ (key.completed * 0xC2B2AE3D27D4EB4Full) ^ (key.inProgress * 0x165667B19E3779F9ull));
+    }
+};
+
+// the part of the bound which only depends on which actions we have, stored once per set of masks
+class LowerBoundEntry
+{
+public:
+
+    FrameCountType                                  criticalPath;           // longest prerequisite chain ending at an action we have
+    std::vector< std::pair<ActionID, FrameCountType> > inProgressPaths;     // longest chain ending at each action in progress, which still needs its finish time added
+    ResourceCountType                               prerequisiteMinerals;   // cost of the prerequisites we have none of and which aren't in the goal
+    ResourceCountType                               prerequisiteGas;
+
+    LowerBoundEntry()
+        : criticalPath(0)
+        , prerequisiteMinerals(0)
+        , prerequisiteGas(0)
+    {
+
+    }
+};
+
+// an admissible lower bound on the frames from a state until the goal is reached, for one search goal
+// it is the larger of two bounds:
+//   the longest chain of prerequisites still to be built, the same chain Tools::GetLowerBound follows
+//   the frames needed to gather the resources for the rest of the goal and its missing prerequisites
+//      if every worker the goal allows were already mining
+// the chains only depend on which actions the state has, so they are worked out once for each set of
+// masks and looked up after that. the resource bound assumes the search never builds more workers or
+// refineries than the goal and its maximums allow, which is true of every search using the goal
+class DFBB_LowerBound
+{
+    BuildOrderSearchGoal                                                _goal;
+    std::unordered_map<LowerBoundKey, LowerBoundEntry, LowerBoundKeyHash> _table;
+
+    RaceID                      _race;              // set by the first state, along with the masks below
+    ActionMaskType              _goalActions;       // the actions with a goal count
+    ActionMaskType              _chainActions;      // the goal actions and all their prerequisites, the only ones the chains can reach
+    ActionMaskType              _scannedActions;    // the chain actions and the zerg buildings that count as some of them
+
+    void                        init(const RaceID race);
+    const LowerBoundEntry &     getEntry(const RaceID race, const LowerBoundKey & key);
+    void                        addChains(const RaceID race, const LowerBoundKey & key, const ActionID action, const FrameCountType timeSoFar,
+                                          FrameCountType * longest, FrameCountType * inProgressPaths, ActionMaskType & missing, LowerBoundEntry & entry) const;
+    FrameCountType              getResourceBound(const GameState & state, ResourceCountType minerals, ResourceCountType gas) const;
+
+public:
+
+    static const FrameCountType Unreachable;
+
+    DFBB_LowerBound(const BuildOrderSearchGoal & goal = BuildOrderSearchGoal());
+
+    // frames after the state's current frame, like Tools::GetLowerBound
+    FrameCountType              get(const GameState & state);
+
+    size_t                      size() const;
+};
+
+}
@@ -0,0 +1,145 @@
+#include "DFBB_SearchStats.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace BOSS;
+
+namespace
+{
+    const char * PruneReasonNames[PruneReasons::NumPruneReasons] = { "GoalMax", "SupplyBounding", "AlwaysMakeWorkers", "UpperBound", "Repetitions" };
+    const char * StateCallNames[StateCalls::NumStateCalls] = { "IsLegal", "WhenCanPerform", "DoAction" };
+}
+
+DFBB_SearchStats::DFBB_SearchStats()
+{
+    std::fill(pruned, pruned + PruneReasons::NumPruneReasons, 0);
+    std::fill(calls, calls + StateCalls::NumStateCalls, 0);
+    std::fill(callTime, callTime + StateCalls::NumStateCalls, 0.0);
+}
+
+bool DFBB_SearchStats::IsEnabled()
+{
+#ifdef BOSS_SEARCH_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void DFBB_SearchStats::addNode(const size_t depth)
+{
+    if (nodesPerDepth.size() <= depth)
+    {
+        nodesPerDepth.resize(depth + 1, 0);
+        childrenPerDepth.resize(depth + 1, 0);
+    }
+
+    nodesPerDepth[depth]++;
+}
+
+// a child is always added from a node at the same depth, so the vectors are already big enough
+void DFBB_SearchStats::addChild(const size_t depth)
+{
+    childrenPerDepth[depth]++;
+}
+
+void DFBB_SearchStats::addPruned(const PruneReasons::PruneReason reason, const unsigned long long count)
+{
+    pruned[reason] += count;
+}
+
+void DFBB_SearchStats::addCall(const StateCalls::StateCall call, const double ms)
+{
+    calls[call]++;
+    callTime[call] += ms;
+}
+
+// adds the stats of another search, such as a worker of the parallel search or an earlier milestone
+void DFBB_SearchStats::add(const DFBB_SearchStats & other)
+{
+    if (nodesPerDepth.size() < other.nodesPerDepth.size())
+    {
+        nodesPerDepth.resize(other.nodesPerDepth.size(), 0);
+        childrenPerDepth.resize(other.nodesPerDepth.size(), 0);
+    }
+
+    for (size_t d(0); d < other.nodesPerDepth.size(); ++d)
+    {
+        nodesPerDepth[d] += other.nodesPerDepth[d];
+        childrenPerDepth[d] += other.childrenPerDepth[d];
+    }
+
+    for (size_t r(0); r < PruneReasons::NumPruneReasons; ++r)
+    {
+        pruned[r] += other.pruned[r];
+    }
+
+    for (size_t c(0); c < StateCalls::NumStateCalls; ++c)
+    {
+        calls[c] += other.calls[c];
+        callTime[c] += other.callTime[c];
+    }
+}
+
+double DFBB_SearchStats::getBranchingFactor(const size_t depth) const
+{
+    if ((depth >= nodesPerDepth.size()) || (nodesPerDepth[depth] == 0))
+    {
+        return 0;
+    }
+
+    return (double)childrenPerDepth[depth] / (double)nodesPerDepth[depth];
+}
+
+double DFBB_SearchStats::getEffectiveBranchingFactor() const
+{
+    unsigned long long nodes = 0;
+    unsigned long long children = 0;
+
+    for (size_t d(0); d < nodesPerDepth.size(); ++d)
+    {
+        nodes += nodesPerDepth[d];
+        children += childrenPerDepth[d];
+    }
+
+    return nodes ? (double)children / (double)nodes : 0;
+}
+
+std::string DFBB_SearchStats::getJSONString() const
+{
+    std::stringstream ss;
+
+    unsigned long long nodes = 0;
+    for (size_t d(0); d < nodesPerDepth.size(); ++d)
+    {
+        nodes += nodesPerDepth[d];
+    }
+
+    ss << "{\"Enabled\" : " << (IsEnabled() ? "true" : "false");
+    ss << ", \"Nodes\" : " << nodes;
+    ss << ", \"EffectiveBranchingFactor\" : " << getEffectiveBranchingFactor();
+
+    ss << ", \"Depths\" : [";
+    for (size_t d(0); d < nodesPerDepth.size(); ++d)
+    {
+        ss << (d > 0 ? ", " : "") << "{\"Nodes\" : " << nodesPerDepth[d] << ", \"Children\" : " << childrenPerDepth[d] << ", \"BranchingFactor\" : " << getBranchingFactor(d) << "}";
+    }
+    ss << "]";
+
+    ss << ", \"Pruned\" : {";
+    for (size_t r(0); r < PruneReasons::NumPruneReasons; ++r)
+    {
+        ss << (r > 0 ? ", " : "") << "\"" << PruneReasonNames[r] << "\" : " << pruned[r];
+    }
+    ss << "}";
+
+    ss << ", \"StateCalls\" : {";
+    for (size_t c(0); c < StateCalls::NumStateCalls; ++c)
+    {
+        ss << (c > 0 ? ", " : "") << "\"" << StateCallNames[c] << "\" : {\"Calls\" : " << calls[c] << ", \"TimeMS\" : " << callTime[c] << "}";
+    }
+    ss << "}}";
+
+    return ss.str();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Common.h"
+
+#include <chrono>
+
+// search instrumentation, off by default since timing every call to the state slows the search down
+// define BOSS_SEARCH_STATS here or for the whole build to fill in the stats of DFBB_BuildOrderSearchResults
+//#define BOSS_SEARCH_STATS
+
+// BOSS_STATS_CALL times a call to the state for stats, a DFBB_SearchStats pointer which may be null
+// BOSS_STATS_PARAM names a parameter only the stats use, which is left unnamed when they are off so it isn't unused
+#ifdef BOSS_SEARCH_STATS
+    #define BOSS_STATS(statement) statement
+    #define BOSS_STATS_CALL(stats, call, expression) (BOSS::StateCallTimer((stats), (call)), (expression))
+    #define BOSS_STATS_PARAM(name) name
+#else
+    #define BOSS_STATS(statement)
+    #define BOSS_STATS_CALL(stats, call, expression) (expression)
+    #define BOSS_STATS_PARAM(name)
+#endif
+
+namespace BOSS
+{
+
+// why a child of a node was not searched
+//   GoalMax:           we already have the goal or goal max of the action
+//   SupplyBounding:    a supply provider while we have enough supply
+//   AlwaysMakeWorkers: an action which can't start before the next worker
+//   UpperBound:        the action or the lower bound finishes after the best build order so far
+//   Repetitions:       the states skipped by doing an action several times in a row
+namespace PruneReasons
+{
+    enum PruneReason { GoalMax, SupplyBounding, AlwaysMakeWorkers, UpperBound, Repetitions, NumPruneReasons };
+}
+
+// the GameState calls the search spends most of its time in
+namespace StateCalls
+{
+    enum StateCall { IsLegal, WhenCanPerform, DoAction, NumStateCalls };
+}
+
+class DFBB_SearchStats
+{
+public:
+
+    std::vector<unsigned long long>     nodesPerDepth;      // nodes expanded at each depth of the build order
+    std::vector<unsigned long long>     childrenPerDepth;   // children searched from the nodes at each depth
+    unsigned long long                  pruned[PruneReasons::NumPruneReasons];
+    unsigned long long                  calls[StateCalls::NumStateCalls];
+    double                              callTime[StateCalls::NumStateCalls];    // milliseconds
+
+    DFBB_SearchStats();
+
+    void                addNode(const size_t depth);
+    void                addChild(const size_t depth);
+    void                addPruned(const PruneReasons::PruneReason reason, const unsigned long long count = 1);
+    void                addCall(const StateCalls::StateCall call, const double ms);
+    void                add(const DFBB_SearchStats & other);
+
+    // children searched per node expanded at the depth, and over the whole search
+    double              getBranchingFactor(const size_t depth) const;
+    double              getEffectiveBranchingFactor() const;
+
+    std::string         getJSONString() const;
+
+    static bool         IsEnabled();
+};
+
+// adds the time from its construction to its destruction to one of the state calls, if it has stats to add to
+class StateCallTimer
+{
+    DFBB_SearchStats *                      _stats;
+    StateCalls::StateCall                   _call;
+    std::chrono::steady_clock::time_point   _start;
+
+public:
+
+    StateCallTimer(DFBB_SearchStats * stats, const StateCalls::StateCall call)
+        : _stats(stats)
+        , _call(call)
+    {
+        if (_stats)
+        {
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~StateCallTimer()
+    {
+        if (_stats)
+        {
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - _start;
+            _stats->addCall(_call, elapsed.count());
+        }
+    }
+};
+
+}
@@ -0,0 +1,111 @@
+#include "DFBB_TranspositionTable.h"
+
+using namespace BOSS;
+
+DFBB_TranspositionTable::DFBB_TranspositionTable()
+    : _mask(0)
+{
+
+}
+
+void DFBB_TranspositionTable::init(const size_t size)
+{
+    BOSS_ASSERT(size >= 2, "Transposition table needs at least one bucket: %d", (int)size);
+
+    size_t entries = 2;
+    while (entries * 2 <= size)
+    {
+        entries *= 2;
+    }
+
+    _table = std::vector<TranspositionTableEntry>(entries);
+    _mask = (entries / 2) - 1;
+}
+
+void DFBB_TranspositionTable::clear()
+{
+    std::fill(_table.begin(), _table.end(), TranspositionTableEntry());
+}
+
+bool DFBB_TranspositionTable::isInitialized() const
+{
+    return !_table.empty();
+}
+
+size_t DFBB_TranspositionTable::getBucketIndex(const HashValues & hash) const
+{
+    return (size_t)(hash.getValue(0) & _mask);
+}
+
+TranspositionTableEntry * DFBB_TranspositionTable::getBucket(const HashValues & hash)
+{
+    return &_table[2 * getBucketIndex(hash)];
+}
+
+const TranspositionTableEntry * DFBB_TranspositionTable::getBucket(const HashValues & hash) const
+{
+    return &_table[2 * getBucketIndex(hash)];
+}
+
+// the states have identical hashes, so they have the same units, worker assignments and actions in progress
+// and therefore the same income until the later frame, since no action in progress can finish in between
+bool DFBB_TranspositionTable::dominates(const TranspositionTableEntry & entry, const GameState & state) const
+{
+    if (entry.frame > state.getCurrentFrame())
+    {
+        return false;
+    }
+
+    const FrameCountType elapsed = state.getCurrentFrame() - entry.frame;
+
+    return (entry.minerals + (ResourceCountType)(elapsed * state.getMineralsPerFrame()) >= state.getMinerals())
+        && (entry.gas + (ResourceCountType)(elapsed * state.getGasPerFrame()) >= state.getGas());
+}
+
+bool DFBB_TranspositionTable::isDominated(const GameState & state, const HashValues & hash, const size_t task) const
+{
+    const TranspositionTableEntry * bucket = getBucket(hash);
+    const HashType verify = hash.getValue(1);
+
+    for (size_t i(0); i < 2; ++i)
+    {
+        if (bucket[i].valid && (bucket[i].verify == verify) && (bucket[i].task <= task) && dominates(bucket[i], state))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void DFBB_TranspositionTable::store(const GameState & state, const HashValues & hash, const size_t depth, const size_t task)
+{
+    TranspositionTableEntry * bucket = getBucket(hash);
+    TranspositionTableEntry & depthEntry = bucket[0];
+    TranspositionTableEntry & newestEntry = bucket[1];
+
+    TranspositionTableEntry entry;
+    entry.verify    = hash.getValue(1);
+    entry.frame     = state.getCurrentFrame();
+    entry.minerals  = state.getMinerals();
+    entry.gas       = state.getGas();
+    entry.depth     = (unsigned short)depth;
+    entry.task      = (unsigned int)task;
+    entry.valid     = true;
+
+    // the depth preferred slot keeps the state with the largest subtree, or the same state at an earlier frame
+    if (!depthEntry.valid || (depth <= depthEntry.depth) || ((depthEntry.verify == entry.verify) && (entry.frame <= depthEntry.frame)))
+    {
+        // the replaced entry is still useful, so move it to the always replace slot
+        if (depthEntry.valid && (depthEntry.verify != entry.verify))
+        {
+            newestEntry = depthEntry;
+        }
+
+        depthEntry = entry;
+    }
+    else
+    {
+        newestEntry = entry;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "Hash.h"
+
+namespace BOSS
+{
+
+class TranspositionTableEntry
+{
+public:
+
+    HashType            verify;         // second hash value, used to detect index collisions
+    FrameCountType      frame;          // frame of the stored state
+    ResourceCountType   minerals;       // minerals of the stored state
+    ResourceCountType   gas;            // gas of the stored state
+    unsigned short      depth;          // search depth the state was stored at
+    unsigned int        task;           // parallel search task which stored the state
+    bool                valid;
+
+    TranspositionTableEntry()
+        : verify(0)
+        , frame(0)
+        , minerals(0)
+        , gas(0)
+        , depth(0)
+        , task(0)
+        , valid(false)
+    {
+
+    }
+};
+
+// a fixed size table of previously expanded DFBB states, indexed by GameState hash
+// each bucket holds two entries: one which is only replaced by shallower (larger subtree) states
+// and one which is always replaced, so the table keeps working once the depth slots fill up
+// the table itself is not synchronized, the parallel search locks buckets with getBucketIndex
+class DFBB_TranspositionTable
+{
+    std::vector<TranspositionTableEntry>    _table;
+    size_t                                  _mask;
+
+    TranspositionTableEntry *               getBucket(const HashValues & hash);
+    const TranspositionTableEntry *         getBucket(const HashValues & hash) const;
+    bool                                    dominates(const TranspositionTableEntry & entry, const GameState & state) const;
+
+public:
+
+    DFBB_TranspositionTable();
+
+    // size is the number of entries, rounded down to a power of two
+    void                                    init(const size_t size);
+    void                                    clear();
+    bool                                    isInitialized() const;
+
+    size_t                                  getBucketIndex(const HashValues & hash) const;
+
+    // returns true if an equal or better state was already stored at an earlier or equal frame
+    // only states stored by the same or an earlier task count, which keeps parallel search results
+    // identical to the sequential search where tasks are searched in order
+    bool                                    isDominated(const GameState & state, const HashValues & hash, const size_t task = 0) const;
+    void                                    store(const GameState & state, const HashValues & hash, const size_t depth, const size_t task = 0);
+};
+
+}
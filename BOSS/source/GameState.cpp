@@ -14,199 +14,44 @@ GameState::GameState(const RaceID r)
     
 }
 
-#ifdef _MSC_VER
-GameState::GameState(BWAPI::GameWrapper & game, BWAPI::PlayerInterface * self, const std::vector<BWAPI::UnitType> & buildingsQueued)
-    : _race                 (Races::GetRaceID(self->getRace()))
-    , _currentFrame         (game->getFrameCount())
+// the same calls on the unit data, in the same order, as when the recipe was made
+GameState::GameState(const GameStateRecipe & recipe)
+    : _race                 (recipe.race)
+    , _currentFrame         (recipe.frame)
     , _lastActionFrame      (0)
-    , _units                (Races::GetRaceID(self->getRace()))
-    , _minerals             (self->minerals() * Constants::RESOURCE_SCALE)
-    , _gas                  (self->gas() * Constants::RESOURCE_SCALE)
-{ 
-    // we will count the worker jobs as we add units
-    UnitCountType mineralWorkerCount    = 0;
-    UnitCountType gasWorkerCount        = 0;
-    UnitCountType buildingWorkerCount   = 0;
-    UnitCountType larvaCount            = 0;
-
-    _units.setMineralWorkers(mineralWorkerCount);
-    _units.setGasWorkers(gasWorkerCount);
-    _units.setBuildingWorkers(buildingWorkerCount);
-
-    // add buildings queued like they had just been started
-    for (const BWAPI::UnitType & type : buildingsQueued)
+    , _units                (recipe.race)
+    , _minerals             (recipe.minerals)
+    , _gas                  (recipe.gas)
+{
+    for (const GameStateRecipeStep & step : recipe.steps)
     {
-        _units.addActionInProgress(ActionType(type), game->getFrameCount() + type.buildTime(), false);
-    }
-
-	// add each unit we have to the current state
-	for (BWAPI::UnitInterface * unit : self->getUnits())
-	{
-        // if the unit is an egg then we're building a zerg unit, add it with the finish time
-        if (unit->getType() == BWAPI::UnitTypes::Zerg_Egg)
+        switch (step.type)
         {
-            _units.addActionInProgress(ActionType(unit->getBuildType()), game->getFrameCount() + unit->getRemainingBuildTime(), false);
-            continue;
+            case GameStateRecipeStep::ActionInProgress:
+                _units.addActionInProgress(step.action, step.time, false);
+                break;
+
+            case GameStateRecipeStep::CompletedBuilding:
+                _units.addCompletedBuilding(step.action, step.time, step.constructing, step.addon, step.numLarva);
+                break;
+
+            case GameStateRecipeStep::CompletedUnit:
+                _units.addCompletedAction(step.action, false);
+                _units.setCurrentSupply(_units.getCurrentSupply() + step.action.supplyRequired());
+                break;
+
+            case GameStateRecipeStep::CompletedAction:
+                _units.addCompletedAction(step.action);
+                break;
         }
+    }
+}
 
-		if (unit->getType() == BWAPI::UnitTypes::Zerg_Larva)
-		{
-			++larvaCount;
-			continue;
-		}
-
-        // don't add any units that we don't have any the action space, this should never happen though
-		if (!ActionTypes::TypeExists(unit->getType()))
-		{
-			continue;
-		}
-
-        ActionType actionType(unit->getType());
-
-		// if the unit is completed
-		if (unit->isCompleted())
-		{
-			// if it is a building that is not an addon
-			if (unit->getType().isBuilding())
-			{
-                // add the building data accordingly
-				FrameCountType  trainTime = unit->getRemainingTrainTime() + unit->getRemainingResearchTime() + unit->getRemainingUpgradeTime();
-                ActionType      constructing;
-                ActionType      addon;
-                bool            isHatchery = unit->getType().isResourceDepot() && unit->getType().getRace() == BWAPI::Races::Zerg;
-
-                // if this is a hatchery subtract the training time which is just larva production time
-                if (isHatchery)
-                {
-                    trainTime -= unit->getRemainingTrainTime();
-                }
-                // if this unit is currently building an addon, set it
-                if (unit->getAddon() && unit->getAddon()->isBeingConstructed())
-                {
-                    constructing = ActionType(unit->getAddon()->getType());
-                } 
-                // if it's a non-hatchery currently training something, add it
-                else if (!isHatchery && unit->getRemainingTrainTime() > 0)
-                {
-                    // find the unit we have that has the same construction time remaining
-                    // this is an awful hack but there seems to be no alternative
-                    bool set = false;
-                    for (auto & u : self->getUnits())
-                    {
-                        if (u->getRemainingBuildTime() > 0 && u->getPosition().getDistance(unit->getPosition()) < 16)
-                        {
-                            constructing = ActionType(u->getType());
-                            set = true;
-                            break;
-                        }
-                    }
-
-                    // check to see if the last order issued was a trianing order and grab the unit type from that
-                    if (!set && unit->getLastCommand().getType() == BWAPI::UnitCommandTypes::Train)
-                    {
-                        BWAPI::UnitType trainType = unit->getLastCommand().getUnitType();
-
-                        if (BWAPI::Broodwar->getFrameCount() - unit->getLastCommandFrame() < 2*BWAPI::Broodwar->getLatencyFrames())
-                        {
-                            constructing = ActionType(trainType);
-                            set = true;
-
-                            // we now need to add this to units in progress, since it won't be detected below as an actual unit in progress
-                            _units.addActionInProgress(trainType, game->getFrameCount() + trainType.buildTime(), false);
-                        }
-                    }
-
-                    if (!set)
-                    {
-                        // if we couldn't find the unit type that this unit is training 
-                        // then we have to treat it as if it doesn't exist otherwise BOSS will act strangely
-                        trainTime = 0;
-                        BWAPI::Broodwar->printf("Couldn't find training unit for %s %s %d %d", unit->getType().getName().c_str(), unit->getBuildType().getName().c_str(), unit->getTrainingQueue().size(), unit->getRemainingTrainTime());
-                    }
-                }
-                // if it's researching something, add it
-				else if (unit->getRemainingResearchTime() > 0)
-				{
-					constructing = ActionType(unit->getTech());
-					_units.addActionInProgress(constructing, game->getFrameCount() + unit->getRemainingResearchTime(), false);
-				}
-                // if it's upgrading something, add it
-				else if (unit->getRemainingUpgradeTime() > 0)
-				{
-					constructing = ActionType(unit->getUpgrade());
-					_units.addActionInProgress(constructing, game->getFrameCount() + unit->getRemainingUpgradeTime(), false);
-				}
-
-                // add addons
-                if (unit->getAddon() != nullptr)
-                {
-                    if (unit->getAddon()->isConstructing())
-                    {
-                        constructing = ActionType(unit->getAddon()->getType());
-                    }
-                    else
-                    {
-                        addon = ActionType(unit->getAddon()->getType());    
-                    }
-                }
-
-                _units.addCompletedBuilding(actionType, trainTime, constructing, addon, unit->getLarva().size());
-			}
-            // otherwise it is a non-building unit
-            else
-            {
-                if (unit->getType() == BWAPI::UnitTypes::Terran_Siege_Tank_Siege_Mode)
-                {
-                    actionType = ActionType(BWAPI::UnitTypes::Terran_Siege_Tank_Tank_Mode);
-                }
-
-                // add the unit to the state
-			    _units.addCompletedAction(actionType, false);
-
-                // set the supply accordingly
-                _units.setCurrentSupply(_units.getCurrentSupply() + actionType.supplyRequired());
-            }
-		}
-        // the unit is currently under construction
-		else if ((unit->getRemainingBuildTime() > 0) && !unit->getType().isAddon())
-		{
-            // special case of a zerg building morphing into its upgrade
-            if (actionType.isBuilding() && actionType.isMorphed())
-            {
-                // add the completed building which is morphing into this building
-                _units.addCompletedBuilding(actionType.whatBuildsActionType(), unit->getRemainingBuildTime(), actionType, ActionType(), unit->getLarva().size());
-            }
-
-            // add the unit itself in progress
-			_units.addActionInProgress(actionType, game->getFrameCount() + unit->getRemainingBuildTime(), false);
-		}
-	}
+#ifdef _MSC_VER
+GameState::GameState(BWAPI::GameWrapper & game, BWAPI::PlayerInterface * self, const std::vector<BWAPI::UnitType> & buildingsQueued)
+    : GameState(GameStateRecipe(game, self, buildingsQueued))
+{
 
-    for (const BWAPI::UpgradeType & type : BWAPI::UpgradeTypes::allUpgradeTypes())
-	{
-        if (!ActionTypes::TypeExists(type))
-		{
-			continue;
-		}
-
-		if (self->getUpgradeLevel(type) > 0)
-		{
-			_units.addCompletedAction(ActionType(type));
-		}
-	}
-    
-    for (const BWAPI::TechType & type : BWAPI::TechTypes::allTechTypes())
-	{
-        if (!ActionTypes::TypeExists(type))
-		{
-			continue;
-		}
-
-		if (self->hasResearched(type))
-		{
-		    _units.addCompletedAction(ActionType(type));
-		}
-	}
 }
 #endif
 
@@ -227,6 +72,7 @@ void GameState::setStartingState()
     }
 
     _units.setCurrentSupply(8);
+    _resourceTimeline.invalidate();
 }
 
 const RaceID GameState::getRace() const
@@ -237,10 +83,18 @@ const RaceID GameState::getRace() const
 void GameState::getAllLegalActions(ActionSet & actions) const
 {
     const std::vector<ActionType> & allActions = ActionTypes::GetAllActionTypes(getRace());
+    const ActionMask have = _units.getPrerequisiteMask();
+
 	for (ActionID i(0); i<allActions.size(); ++i)
 	{
         const ActionType & action = allActions[i];
 
+        // most actions are ruled out by their prerequisites, which is checked for all of them with the same mask
+        if (action.hasSinglePrerequisites() && !have.containsAll(ActionMask(action.getPrerequisiteMask())))
+        {
+            continue;
+        }
+
         if (isLegal(action))
         {
             actions.add(action);
@@ -248,22 +102,36 @@ void GameState::getAllLegalActions(ActionSet & actions) const
     }   
 }
 
+bool GameState::isLegal(const ActionType & action) const
+{
+    BOSS_RACE_DISPATCH(_race, isLegal, action);
+    return false;
+}
+
+template <RaceID race>
 bool GameState::isLegal(const ActionType & action) const
 {
     const size_t mineralWorkers  = getNumMineralWorkers();
-    const size_t numRefineries  = _units.getNumTotal(ActionTypes::GetRefinery(getRace()));
-    const size_t numDepots      = _units.getNumTotal(ActionTypes::GetResourceDepot(getRace()));
-    const size_t refineriesInProgress = _units.getNumInProgress(ActionTypes::GetRefinery(getRace()));
+    const size_t numRefineries  = _units.getNumTotal(ActionTypes::GetRefinery(race));
+    const size_t numDepots      = _units.getNumTotal(ActionTypes::GetResourceDepot(race));
+    const size_t refineriesInProgress = _units.getNumInProgress(ActionTypes::GetRefinery(race));
 
     // we can never build a larva
     static const ActionType & Zerg_Larva = ActionTypes::GetActionType("Zerg_Larva");
-    if (action == Zerg_Larva)
+    if (RaceTraits<race>::usesLarva && (action == Zerg_Larva))
     {
         return false;
     }
 
-    // check if the tech requirements are met
-    if (!_units.hasPrerequisites(action.getPrerequisites()))
+    // check if the tech requirements are met, almost always with just the masks
+    if (action.hasSinglePrerequisites() ? !_units.getPrerequisiteMask<race>().containsAll(ActionMask(action.getPrerequisiteMask()))
+                                        : !_units.hasPrerequisites<race>(action.getPrerequisites()))
+    {
+        return false;
+    }
+
+    // a morphed building needs the building it morphs from, the hive counting as a hatchery for tech doesn't let it become a lair
+    if (RaceTraits<race>::hasMorphedPrerequisites && action.isMorphed() && action.whatBuildsIsBuilding() && (_units.getNumTotal(action.whatBuildsActionType()) == 0))
     {
         return false;
     }
@@ -285,9 +153,9 @@ bool GameState::isLegal(const ActionType & action) const
         }
 
         int workersPerRefinery = 3;
-        int workersRequiredToBuild = getRace() == Races::Protoss ? 0 : 1;
+        int workersRequiredToBuild = RaceTraits<race>::workersRequiredToBuild;
         int buildingIsRefinery = action.isRefinery() ? 1 : 0;
-        int candidateWorkers = getNumMineralWorkers() + _units.getNumInProgress(ActionTypes::GetWorker(getRace())) + getNumBuildingWorkers();
+        int candidateWorkers = getNumMineralWorkers() + _units.getNumInProgress(ActionTypes::GetWorker(race)) + getNumBuildingWorkers();
         int workersToBeUsed = workersRequiredToBuild + workersPerRefinery*(refineriesInProgress);
 
         if (candidateWorkers < workersToBeUsed)
@@ -337,26 +205,74 @@ bool GameState::isLegal(const ActionType & action) const
 
 // do an action, action must be legal for this not to break
 std::vector<ActionType> GameState::doAction(const ActionType & action)
+{
+    std::vector<ActionType> actionsFinished;
+    doAction(action, nullptr, &actionsFinished);
+
+    return actionsFinished;
+}
+
+void GameState::doAction(const ActionType & action, GameStateUndo & undo)
+{
+    BOSS_RACE_DISPATCH(_race, doAction, action, undo);
+}
+
+template <RaceID race>
+void GameState::doAction(const ActionType & action, GameStateUndo & undo)
+{
+    undo.actionPerformed    = _actionPerformed;
+    undo.actionPerformedK   = _actionPerformedK;
+    undo.currentFrame       = _currentFrame;
+    undo.lastActionFrame    = _lastActionFrame;
+    undo.minerals           = _minerals;
+    undo.gas                = _gas;
+    _units.saveUndo(undo);
+
+    doAction<race>(action, &undo, nullptr);
+}
+
+void GameState::undoAction(const GameStateUndo & undo)
+{
+    BOSS_ASSERT(_actionsPerformed.size() > 0, "No action to undo");
+
+    _units.restore(undo);
+
+    _actionPerformed    = undo.actionPerformed;
+    _actionPerformedK   = undo.actionPerformedK;
+    _currentFrame       = undo.currentFrame;
+    _lastActionFrame    = undo.lastActionFrame;
+    _minerals           = undo.minerals;
+    _gas                = undo.gas;
+
+    _actionsPerformed.pop_back();
+    _resourceTimeline.invalidate();
+}
+
+void GameState::doAction(const ActionType & action, GameStateUndo * undo, std::vector<ActionType> * actionsFinished)
+{
+    BOSS_RACE_DISPATCH(_race, doAction, action, undo, actionsFinished);
+}
+
+template <RaceID race>
+void GameState::doAction(const ActionType & action, GameStateUndo * undo, std::vector<ActionType> * actionsFinished)
 {
     BOSS_ASSERT(action.getRace() == _race, "Race of action does not match race of the state");
+    BOSS_ASSERT(race == _race, "Race specific doAction called on a state of a different race");
 
     _actionsPerformed.push_back(ActionPerformed());
     _actionsPerformed[_actionsPerformed.size()-1].actionType = action;
 
-    BOSS_ASSERT(isLegal(action), "Trying to perform an illegal action: %s %s", action.getName().c_str(), getActionsPerformedString().c_str());
+    BOSS_ASSERT(isLegal<race>(action), "Trying to perform an illegal action: %s %s", action.getName().c_str(), getActionsPerformedString().c_str());
     
     // set the actionPerformed
     _actionPerformed = action;
     _actionPerformedK = 1;
 
-    FrameCountType workerReadyTime = whenWorkerReady(action);
-    FrameCountType ffTime = whenCanPerform(action);
-
-    const std::string & name = action.getName();
+    FrameCountType ffTime = whenCanPerform<race>(action);
 
     BOSS_ASSERT(ffTime >= 0 && ffTime < 1000000, "FFTime is very strange: %d", ffTime);
 
-    auto actionsFinished = fastForward(ffTime);
+    fastForward<race>(ffTime, undo, actionsFinished);
 
     _actionsPerformed[_actionsPerformed.size()-1].actionQueuedFrame = _currentFrame;
     _actionsPerformed[_actionsPerformed.size()-1].gasWhenQueued = _gas;
@@ -374,11 +290,11 @@ std::vector<ActionType> GameState::doAction(const ActionType & action)
     _gas        -= action.gasPrice();
 
     // do race specific things here
-    if (getRace() == Races::Protoss)
+    if (race == Races::Protoss)
     {
-        _units.addActionInProgress(action, _currentFrame + action.buildTime());    
+        _units.addActionInProgress(action, _currentFrame + action.buildTime(), true, undo);    
     }
-    else if (getRace() == Races::Terran)
+    else if (race == Races::Terran)
     {
         if (action.isBuilding() && !action.isAddon())
         {
@@ -386,44 +302,59 @@ std::vector<ActionType> GameState::doAction(const ActionType & action)
             _units.setBuildingWorker();
         }
 
-        _units.addActionInProgress(action, _currentFrame + action.buildTime());
+        _units.addActionInProgress(action, _currentFrame + action.buildTime(), true, undo);
     }
-    else if (getRace() == Races::Zerg)
+    else if (race == Races::Zerg)
     {
      	//  zerg must subtract a larva if the action was unit creation
     	if (action.isUnit() && !action.isBuilding()) 
         {
             if (action.isMorphed())
             {
-                _units.morphUnit(action.whatBuildsActionType(), action, _currentFrame + action.buildTime());   
+                _units.morphUnit(action.whatBuildsActionType(), action, _currentFrame + action.buildTime(), undo);   
             }
             else
             {
                 BOSS_ASSERT(getHatcheryData().numLarva() > 0, "We should have a larva to use");
                 _units.getHatcheryData().useLarva();
-                _units.addActionInProgress(action, _currentFrame + action.buildTime());
+                _units.addActionInProgress(action, _currentFrame + action.buildTime(), true, undo);
             }
      	}
      	else if (action.isBuilding())
      	{
-            _units.morphUnit(action.whatBuildsActionType(), action, _currentFrame + action.buildTime());
+            _units.morphUnit(action.whatBuildsActionType(), action, _currentFrame + action.buildTime(), undo);
      	}
         else
         {
             // if it's not a unit or a building it's a tech so we queue it normally
-            _units.addActionInProgress(action, _currentFrame + action.buildTime());
+            _units.addActionInProgress(action, _currentFrame + action.buildTime(), true, undo);
         }
      }
 
-	return actionsFinished;
+    _resourceTimeline.invalidate();
 }
 
 // fast forwards the current state to time toFrame
 std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
+{
+    std::vector<ActionType> actionsFinished;
+    fastForward(toFrame, nullptr, &actionsFinished);
+
+    return actionsFinished;
+}
+
+// the search passes no actionsFinished vector so fast forwarding doesn't allocate
+void GameState::fastForward(const FrameCountType toFrame, GameStateUndo * undo, std::vector<ActionType> * actionsFinished)
+{
+    BOSS_RACE_DISPATCH(_race, fastForward, toFrame, undo, actionsFinished);
+}
+
+template <RaceID race>
+void GameState::fastForward(const FrameCountType toFrame, GameStateUndo * undo, std::vector<ActionType> * actionsFinished)
 {
     // fast forward the building timers to the current frame
     FrameCountType previousFrame = _currentFrame;
-    _units.setBuildingFrame(toFrame - _currentFrame);
+    _units.setBuildingFrame(toFrame - _currentFrame, undo);
 
     // update resources & finish each action
     FrameCountType      lastActionFinished  = _currentFrame;
@@ -432,7 +363,6 @@ std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
     ResourceCountType   moreMinerals        = 0;
 
 
-	std::vector<ActionType> actionsFinished;
     // while we still have units in progress
     while ((_units.getNumActionsInProgress() > 0) && (_units.getNextActionFinishTime() <= toFrame))
     {
@@ -448,7 +378,12 @@ std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
         lastActionFinished 	= _units.getNextActionFinishTime();
 
         // finish the action, which updates mineral and gas rates if required
-		actionsFinished.push_back(_units.finishNextActionInProgress());
+        ActionType finished = _units.finishNextActionInProgress<race>(undo);
+
+        if (actionsFinished)
+        {
+		    actionsFinished->push_back(finished);
+        }
     }
 
     // update resources from the last action finished to toFrame
@@ -463,19 +398,24 @@ std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
     // we are now in the FUTURE... "the future, conan?"
     _currentFrame           = toFrame;
 
-    if (getRace() == Races::Zerg)
+    if (RaceTraits<race>::usesLarva)
     {
         _units.getHatcheryData().fastForward(previousFrame, toFrame);
     }
 
-	return actionsFinished;
+    _resourceTimeline.invalidate();
 }
 
 // returns the time at which all resources to perform an action will be available
 const FrameCountType GameState::whenCanPerform(const ActionType & action) const
 {
-    const std::string & name = action.getName();
+    BOSS_RACE_DISPATCH(_race, whenCanPerform, action);
+    return 0;
+}
 
+template <RaceID race>
+const FrameCountType GameState::whenCanPerform(const ActionType & action) const
+{
     // the resource times we care about
     FrameCountType mineralTime  (_currentFrame); 	// minerals
     FrameCountType gasTime      (_currentFrame); 	// gas
@@ -495,13 +435,13 @@ const FrameCountType GameState::whenCanPerform(const ActionType & action) const
     gasTime         = whenGasReady(action);
 
     // race specific timings (Zerg Larva)
-    classTime       = raceSpecificWhenReady(action);
+    classTime       = raceSpecificWhenReady<race>(action);
 
     // set when we will have enough supply for this unit
     supplyTime      = whenSupplyReady(action);
 
     // when will we have a worker ready to build it?
-    workerTime      = whenWorkerReady(action);
+    workerTime      = whenWorkerReady<race>(action);
 
     // figure out the max of all these times
     maxVal = (mineralTime > maxVal) ? mineralTime   : maxVal;
@@ -515,27 +455,30 @@ const FrameCountType GameState::whenCanPerform(const ActionType & action) const
     return maxVal;
 }
 
+template <RaceID race>
 const FrameCountType GameState::raceSpecificWhenReady(const ActionType & a) const
 {
     const static ActionType larva = ActionTypes::GetActionType("Zerg_Larva");
 
 
-    if (getRace() == Races::Zerg)
+    if (RaceTraits<race>::usesLarva)
     {        
         if (a.whatBuildsActionType() != larva)
         {
             return 0;
         }
 
-        if (getHatcheryData().numLarva() == 0)
+        const FrameCountType larvaFrame = getHatcheryData().whenLarvaAvailable(_currentFrame, 1);
+        if (larvaFrame > _currentFrame)
         {
-            return getHatcheryData().nextLarvaFrameAfter(_currentFrame);
+            return larvaFrame;
         }
     }
 
     return 0;
 }
 
+template <RaceID race>
 const FrameCountType GameState::whenWorkerReady(const ActionType & action) const
 {
     if (!action.whatBuildsActionType().isWorker())
@@ -543,10 +486,10 @@ const FrameCountType GameState::whenWorkerReady(const ActionType & action) const
         return _currentFrame;
     }
 
-    int refineriesInProgress = _units.getNumInProgress(ActionTypes::GetRefinery(getRace()));
+    int refineriesInProgress = _units.getNumInProgress(ActionTypes::GetRefinery(race));
 
     // protoss doesn't tie up a worker to build, so they can build whenever a mineral worker is free
-    if (getRace() == Races::Protoss && getNumMineralWorkers() > 0)
+    if (RaceTraits<race>::workerFreeWhileBuilding && getNumMineralWorkers() > 0)
     {
         return _currentFrame;
     }
@@ -560,7 +503,7 @@ const FrameCountType GameState::whenWorkerReady(const ActionType & action) const
     // at this point we need to wait for the next worker to become free since existing workers
     // are either all used, or they are reserved to be put into refineries
     // so we must have either a worker in progress, or a building in progress
-    const ActionType & Worker = ActionTypes::GetWorker(getRace());
+    const ActionType & Worker = ActionTypes::GetWorker(race);
     BOSS_ASSERT(_units.getNumInProgress(Worker) > 0 || getNumBuildingWorkers() > 0, "No worker will ever be free");
 
     FrameCountType workerReadyTime = _currentFrame;
@@ -617,11 +560,6 @@ const FrameCountType GameState::whenSupplyReady(const ActionType & action) const
 
 const FrameCountType GameState::whenPrerequisitesReady(const ActionType & action) const
 {
-    if (action == ActionTypes::GetActionType("Protoss_Dark_Templar"))
-    {
-        int a = 6;
-    }
-
     FrameCountType preReqReadyTime = _currentFrame;
 
     // if a building builds this action
@@ -713,93 +651,8 @@ const FrameCountType GameState::whenMineralsReady(const ActionType & action) con
     {
         return getCurrentFrame();
     }
-    
-    UnitCountType currentMineralWorkers     = _units.getNumMineralWorkers();
-    UnitCountType currentGasWorkers         = _units.getNumGasWorkers();
-    FrameCountType lastActionFinishFrame    = _currentFrame;
-    FrameCountType addedTime                = 0;
-    ResourceCountType addedMinerals         = 0;
-    ResourceCountType difference            = action.mineralPrice() - _minerals;
-
-    // loop through each action in progress, adding the minerals we would gather from each interval
-    for (size_t i(0); i<_units.getNumActionsInProgress(); ++i)
-    {
-        // the vector is sorted in descending order
-        size_t progressIndex = _units.getNumActionsInProgress() - i - 1;
 
-        // the time elapsed and the current minerals per frame
-        FrameCountType elapsed = _units.getFinishTimeByIndex(progressIndex) - lastActionFinishFrame;
-        ResourceCountType mineralsPerFrame = (currentMineralWorkers * Constants::MPWPF);
-
-        // the amount of minerals that would be added this time step
-        ResourceCountType tempAdd = elapsed * mineralsPerFrame;
-
-        // if this amount isn't enough, update the amount added for this interval
-        if (addedMinerals + tempAdd < difference)
-        {
-            addedMinerals += tempAdd;
-            addedTime += elapsed;
-        }
-        else
-        {
-            // otherwise we can just break out and update at the end
-            break;
-        }
-
-        // if it was a drone or extractor update the temp variables
-        const ActionType & actionPerformed = _units.getActionInProgressByIndex(progressIndex);
-
-        // finishing a building as terran gives you a mineral worker back
-        if (actionPerformed.isBuilding() && !actionPerformed.isAddon() && (getRace() == Races::Terran))
-        {
-            currentMineralWorkers++;
-        }
-
-        if (actionPerformed.isWorker())
-        {
-            currentMineralWorkers++;
-        }
-        else if (actionPerformed.isRefinery())
-        {
-            BOSS_ASSERT(currentMineralWorkers > 3, "Not enough mineral workers \n");
-            currentMineralWorkers -= 3; 
-            currentGasWorkers += 3;
-        }
-
-
-        // update the last action
-        lastActionFinishFrame = _units.getFinishTimeByIndex(progressIndex);
-    }
-
-    // if we still haven't added enough minerals, add more time
-    if (addedMinerals < difference)
-    {
-        BOSS_ASSERT(currentMineralWorkers > 0, "Shouldn't have 0 mineral workers");
-
-       FrameCountType finalTimeToAdd;
-	   if (currentMineralWorkers != 0)
-		{
-			finalTimeToAdd = (difference - addedMinerals) / (currentMineralWorkers * Constants::MPWPF);
-		}
-		else
-		{
-			finalTimeToAdd = 1000000;
-		}
-        addedMinerals += finalTimeToAdd * currentMineralWorkers * Constants::MPWPF;
-        addedTime     += finalTimeToAdd;
-
-        // the last operation could have added one frame too little due to integer division so we need to check
-        if (addedMinerals < difference)
-        {
-            addedTime += 1;
-            addedMinerals += currentMineralWorkers * Constants::MPWPF;
-        }
-    }
-    
-    BOSS_ASSERT(addedMinerals >= difference, "Mineral prediction error");
-
-    // for some reason if i don't return +1, i mine 1 less mineral in the interval
-    return _currentFrame + addedTime;
+    return getResourceTimeline().whenMineralsGathered(_units, _race, action.mineralPrice() - _minerals);
 }
 
 const FrameCountType GameState::whenGasReady(const ActionType & action) const
@@ -808,90 +661,19 @@ const FrameCountType GameState::whenGasReady(const ActionType & action) const
     {
         return getCurrentFrame();
     }
-    
-    UnitCountType currentMineralWorkers     = _units.getNumMineralWorkers();
-    UnitCountType currentGasWorkers         = _units.getNumGasWorkers();
-    FrameCountType lastActionFinishFrame    = _currentFrame;
-    FrameCountType addedTime                = 0;
-    ResourceCountType addedGas              = 0;
-    ResourceCountType difference            = action.gasPrice() - _gas;
-
-    // loop through each action in progress, adding the minerals we would gather from each interval
-    for (size_t i(0); i<_units.getNumActionsInProgress(); ++i)
-    {
-        // the vector is sorted in descending order
-        size_t progressIndex = _units.getNumActionsInProgress() - i - 1;
-
-        // the time elapsed and the current minerals per frame
-        FrameCountType elapsed = _units.getFinishTimeByIndex(progressIndex) - lastActionFinishFrame;
-        ResourceCountType gasPerFrame = (currentGasWorkers * Constants::GPWPF);
-
-        // the amount of minerals that would be added this time step
-        ResourceCountType tempAdd = elapsed * gasPerFrame;
-
-        // if this amount isn't enough, update the amount added for this interval
-        if (addedGas + tempAdd < difference)
-        {
-            addedGas += tempAdd;
-            addedTime += elapsed;
-        }
-        else
-        {
-            // otherwise we can just break out and update at the end
-            break;
-        }
-
-        // if it was a drone or extractor update the temp variables
-        const ActionType & actionPerformed = _units.getActionInProgressByIndex(progressIndex);
-
-        // finishing a building as terran gives you a mineral worker back
-        if (actionPerformed.isBuilding() && !actionPerformed.isAddon() && (getRace() == Races::Terran))
-        {
-            currentMineralWorkers++;
-        }
 
-        if (actionPerformed.isWorker())
-        {
-            currentMineralWorkers++;
-        }
-        else if (actionPerformed.isRefinery())
-        {
-            BOSS_ASSERT(currentMineralWorkers > 3, "Not enough mineral workers");
-            currentMineralWorkers -= 3; currentGasWorkers += 3;
-        }
-
-        // update the last action
-        lastActionFinishFrame = _units.getFinishTimeByIndex(progressIndex);
-    }
+    return getResourceTimeline().whenGasGathered(_units, _race, action.gasPrice() - _gas);
+}
 
-    // if we still haven't added enough minerals, add more time
-    if (addedGas < difference)
+// the timeline depends on the units in progress and the current frame, so anything that changes them invalidates it
+ResourceTimeline & GameState::getResourceTimeline() const
+{
+    if (!_resourceTimeline.isValid())
     {
-		BOSS_ASSERT(currentGasWorkers > 0, "Shouldn't have 0 gas workers");
-		FrameCountType finalTimeToAdd;
-		if (currentGasWorkers != 0)
-		{
-			finalTimeToAdd = (difference - addedGas) / (currentGasWorkers * Constants::GPWPF);
-		}
-		else
-		{
-			finalTimeToAdd = 1000000;
-		}
-        addedGas    += finalTimeToAdd * currentGasWorkers * Constants::GPWPF;
-        addedTime   += finalTimeToAdd;
-
-        // the last operation could have added one frame too little due to integer division so we need to check
-        if (addedGas < difference)
-        {
-            addedTime += 1;
-            addedGas += currentGasWorkers * Constants::GPWPF;
-        }
+        _resourceTimeline.reset(_units, _currentFrame);
     }
-    
-    BOSS_ASSERT(addedGas >= difference, "Gas prediction error");
 
-    // for some reason if i don't return +1, i mine 1 less mineral in the interval
-    return _currentFrame + addedTime;
+    return _resourceTimeline;
 }
 
 const FrameCountType GameState::getCurrentFrame() const
@@ -995,6 +777,13 @@ const HatcheryData & GameState::getHatcheryData() const
     return _units.getHatcheryData();
 }
 
+// the hash covers everything which determines the future of the state except the current frame
+// and resources, which the transposition table compares directly to test for dominance
+const HashValues GameState::getHash() const
+{
+    return _units.getHash();
+}
+
 void GameState::setMinerals(const ResourceCountType & minerals)
 {
     _minerals = minerals * Constants::RESOURCE_SCALE;
@@ -1012,6 +801,8 @@ void GameState::addCompletedAction(const ActionType & action, const size_t num)
         _units.addCompletedAction(action, false);
         _units.setCurrentSupply(_units.getCurrentSupply() + action.supplyRequired());
     }
+
+    _resourceTimeline.invalidate();
 }
 
 void GameState::removeCompletedAction(const ActionType & action, const size_t num)
@@ -1021,6 +812,8 @@ void GameState::removeCompletedAction(const ActionType & action, const size_t nu
 		_units.setCurrentSupply(_units.getCurrentSupply() - action.supplyRequired());
 		_units.removeCompletedAction(action);
 	}
+
+    _resourceTimeline.invalidate();
 }
 
 const std::string GameState::toString() const
@@ -1195,4 +988,15 @@ std::string GameState::whyIsNotLegal(const ActionType & action) const
     }
 
     return "Legal";
-}
\ No newline at end of file
+}
+
+// the race specific versions that GameStateT and the search call from other files
+template void                    GameState::doAction<Races::Protoss>(const ActionType & action, GameStateUndo & undo);
+template void                    GameState::doAction<Races::Terran>(const ActionType & action, GameStateUndo & undo);
+template void                    GameState::doAction<Races::Zerg>(const ActionType & action, GameStateUndo & undo);
+template const FrameCountType    GameState::whenCanPerform<Races::Protoss>(const ActionType & action) const;
+template const FrameCountType    GameState::whenCanPerform<Races::Terran>(const ActionType & action) const;
+template const FrameCountType    GameState::whenCanPerform<Races::Zerg>(const ActionType & action) const;
+template bool                    GameState::isLegal<Races::Protoss>(const ActionType & action) const;
+template bool                    GameState::isLegal<Races::Terran>(const ActionType & action) const;
+template bool                    GameState::isLegal<Races::Zerg>(const ActionType & action) const;
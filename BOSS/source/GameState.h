@@ -8,6 +8,10 @@
 #include "ActionType.h"
 #include "PrerequisiteSet.h"
 #include "ActionSet.h"
+#include "GameStateUndo.h"
+#include "ResourceTimeline.h"
+#include "RaceTraits.h"
+#include "GameStateRecipe.h"
 
 //#define ENABLE_BWAPI_GAMESTATE_CONSTRUCTOR
 
@@ -50,8 +54,11 @@ class GameState
 
     std::vector<ActionPerformed>   _actionsPerformed;
 
-    const FrameCountType        raceSpecificWhenReady(const ActionType & a) const;
-    void                        fixZergUnitMasks();
+    mutable ResourceTimeline    _resourceTimeline;          // extended by resource queries, reset when the state changes
+
+    ResourceTimeline &          getResourceTimeline()                                                   const;
+
+    template <RaceID race> const FrameCountType raceSpecificWhenReady(const ActionType & a)             const;
     
     const FrameCountType        whenSupplyReady(const ActionType & action)                              const;
     const FrameCountType        whenPrerequisitesReady(const ActionType & action)                       const;
@@ -59,11 +66,17 @@ class GameState
     //const FrameCountType        whenConstructedBuildingReady(const ActionType & builder)                const;
     const FrameCountType        whenMineralsReady(const ActionType & action)                            const;
     const FrameCountType        whenGasReady(const ActionType & action)                                 const;
-    const FrameCountType        whenWorkerReady(const ActionType & action)                              const;
+    template <RaceID race> const FrameCountType whenWorkerReady(const ActionType & action)              const;
+
+    void                        doAction(const ActionType & action, GameStateUndo * undo, std::vector<ActionType> * actionsFinished);
+    void                        fastForward(const FrameCountType toFrame, GameStateUndo * undo, std::vector<ActionType> * actionsFinished);
+    template <RaceID race> void doAction(const ActionType & action, GameStateUndo * undo, std::vector<ActionType> * actionsFinished);
+    template <RaceID race> void fastForward(const FrameCountType toFrame, GameStateUndo * undo, std::vector<ActionType> * actionsFinished);
 
 public: 
 
     GameState(const RaceID r = Races::None);
+    GameState(const GameStateRecipe & recipe);
 
 // constructor based on BWAPI::Game only makes sense if using VS
 // we won't be using this if we're compiling to emscripten or linux
@@ -73,8 +86,19 @@ public:
 
 	std::vector<ActionType>     doAction(const ActionType & action);
     std::vector<ActionType>     fastForward(const FrameCountType toFrame) ;
+
+    // do an action while recording what it changed in undo, then undoAction(undo) restores the previous state
+    // actions must be undone in the reverse order they were done
+    void                        doAction(const ActionType & action, GameStateUndo & undo);
+    void                        undoAction(const GameStateUndo & undo);
     void                        finishNextActionInProgress();
 
+    // versions of the hot functions for a race known at compile time, which is what GameStateT uses
+    // the ones above check the race of the state and call these
+    template <RaceID race> void                     doAction(const ActionType & action, GameStateUndo & undo);
+    template <RaceID race> const FrameCountType     whenCanPerform(const ActionType & action)           const;
+    template <RaceID race> bool                     isLegal(const ActionType & action)                  const;
+
     const FrameCountType        getCurrentFrame()                                                       const;
     const FrameCountType        whenCanPerform(const ActionType & action)                               const;
     const FrameCountType        getLastActionFinishTime()                                               const;
@@ -106,6 +130,7 @@ public:
     const std::string           getActionsPerformedString()     const;
     const BuildingData &        getBuildingData()               const;
     const HatcheryData &        getHatcheryData()               const;
+    const HashValues            getHash()                       const;
 
     void                        setStartingState();
     void                        setMinerals(const ResourceCountType & minerals);
@@ -113,4 +138,43 @@ public:
     void                        addCompletedAction(const ActionType & action, const size_t num = 1);
 	void                        removeCompletedAction(const ActionType & action, const size_t num = 1);
 };
+
+// a game state whose race is fixed at compile time, so the hot functions skip the race checks
+// and the zerg larva and hatchery logic compiles away for the other races
+// it adds no data, so it can be made from and used as a GameState of the same race
+template <RaceID race>
+class GameStateT : public GameState
+{
+public:
+
+    GameStateT()
+        : GameState(race)
+    {
+
+    }
+
+    explicit GameStateT(const GameState & state)
+        : GameState(state)
+    {
+        BOSS_ASSERT(state.getRace() == race, "GameStateT made from a state of a different race");
+    }
+
+    using GameState::doAction;
+
+    void doAction(const ActionType & action, GameStateUndo & undo)
+    {
+        GameState::doAction<race>(action, undo);
+    }
+
+    const FrameCountType whenCanPerform(const ActionType & action) const
+    {
+        return GameState::whenCanPerform<race>(action);
+    }
+
+    bool isLegal(const ActionType & action) const
+    {
+        return GameState::isLegal<race>(action);
+    }
+};
+
 }
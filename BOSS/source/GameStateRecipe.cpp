@@ -0,0 +1,222 @@
+#include "GameStateRecipe.h"
+
+using namespace BOSS;
+
+GameStateRecipe::GameStateRecipe(const RaceID r)
+    : race                  (r)
+    , frame                 (0)
+    , minerals              (0)
+    , gas                   (0)
+{
+
+}
+
+#ifdef _MSC_VER
+GameStateRecipe::GameStateRecipe(BWAPI::GameWrapper & game, BWAPI::PlayerInterface * self, const std::vector<BWAPI::UnitType> & buildingsQueued)
+    : race                  (Races::GetRaceID(self->getRace()))
+    , frame                 (game->getFrameCount())
+    , minerals              (self->minerals() * Constants::RESOURCE_SCALE)
+    , gas                   (self->gas() * Constants::RESOURCE_SCALE)
+{ 
+    // add buildings queued like they had just been started
+    for (const BWAPI::UnitType & type : buildingsQueued)
+    {
+        addActionInProgress(ActionType(type), game->getFrameCount() + type.buildTime());
+    }
+
+	// add each unit we have to the current state
+	for (BWAPI::UnitInterface * unit : self->getUnits())
+	{
+        // if the unit is an egg then we're building a zerg unit, add it with the finish time
+        if (unit->getType() == BWAPI::UnitTypes::Zerg_Egg)
+        {
+            addActionInProgress(ActionType(unit->getBuildType()), game->getFrameCount() + unit->getRemainingBuildTime());
+            continue;
+        }
+
+		if (unit->getType() == BWAPI::UnitTypes::Zerg_Larva)
+		{
+			continue;
+		}
+
+        // don't add any units that we don't have any the action space, this should never happen though
+		if (!ActionTypes::TypeExists(unit->getType()))
+		{
+			continue;
+		}
+
+        ActionType actionType(unit->getType());
+
+		// if the unit is completed
+		if (unit->isCompleted())
+		{
+			// if it is a building that is not an addon
+			if (unit->getType().isBuilding())
+			{
+                // add the building data accordingly
+				FrameCountType  trainTime = unit->getRemainingTrainTime() + unit->getRemainingResearchTime() + unit->getRemainingUpgradeTime();
+                ActionType      constructing;
+                ActionType      addon;
+                bool            isHatchery = unit->getType().isResourceDepot() && unit->getType().getRace() == BWAPI::Races::Zerg;
+
+                // if this is a hatchery subtract the training time which is just larva production time
+                if (isHatchery)
+                {
+                    trainTime -= unit->getRemainingTrainTime();
+                }
+                // if this unit is currently building an addon, set it
+                if (unit->getAddon() && unit->getAddon()->isBeingConstructed())
+                {
+                    constructing = ActionType(unit->getAddon()->getType());
+                } 
+                // if it's a non-hatchery currently training something, add it
+                else if (!isHatchery && unit->getRemainingTrainTime() > 0)
+                {
+                    // find the unit we have that has the same construction time remaining
+                    // this is an awful hack but there seems to be no alternative
+                    bool set = false;
+                    for (auto & u : self->getUnits())
+                    {
+                        if (u->getRemainingBuildTime() > 0 && u->getPosition().getDistance(unit->getPosition()) < 16)
+                        {
+                            constructing = ActionType(u->getType());
+                            set = true;
+                            break;
+                        }
+                    }
+
+                    // check to see if the last order issued was a trianing order and grab the unit type from that
+                    if (!set && unit->getLastCommand().getType() == BWAPI::UnitCommandTypes::Train)
+                    {
+                        BWAPI::UnitType trainType = unit->getLastCommand().getUnitType();
+
+                        if (BWAPI::Broodwar->getFrameCount() - unit->getLastCommandFrame() < 2*BWAPI::Broodwar->getLatencyFrames())
+                        {
+                            constructing = ActionType(trainType);
+                            set = true;
+
+                            // we now need to add this to units in progress, since it won't be detected below as an actual unit in progress
+                            addActionInProgress(trainType, game->getFrameCount() + trainType.buildTime());
+                        }
+                    }
+
+                    if (!set)
+                    {
+                        // if we couldn't find the unit type that this unit is training 
+                        // then we have to treat it as if it doesn't exist otherwise BOSS will act strangely
+                        trainTime = 0;
+                        BWAPI::Broodwar->printf("Couldn't find training unit for %s %s %d %d", unit->getType().getName().c_str(), unit->getBuildType().getName().c_str(), unit->getTrainingQueue().size(), unit->getRemainingTrainTime());
+                    }
+                }
+                // if it's researching something, add it
+				else if (unit->getRemainingResearchTime() > 0)
+				{
+					constructing = ActionType(unit->getTech());
+					addActionInProgress(constructing, game->getFrameCount() + unit->getRemainingResearchTime());
+				}
+                // if it's upgrading something, add it
+				else if (unit->getRemainingUpgradeTime() > 0)
+				{
+					constructing = ActionType(unit->getUpgrade());
+					addActionInProgress(constructing, game->getFrameCount() + unit->getRemainingUpgradeTime());
+				}
+
+                // add addons
+                if (unit->getAddon() != nullptr)
+                {
+                    if (unit->getAddon()->isConstructing())
+                    {
+                        constructing = ActionType(unit->getAddon()->getType());
+                    }
+                    else
+                    {
+                        addon = ActionType(unit->getAddon()->getType());    
+                    }
+                }
+
+                addCompletedBuilding(actionType, trainTime, constructing, addon, unit->getLarva().size());
+			}
+            // otherwise it is a non-building unit
+            else
+            {
+                if (unit->getType() == BWAPI::UnitTypes::Terran_Siege_Tank_Siege_Mode)
+                {
+                    actionType = ActionType(BWAPI::UnitTypes::Terran_Siege_Tank_Tank_Mode);
+                }
+
+                // add the unit to the state, which also sets the supply accordingly
+			    addCompletedUnit(actionType);
+            }
+		}
+        // the unit is currently under construction
+		else if ((unit->getRemainingBuildTime() > 0) && !unit->getType().isAddon())
+		{
+            // special case of a zerg building morphing into its upgrade
+            if (actionType.isBuilding() && actionType.isMorphed())
+            {
+                // add the completed building which is morphing into this building
+                addCompletedBuilding(actionType.whatBuildsActionType(), unit->getRemainingBuildTime(), actionType, ActionType(), unit->getLarva().size());
+            }
+
+            // add the unit itself in progress
+			addActionInProgress(actionType, game->getFrameCount() + unit->getRemainingBuildTime());
+		}
+	}
+
+    for (const BWAPI::UpgradeType & type : BWAPI::UpgradeTypes::allUpgradeTypes())
+	{
+        if (!ActionTypes::TypeExists(type))
+		{
+			continue;
+		}
+
+		if (self->getUpgradeLevel(type) > 0)
+		{
+			addCompletedAction(ActionType(type));
+		}
+	}
+    
+    for (const BWAPI::TechType & type : BWAPI::TechTypes::allTechTypes())
+	{
+        if (!ActionTypes::TypeExists(type))
+		{
+			continue;
+		}
+
+		if (self->hasResearched(type))
+		{
+		    addCompletedAction(ActionType(type));
+		}
+	}
+}
+#endif
+
+// a unit we are making, whose supply is already used
+void GameStateRecipe::addActionInProgress(const ActionType & action, const FrameCountType completionFrame)
+{
+    GameStateRecipeStep step(GameStateRecipeStep::ActionInProgress, action);
+    step.time = completionFrame;
+    steps.push_back(step);
+}
+
+void GameStateRecipe::addCompletedBuilding(const ActionType & action, const FrameCountType timeUntilFree, const ActionType & constructing, const ActionType & addon, const int numLarva)
+{
+    GameStateRecipeStep step(GameStateRecipeStep::CompletedBuilding, action);
+    step.time = timeUntilFree;
+    step.constructing = constructing;
+    step.addon = addon;
+    step.numLarva = numLarva;
+    steps.push_back(step);
+}
+
+// a unit that isn't a building, which uses its supply
+void GameStateRecipe::addCompletedUnit(const ActionType & action)
+{
+    steps.push_back(GameStateRecipeStep(GameStateRecipeStep::CompletedUnit, action));
+}
+
+// an upgrade or tech we have
+void GameStateRecipe::addCompletedAction(const ActionType & action)
+{
+    steps.push_back(GameStateRecipeStep(GameStateRecipeStep::CompletedAction, action));
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Common.h"
+#include "ActionType.h"
+
+namespace BOSS
+{
+
+// one call which adds a unit to the UnitData of a state being built
+class GameStateRecipeStep
+{
+public:
+
+    enum Type { ActionInProgress, CompletedBuilding, CompletedUnit, CompletedAction };
+
+    Type                type;
+    ActionType          action;
+    FrameCountType      time;           // the completion frame of an action in progress, or the frames until a building is free
+    ActionType          constructing;   // what a completed building is making, if anything
+    ActionType          addon;
+    int                 numLarva;
+
+    GameStateRecipeStep(const Type t = CompletedAction, const ActionType & a = ActionType())
+        : type(t)
+        , action(a)
+        , time(0)
+        , numLarva(0)
+    {
+
+    }
+};
+
+// how a GameState is built from a game: the frame, the resources and the units added in order
+// GameState(recipe) builds the same state again, so a recipe can be saved and the state rebuilt away from the game
+class GameStateRecipe
+{
+public:
+
+    RaceID                              race;
+    FrameCountType                      frame;
+    ResourceCountType                   minerals;       // scaled by Constants::RESOURCE_SCALE, like the state's
+    ResourceCountType                   gas;
+    std::vector<GameStateRecipeStep>    steps;
+
+    GameStateRecipe(const RaceID r = Races::None);
+
+// the recipe for a player in a game, what the GameState constructor taking a game used to build directly
+#ifdef _MSC_VER
+    GameStateRecipe(BWAPI::GameWrapper & game, BWAPI::PlayerInterface * player, const std::vector<BWAPI::UnitType> & buildingsQueued);
+#endif
+
+    void addActionInProgress(const ActionType & action, const FrameCountType completionFrame);
+    void addCompletedBuilding(const ActionType & action, const FrameCountType timeUntilFree, const ActionType & constructing, const ActionType & addon, const int numLarva);
+    void addCompletedUnit(const ActionType & action);
+    void addCompletedAction(const ActionType & action);
+};
+
+}
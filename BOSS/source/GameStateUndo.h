@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Common.h"
+#include "Array.hpp"
+#include "ActionInProgress.h"
+#include "BuildingData.h"
+#include "HatcheryData.h"
+#include "Hash.h"
+#include "ActionMask.h"
+
+namespace BOSS
+{
+
+// everything needed to revert a single GameState::doAction
+// the state and its components fill this in as they change, so undoing only touches what the action changed
+// the search keeps one of these per action in the build order so nothing is allocated while searching
+class GameStateUndo
+{
+public:
+
+    // GameState
+    ActionType          actionPerformed;
+    size_t              actionPerformedK;
+    FrameCountType      currentFrame;
+    FrameCountType      lastActionFrame;
+    ResourceCountType   minerals;
+    ResourceCountType   gas;
+
+    // UnitData
+    UnitCountType       mineralWorkers;
+    UnitCountType       gasWorkers;
+    UnitCountType       buildingWorkers;
+    SupplyCountType     maxSupply;
+    SupplyCountType     currentSupply;
+    HashValues          unitHash;
+    ActionMask          totalMask;
+    Vec<std::pair<ActionID, UnitCountType>, Constants::MAX_PROGRESS + 1> numCompleted;     // previous completed counts, in the order they changed
+
+    // HatcheryData is small enough to save whole
+    HatcheryData        hatcheryData;
+
+    // ActionsInProgress
+    HashValues          progressHash;
+    Vec<ActionInProgress, Constants::MAX_PROGRESS> progressFinished;                       // actions popped, in the order they were popped
+    Vec<size_t, 4>      progressAdded;                                                      // index each new action was inserted at
+
+    // BuildingData
+    HashValues          buildingHash;
+    FrameCountType      buildingFramesElapsed;
+    size_t              numBuildings;
+    Vec<std::pair<size_t, BuildingStatus>, Constants::MAX_BUILDINGS + 1> buildingsChanged;  // previous status of changed buildings, in the order they changed
+
+    GameStateUndo()
+        : actionPerformedK(0)
+        , currentFrame(0)
+        , lastActionFrame(0)
+        , minerals(0)
+        , gas(0)
+        , mineralWorkers(0)
+        , gasWorkers(0)
+        , buildingWorkers(0)
+        , maxSupply(0)
+        , currentSupply(0)
+        , buildingFramesElapsed(0)
+        , numBuildings(0)
+    {
+
+    }
+};
+
+}
@@ -0,0 +1,83 @@
+#include "Hash.h"
+
+using namespace BOSS;
+
+namespace
+{
+    const HashType HashSeeds[] = { 0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL, 0xD6E8FEB86659FD93ULL };
+
+    // splitmix64 finalizer, turns a packed feature into a well distributed 64-bit key
+    inline HashType Mix(HashType x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+}
+
+HashType Hash::Key(const size_t hashNum, const size_t feature, const HashType a, const HashType b)
+{
+    static_assert(Constants::NUM_HASHES <= sizeof(HashSeeds) / sizeof(HashType), "Not enough hash seeds for NUM_HASHES");
+
+    return Mix(Mix(HashSeeds[hashNum] + (feature << 56) + a) + b);
+}
+
+HashType Hash::ActionKey(const ActionType & action)
+{
+    return ((HashType)action.getRace() << 8) | action.ID();
+}
+
+HashValues::HashValues()
+{
+    for (size_t h(0); h < Constants::NUM_HASHES; ++h)
+    {
+        _values[h] = 0;
+    }
+}
+
+void HashValues::add(const size_t feature, const HashType a, const HashType b)
+{
+    for (size_t h(0); h < Constants::NUM_HASHES; ++h)
+    {
+        _values[h] += Hash::Key(h, feature, a, b);
+    }
+}
+
+void HashValues::remove(const size_t feature, const HashType a, const HashType b)
+{
+    for (size_t h(0); h < Constants::NUM_HASHES; ++h)
+    {
+        _values[h] -= Hash::Key(h, feature, a, b);
+    }
+}
+
+void HashValues::add(const HashValues & other)
+{
+    for (size_t h(0); h < Constants::NUM_HASHES; ++h)
+    {
+        _values[h] += other._values[h];
+    }
+}
+
+const HashType HashValues::getValue(const size_t hashNum) const
+{
+    BOSS_ASSERT(hashNum < Constants::NUM_HASHES, "Hash number out of range: %d", (int)hashNum);
+
+    return _values[hashNum];
+}
+
+const bool HashValues::operator == (const HashValues & rhs) const
+{
+    for (size_t h(0); h < Constants::NUM_HASHES; ++h)
+    {
+        if (_values[h] != rhs._values[h])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
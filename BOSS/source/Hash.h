@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Common.h"
+#include "ActionType.h"
+
+namespace BOSS
+{
+
+typedef unsigned long long HashType;
+
+namespace Hash
+{
+    // the different kinds of state features that contribute to a GameState hash
+    enum { UnitCount, InProgress, Building, Larva, Workers, Supply, Race, NUM_FEATURES };
+
+    // the zobrist key for a single state feature, one independent key stream per hash number
+    // keys are generated on demand from a fixed seed so every run produces the same values
+    HashType            Key(const size_t hashNum, const size_t feature, const HashType a, const HashType b);
+
+    // packs an action type into a value which is unique across races, including ActionTypes::None
+    HashType            ActionKey(const ActionType & action);
+}
+
+// a set of NUM_HASHES incrementally maintained hash values
+// keys are combined with addition rather than xor so that identical features (for example two
+// zerglings which were started on the same frame) do not cancel each other out
+class HashValues
+{
+    HashType            _values[Constants::NUM_HASHES];
+
+public:
+
+    HashValues();
+
+    void                add(const size_t feature, const HashType a, const HashType b);
+    void                remove(const size_t feature, const HashType a, const HashType b);
+    void                add(const HashValues & other);
+
+    const HashType      getValue(const size_t hashNum) const;
+    const bool          operator == (const HashValues & rhs) const;
+};
+
+}
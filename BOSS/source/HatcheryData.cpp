@@ -2,108 +2,130 @@
 
 using namespace BOSS;
 
-Hatchery::Hatchery(const UnitCountType & numLarva) 
-	: _numLarva(numLarva)
-{
-}
+const UnitCountType HatcheryData::MaxLarva;
 
-Hatchery::Hatchery() 
-	: _numLarva(3)
+HatcheryData::HatcheryData()
 {
+    std::fill(_numHatcheries, _numHatcheries + MaxLarva + 1, 0);
 }
 
-void Hatchery::fastForward(const FrameCountType & currentFrame, const FrameCountType & toFrame)
+// the hash has one entry per hatchery, so it changes once for each hatchery moved
+void HatcheryData::moveHatcheries(const UnitCountType fromLarva, const UnitCountType toLarva, const UnitCountType count)
 {
-    if (_numLarva == 3)
+    _numHatcheries[fromLarva] -= count;
+    _numHatcheries[toLarva]   += count;
+
+    for (UnitCountType i(0); i < count; ++i)
     {
-        return;
+        _hash.remove(Hash::Larva, fromLarva, 0);
+        _hash.add(Hash::Larva, toLarva, 0);
     }
-
-    UnitCountType  larvaToAdd   = (toFrame / Constants::ZERG_LARVA_TIMER) - (currentFrame / Constants::ZERG_LARVA_TIMER);
-
-    larvaToAdd                  = std::min(larvaToAdd, (UnitCountType)(3 - _numLarva));
-
-    _numLarva += larvaToAdd;
 }
 
-void Hatchery::useLarva()
+void HatcheryData::addHatchery(const UnitCountType & numLarva)
 {
-    BOSS_ASSERT(_numLarva > 0, "We should have larva to use");
-
-    _numLarva--;
-}
+    const UnitCountType larva = std::min(numLarva, MaxLarva);
 
-const UnitCountType & Hatchery::numLarva() const
-{
-    return _numLarva;
+    _numHatcheries[larva]++;
+    _hash.add(Hash::Larva, larva, 0);
 }
 
-HatcheryData::HatcheryData()
+// the hatcheries can't be told apart, so the one removed is one with the fewest larva
+void HatcheryData::removeHatchery()
 {
+    for (UnitCountType larva(0); larva <= MaxLarva; ++larva)
+    {
+        if (_numHatcheries[larva] > 0)
+        {
+            _numHatcheries[larva]--;
+            _hash.remove(Hash::Larva, larva, 0);
+            return;
+        }
+    }
 
+    BOSS_ASSERT(false, "Should have found a hatchery to remove");
 }
 
-void HatcheryData::addHatchery(const UnitCountType & numLarva)
+// each spawn adds a larva to every hatchery which isn't full, so after n spawns a hatchery has min(larva + n, MaxLarva)
+void HatcheryData::fastForward(const FrameCountType & currentFrame, const FrameCountType & toFrame)
 {
-    _hatcheries.push_back(Hatchery(numLarva));
-}
+    const UnitCountType spawns = (UnitCountType)std::min((size_t)MaxLarva, (toFrame / Constants::ZERG_LARVA_TIMER) - (currentFrame / Constants::ZERG_LARVA_TIMER));
 
-void HatcheryData::removeHatchery()
-{
-	_hatcheries.pop_back();
-}
+    if (spawns == 0)
+    {
+        return;
+    }
 
-void HatcheryData::fastForward(const FrameCountType & currentFrame, const FrameCountType & toFrame)
-{
-    for (size_t i(0); i < _hatcheries.size(); ++i)
+    // the fuller hatcheries move first, so none is moved twice
+    for (int larva(MaxLarva - 1); larva >= 0; --larva)
     {
-        _hatcheries[i].fastForward(currentFrame, toFrame);
+        if (_numHatcheries[larva] > 0)
+        {
+            moveHatcheries(larva, std::min((UnitCountType)(larva + spawns), MaxLarva), _numHatcheries[larva]);
+        }
     }
 }
 
+// the larva is taken from a hatchery with the most larva
 void HatcheryData::useLarva()
 {
-    int maxLarvaIndex = -1;
-    for (size_t i(0); i < _hatcheries.size(); ++i)
+    for (UnitCountType larva(MaxLarva); larva > 0; --larva)
     {
-        if (_hatcheries[i].numLarva() > 0)
+        if (_numHatcheries[larva] > 0)
         {
-            if (maxLarvaIndex == -1 || (_hatcheries[i].numLarva() > _hatcheries[maxLarvaIndex].numLarva()))
-            {
-                maxLarvaIndex = i;
-            }
+            moveHatcheries(larva, larva - 1, 1);
+            return;
         }
     }
 
-    if (maxLarvaIndex != -1)
-    {
-        _hatcheries[maxLarvaIndex].useLarva();
-    }
-    else
-    {
-        BOSS_ASSERT(false, "Should have found a larva to use");
-    }
+    BOSS_ASSERT(false, "Should have found a larva to use");
 }
 
 const FrameCountType HatcheryData::nextLarvaFrameAfter(const FrameCountType & currentFrame) const
 {
-    if (currentFrame % Constants::ZERG_LARVA_TIMER == 0)
+    return Constants::ZERG_LARVA_TIMER * ((currentFrame / Constants::ZERG_LARVA_TIMER) + 1);
+}
+
+// the first frame from currentFrame on with at least numLarva larva, or -1 if the hatcheries can't hold that many
+// everything is full after MaxLarva spawns, so only that many spawn frames are checked
+const FrameCountType HatcheryData::whenLarvaAvailable(const FrameCountType & currentFrame, const UnitCountType & numLarva) const
+{
+    FrameCountType frame = currentFrame;
+
+    for (UnitCountType spawns(0); spawns <= MaxLarva; ++spawns)
     {
-        return currentFrame + Constants::ZERG_LARVA_TIMER;
+        if (numLarvaAfter(currentFrame, frame) >= numLarva)
+        {
+            return frame;
+        }
+
+        frame = nextLarvaFrameAfter(frame);
     }
-    else
+
+    return -1;
+}
+
+const UnitCountType HatcheryData::numLarva() const
+{
+    UnitCountType sumLarva = 0;
+
+    for (UnitCountType larva(1); larva <= MaxLarva; ++larva)
     {
-        return Constants::ZERG_LARVA_TIMER * ((currentFrame / Constants::ZERG_LARVA_TIMER) + 1);
+        sumLarva += larva * _numHatcheries[larva];
     }
+
+    return sumLarva;
 }
 
-const UnitCountType HatcheryData::numLarva() const
+// how many larva there will be at toFrame if none are used before then
+const UnitCountType HatcheryData::numLarvaAfter(const FrameCountType & currentFrame, const FrameCountType & toFrame) const
 {
+    const UnitCountType spawns = (UnitCountType)std::min((size_t)MaxLarva, (toFrame / Constants::ZERG_LARVA_TIMER) - (currentFrame / Constants::ZERG_LARVA_TIMER));
     UnitCountType sumLarva = 0;
 
-    for (size_t i(0); i < _hatcheries.size(); ++i)
+    for (UnitCountType larva(0); larva <= MaxLarva; ++larva)
     {
-        sumLarva += _hatcheries[i].numLarva();
+        sumLarva += std::min((UnitCountType)(larva + spawns), MaxLarva) * _numHatcheries[larva];
     }
 
     return sumLarva;
@@ -111,10 +133,17 @@ const UnitCountType HatcheryData::numLarva() const
 
 const UnitCountType HatcheryData::size() const
 {
-    return _hatcheries.size();
+    UnitCountType numHatcheries = 0;
+
+    for (UnitCountType larva(0); larva <= MaxLarva; ++larva)
+    {
+        numHatcheries += _numHatcheries[larva];
+    }
+
+    return numHatcheries;
 }
 
-const Hatchery & HatcheryData::getHatchery(const UnitCountType & index) const
+const HashValues & HatcheryData::getHash() const
 {
-    return _hatcheries[index];
-}
\ No newline at end of file
+    return _hash;
+}
@@ -9,29 +9,27 @@
 #include "PrerequisiteSet.h"
 #include "Array.hpp"
 #include "ActionType.h"
+#include "Hash.h"
 
 namespace BOSS
 {
 
-class Hatchery
-{ 
-    UnitCountType           _numLarva;
-	
+// the larva of all our hatcheries
+// every hatchery with fewer than MaxLarva larva gets one more each time the frame passes a multiple of ZERG_LARVA_TIMER,
+// so the hatcheries only differ in how many larva they have, and all that is stored is how many hatcheries have each number.
+// advancing to any frame or finding when larva will be ready is then a few additions, with no limit on the number of hatcheries
+class HatcheryData
+{
 public:
-	
-	Hatchery(const UnitCountType & numLarva);
-	Hatchery();
 
-       
-    void                    useLarva();
-    void                    fastForward(const FrameCountType & currentFrame, const FrameCountType & toFrame);
+    static const UnitCountType MaxLarva = 3;
 
-    const UnitCountType &   numLarva() const;
-};
+private:
 
-class HatcheryData
-{
-    Vec<Hatchery, Constants::MAX_HATCHERIES> _hatcheries;
+    UnitCountType           _numHatcheries[MaxLarva + 1];   // how many hatcheries have each number of larva
+    HashValues              _hash;                          // hash of the larva count of every hatchery
+
+    void                    moveHatcheries(const UnitCountType fromLarva, const UnitCountType toLarva, const UnitCountType count);
 
 public:
 
@@ -43,9 +41,11 @@ public:
     void                    fastForward(const FrameCountType & currentFrame, const FrameCountType & toFrame);
 
     const FrameCountType    nextLarvaFrameAfter(const FrameCountType & currentFrame) const;
+    const FrameCountType    whenLarvaAvailable(const FrameCountType & currentFrame, const UnitCountType & numLarva) const;
     const UnitCountType     numLarva() const;
+    const UnitCountType     numLarvaAfter(const FrameCountType & currentFrame, const FrameCountType & toFrame) const;
     const UnitCountType     size() const;
-    const Hatchery &        getHatchery(const UnitCountType & index) const;
+    const HashValues &      getHash() const;
 };
 
-}
\ No newline at end of file
+}
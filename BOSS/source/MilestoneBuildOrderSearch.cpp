@@ -0,0 +1,488 @@
+#include "MilestoneBuildOrderSearch.h"
+#include "DFBB_BuildOrderSmartSearch.h"
+#include "NaiveBuildOrderSearch.h"
+#include "ActionTypeTable.h"
+
+#include <algorithm>
+
+using namespace BOSS;
+
+namespace
+{
+    // each pass simulates the rest of the build order once for every pair of actions, within the search budget
+    // a swap often makes room for another one further back, so passes carry on until one improves nothing
+    const size_t MaxImprovementPasses = 32;
+}
+
+MilestoneBuildOrderSearch::MilestoneBuildOrderSearch(const DFBB_BuildOrderSearchParameters & p)
+    : _params(p)
+    , _phase(WholeGoalPhase)
+    , _wholeGoalTime(0)
+    , _milestoneIndex(0)
+    , _milestoneTime(0)
+    , _previousNodes(0)
+    , _improvementPass(0)
+    , _improvementIndex(0)
+    , _improvedThisPass(false)
+    , _bestFinishTime(0)
+    , _firstSearch(true)
+{
+
+}
+
+void MilestoneBuildOrderSearch::search()
+{
+    search(_params.getBudget());
+}
+
+// searches until the search is finished or the budget is used up, and returns true if it finished
+// a paused search keeps the search of the phase it is in, so the next call carries on with it
+bool MilestoneBuildOrderSearch::search(const DFBB_SearchBudget & budget)
+{
+    _searchTimer.start();
+
+    if (_phase == DonePhase)
+    {
+        return true;
+    }
+
+    if (_firstSearch)
+    {
+        BOSS_ASSERT(_params.initialState.getRace() != Races::None, "Milestone search initial state has no race");
+
+        _firstSearch = false;
+        _state = _params.initialState;
+        makeMilestones();
+    }
+
+    _results.timedOut = false;
+    unsigned long long nodes = 0;
+
+    if (_phase == WholeGoalPhase && !searchWholeGoal(budget, nodes))
+    {
+        return pause();
+    }
+
+    if (_phase == MilestonePhase)
+    {
+        if (!searchMilestones(budget, nodes))
+        {
+            return pause();
+        }
+        startImprovement();
+    }
+
+    if (_phase == ImprovementPhase)
+    {
+        if (!improveBuildOrder(budget))
+        {
+            return pause();
+        }
+        finishSearch();
+    }
+
+    _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+    return true;
+}
+
+bool MilestoneBuildOrderSearch::outOfBudget(const DFBB_SearchBudget & budget, unsigned long long nodes)
+{
+    return ((budget.timeLimit > 0) && (_searchTimer.getElapsedTimeInMilliSec() >= budget.timeLimit)) ||
+           (budget.nodeLimit && (nodes >= budget.nodeLimit));
+}
+
+bool MilestoneBuildOrderSearch::pause()
+{
+    _results.timedOut = true;
+    _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+    return false;
+}
+
+// returns false if the budget of this call ran out first
+// the whole goal search finishing ends the search, running out of its own time goes on to the milestones
+bool MilestoneBuildOrderSearch::searchWholeGoal(const DFBB_SearchBudget & budget, unsigned long long & nodes)
+{
+    if (_params.wholeGoalTimeLimit <= 0)
+    {
+        _phase = MilestonePhase;
+        return true;
+    }
+
+    if (!_wholeGoalSearch)
+    {
+        _wholeGoalSearch = std::shared_ptr<DFBB_BuildOrderSmartSearch>(new DFBB_BuildOrderSmartSearch(_state.getRace()));
+        _wholeGoalSearch->setGoal(_params.goal);
+        _wholeGoalSearch->setState(_params.initialState);
+        _wholeGoalSearch->setNumThreads(_params.numThreads);
+        if (!_params.seedBuildOrder.empty())
+        {
+            _wholeGoalSearch->addSeed(_params.seedBuildOrder);
+        }
+    }
+
+    if (outOfBudget(budget, nodes))
+    {
+        return false;
+    }
+
+    double timeLimit = _params.wholeGoalTimeLimit - _wholeGoalTime;
+    if (budget.timeLimit > 0)
+    {
+        timeLimit = std::min(timeLimit, budget.timeLimit - _searchTimer.getElapsedTimeInMilliSec());
+    }
+    const unsigned long long nodeLimit = budget.nodeLimit ? (budget.nodeLimit - nodes) : 0;
+    const unsigned long long nodesBefore = _wholeGoalSearch->getResults().nodesExpanded;
+
+    // a state DFBB can't search from is left to the milestones
+    bool finished = false;
+    bool failed = false;
+    try
+    {
+        finished = _wholeGoalSearch->search(DFBB_SearchBudget(timeLimit, nodeLimit));
+    }
+    catch (const BOSSException &)
+    {
+        failed = true;
+    }
+
+    const DFBB_BuildOrderSearchResults & results = _wholeGoalSearch->getResults();
+    nodes += results.nodesExpanded - nodesBefore;
+    _wholeGoalTime += results.timeElapsed;
+
+    if (finished && !failed)
+    {
+        _results = results;
+        _phase = DonePhase;
+        return true;
+    }
+
+    _results.nodesExpanded = results.nodesExpanded;
+    BOSS_STATS(_results.stats = results.stats);
+
+    if (failed || (_wholeGoalTime >= _params.wholeGoalTimeLimit))
+    {
+        if (!failed && results.solutionFound)
+        {
+            _wholeGoalBuildOrder = results.buildOrder;
+        }
+        _previousNodes = results.nodesExpanded;
+        BOSS_STATS(_previousStats = results.stats);
+        _wholeGoalSearch.reset();
+        _phase = MilestonePhase;
+        return true;
+    }
+
+    return false;
+}
+
+// returns false if the budget of this call ran out before every milestone was finished
+bool MilestoneBuildOrderSearch::searchMilestones(const DFBB_SearchBudget & budget, unsigned long long & nodes)
+{
+    while (_milestoneIndex < _milestones.size())
+    {
+        if (!_milestoneSearch)
+        {
+            startMilestone();
+        }
+
+        // a milestone which has used up its own time keeps the best build order it found
+        double timeLimit = 0;
+        if (_params.milestoneTimeLimit > 0)
+        {
+            timeLimit = _params.milestoneTimeLimit - _milestoneTime;
+            if (timeLimit <= 0)
+            {
+                finishMilestone();
+                continue;
+            }
+        }
+
+        // then the budget of this call is split between the milestones searched in it
+        if (outOfBudget(budget, nodes))
+        {
+            return false;
+        }
+
+        if (budget.timeLimit > 0)
+        {
+            const double remaining = budget.timeLimit - _searchTimer.getElapsedTimeInMilliSec();
+            timeLimit = (timeLimit > 0) ? std::min(timeLimit, remaining) : remaining;
+        }
+
+        const unsigned long long nodeLimit = budget.nodeLimit ? (budget.nodeLimit - nodes) : 0;
+        const unsigned long long nodesBefore = _milestoneSearch->getResults().nodesExpanded;
+
+        // a state DFBB can't search from, whose naive build order it can't work out, ends the milestone
+        // the goal of the next milestone includes this one's, so it gets another try from there
+        bool finished = true;
+        try
+        {
+            finished = _milestoneSearch->search(DFBB_SearchBudget(timeLimit, nodeLimit));
+        }
+        catch (const BOSSException &)
+        {
+        }
+
+        const DFBB_BuildOrderSearchResults & results = _milestoneSearch->getResults();
+        nodes += results.nodesExpanded - nodesBefore;
+        _milestoneTime += results.timeElapsed;
+        _results.nodesExpanded = _previousNodes + results.nodesExpanded;
+        BOSS_STATS(_results.stats = _previousStats; _results.stats.add(results.stats));
+
+        if (finished)
+        {
+            finishMilestone();
+        }
+    }
+
+    _phase = ImprovementPhase;
+    return true;
+}
+
+const DFBB_BuildOrderSearchResults & MilestoneBuildOrderSearch::getResults() const
+{
+    return _results;
+}
+
+size_t MilestoneBuildOrderSearch::getNumMilestones() const
+{
+    return _milestones.size();
+}
+
+// each milestone adds at most milestoneSize actions to the goal of the one before it
+// the actions are added in order of how many prerequisites deep they are, so workers and buildings with
+// no prerequisites come first and the units of the deepest tech last. a unit made in pairs is one action
+void MilestoneBuildOrderSearch::makeMilestones()
+{
+    const RaceID race = _params.initialState.getRace();
+    const ActionTypeTable & table = ActionTypeTable::Get(race);
+    const size_t numActions = ActionTypes::GetAllActionTypes(race).size();
+    const size_t milestoneSize = std::max((size_t)1, _params.milestoneSize);
+
+    // the longest prerequisite chain of every action, which can't have more links than there are actions
+    std::vector<int> depth(numActions, 0);
+    for (size_t pass(0); pass < numActions; ++pass)
+    {
+        bool changed = false;
+        for (ActionID a(0); a < numActions; ++a)
+        {
+            ActionMask prerequisites(table.prerequisiteMask[a]);
+            while (!prerequisites.isEmpty())
+            {
+                const ActionID p = prerequisites.popFirst();
+                if (depth[p] + 1 > depth[a])
+                {
+                    depth[a] = depth[p] + 1;
+                    changed = true;
+                }
+            }
+        }
+
+        if (!changed)
+        {
+            break;
+        }
+    }
+
+    std::vector<ActionID> order;
+    for (ActionID a(0); a < numActions; ++a)
+    {
+        if (_params.goal.getNumRemaining(_params.initialState, ActionTypes::GetActionType(race, a)) > 0)
+        {
+            order.push_back(a);
+        }
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&depth](const ActionID a, const ActionID b) { return depth[a] < depth[b]; });
+
+    // the milestones keep the goal's maximums, so early ones may build the production later ones need
+    BuildOrderSearchGoal milestone(_params.goal);
+    for (ActionID a(0); a < numActions; ++a)
+    {
+        milestone.setGoal(ActionTypes::GetActionType(race, a), 0);
+    }
+
+    size_t size = 0;
+    for (const ActionID a : order)
+    {
+        const ActionType & actionType = ActionTypes::GetActionType(race, a);
+        const UnitCountType goal = _params.goal.getGoal(actionType);
+        const int numProduced = actionType.numProduced();
+        UnitCountType count = goal - _params.goal.getNumRemaining(_params.initialState, actionType);
+
+        while (count < goal)
+        {
+            const int add = std::min((int)(goal - count), (int)(milestoneSize - size) * numProduced);
+
+            count += add;
+            milestone.setGoal(actionType, count);
+            size += (add + numProduced - 1) / numProduced;
+
+            if (size >= milestoneSize)
+            {
+                _milestones.push_back(milestone);
+                size = 0;
+            }
+        }
+    }
+
+    if (size > 0)
+    {
+        _milestones.push_back(milestone);
+    }
+}
+
+void MilestoneBuildOrderSearch::startMilestone()
+{
+    _milestoneSearch = std::shared_ptr<DFBB_BuildOrderSmartSearch>(new DFBB_BuildOrderSmartSearch(_state.getRace()));
+    _milestoneSearch->setGoal(_milestones[_milestoneIndex]);
+    _milestoneSearch->setState(_state);
+    _milestoneSearch->setNumThreads(_params.numThreads);
+    _milestoneTime = 0;
+}
+
+// a milestone search which found nothing better than the naive build order in its time uses the naive one
+// the build order is added even if it doesn't reach the milestone, since the next milestone's goal includes this one's
+void MilestoneBuildOrderSearch::finishMilestone()
+{
+    const DFBB_BuildOrderSearchResults & results = _milestoneSearch->getResults();
+
+    BuildOrder buildOrder;
+    if (results.solutionFound)
+    {
+        buildOrder = results.buildOrder;
+    }
+    else
+    {
+        try
+        {
+            NaiveBuildOrderSearch naiveSearch(_state, _milestones[_milestoneIndex]);
+            buildOrder = naiveSearch.solve();
+        }
+        catch (const BOSSException &)
+        {
+            buildOrder.clear();
+        }
+    }
+
+    const bool legal = buildOrder.doActions(_state);
+    BOSS_ASSERT(legal, "Milestone %d build order is not legal", (int)_milestoneIndex);
+
+    _buildOrder.add(buildOrder);
+    _previousNodes += results.nodesExpanded;
+    BOSS_STATS(_previousStats.add(results.stats));
+    _milestoneSearch.reset();
+    _milestoneIndex++;
+}
+
+// a build order which doesn't reach the goal isn't worth improving
+void MilestoneBuildOrderSearch::startImprovement()
+{
+    if (!_params.useLocalImprovement || (_buildOrder.size() < 2) || !_params.goal.isAchievedBy(_state))
+    {
+        _phase = DonePhase;
+        return;
+    }
+
+    _phase = ImprovementPhase;
+    _improvementPass = 0;
+    _improvementIndex = 0;
+    _improvedThisPass = false;
+    _bestFinishTime = _state.getLastActionFinishTime();
+}
+
+// swaps adjacent actions wherever the build order is still legal and finishes sooner
+// the actions stay the same, so the swapped build order still reaches the goal
+// each swap is simulated from the state before it, and the budget is checked before each one
+// returns false if the budget ran out, the next call carries on from the same swap
+bool MilestoneBuildOrderSearch::improveBuildOrder(const DFBB_SearchBudget & budget)
+{
+    while (_improvementPass < MaxImprovementPasses)
+    {
+        if (_improvementIndex == 0)
+        {
+            _improvementState = _params.initialState;
+            _improvedThisPass = false;
+        }
+
+        for (; _improvementIndex + 1 < _buildOrder.size(); ++_improvementIndex)
+        {
+            if (outOfBudget(budget, 0))
+            {
+                return false;
+            }
+
+            const size_t i = _improvementIndex;
+            if (_buildOrder[i] != _buildOrder[i + 1])
+            {
+                const ActionType first = _buildOrder[i];
+                _buildOrder[i] = _buildOrder[i + 1];
+                _buildOrder[i + 1] = first;
+
+                GameState state(_improvementState);
+                if (_buildOrder.doActions(state, i) && (state.getLastActionFinishTime() < _bestFinishTime))
+                {
+                    _bestFinishTime = state.getLastActionFinishTime();
+                    _improvedThisPass = true;
+                }
+                else
+                {
+                    _buildOrder[i + 1] = _buildOrder[i];
+                    _buildOrder[i] = first;
+                }
+            }
+
+            _improvementState.doAction(_buildOrder[i]);
+        }
+
+        _improvementIndex = 0;
+        _improvementPass++;
+
+        if (!_improvedThisPass)
+        {
+            break;
+        }
+    }
+
+    _phase = DonePhase;
+    return true;
+}
+
+void MilestoneBuildOrderSearch::finishSearch()
+{
+    // a milestone whose search and naive build order both fail can leave the goal unreached, such as a zerg
+    // state whose only hatchery became a lair, which the searches don't count as a resource depot
+    bool reachedGoal = _params.goal.isAchievedBy(_state);
+    FrameCountType finishTime = reachedGoal ? _buildOrder.getCompletionTime(_params.initialState) : 0;
+
+    // the seed and the unfinished whole goal search's build order both reach the goal, use whichever finishes soonest
+    for (const BuildOrder * other : { &_params.seedBuildOrder, &_wholeGoalBuildOrder })
+    {
+        if (other->empty())
+        {
+            continue;
+        }
+
+        const FrameCountType otherFinishTime = other->getCompletionTime(_params.initialState);
+        if (!reachedGoal || (otherFinishTime < finishTime))
+        {
+            _buildOrder = *other;
+            finishTime = otherFinishTime;
+            reachedGoal = true;
+        }
+    }
+
+    if (!reachedGoal)
+    {
+        _buildOrder.clear();
+    }
+
+    _results.finalState = _params.initialState;
+    _buildOrder.doActions(_results.finalState);
+
+    // the build order is not proven the best, so the search is finished but not solved
+    _results.buildOrder = _buildOrder;
+    _results.upperBound = _results.finalState.getLastActionFinishTime();
+    _results.solved = false;
+    _results.solutionFound = reachedGoal;
+}
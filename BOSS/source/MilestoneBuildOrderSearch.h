@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "BuildOrder.h"
+#include "DFBB_BuildOrderSearchParameters.h"
+#include "DFBB_BuildOrderSearchResults.h"
+#include "Timer.hpp"
+
+#include <memory>
+
+namespace BOSS
+{
+
+class DFBB_BuildOrderSmartSearch;
+
+// splits a large goal into milestones and solves them one after another with DFBB
+// DFBB takes exponentially longer as the goal grows, so a goal of several small milestones is solved in
+// about the time of its milestones added up. each milestone's goal includes the ones before it and is
+// searched from the state the previous milestone's build order ended in, and the build orders are joined.
+// the goal actions are put in milestones in order of how deep their prerequisites go, so a milestone
+// never needs tech from a later one. the joined build order is the best one for each milestone, not
+// for the whole goal, which the optional swapping of adjacent actions at the end makes up some of
+// so the whole goal is first searched with DFBB for wholeGoalTimeLimit, and only split into milestones
+// if that doesn't finish. a finished DFBB search is solved, the milestones never are
+class MilestoneBuildOrderSearch
+{
+    enum Phase { WholeGoalPhase, MilestonePhase, ImprovementPhase, DonePhase };
+
+    DFBB_BuildOrderSearchParameters     _params;
+    DFBB_BuildOrderSearchResults        _results;
+
+    Timer                               _searchTimer;
+    Phase                               _phase;
+
+    std::shared_ptr<DFBB_BuildOrderSmartSearch> _wholeGoalSearch;
+    double                              _wholeGoalTime;         // milliseconds the whole goal has been searched for
+    BuildOrder                          _wholeGoalBuildOrder;   // the best build order the unfinished whole goal search found
+
+    std::vector<BuildOrderSearchGoal>   _milestones;
+    size_t                              _milestoneIndex;        // the milestone being searched
+    std::shared_ptr<DFBB_BuildOrderSmartSearch> _milestoneSearch;
+    double                              _milestoneTime;         // milliseconds the current milestone has been searched for
+    unsigned long long                  _previousNodes;         // nodes expanded by the finished searches
+    DFBB_SearchStats                    _previousStats;         // stats of the finished searches
+
+    GameState                           _state;                 // the state the finished milestones end in
+    BuildOrder                          _buildOrder;            // the finished milestones' build orders joined
+
+    size_t                              _improvementPass;       // where the swapping of adjacent actions is up to
+    size_t                              _improvementIndex;
+    bool                                _improvedThisPass;
+    FrameCountType                      _bestFinishTime;
+    GameState                           _improvementState;      // the state before the actions at _improvementIndex
+
+    bool                                _firstSearch;
+
+    bool                                outOfBudget(const DFBB_SearchBudget & budget, unsigned long long nodes);
+    bool                                pause();
+    bool                                searchWholeGoal(const DFBB_SearchBudget & budget, unsigned long long & nodes);
+    bool                                searchMilestones(const DFBB_SearchBudget & budget, unsigned long long & nodes);
+    void                                makeMilestones();
+    void                                startMilestone();
+    void                                finishMilestone();
+    void                                startImprovement();
+    bool                                improveBuildOrder(const DFBB_SearchBudget & budget);
+    void                                finishSearch();
+
+public:
+
+    MilestoneBuildOrderSearch(const DFBB_BuildOrderSearchParameters & p);
+
+    void search();
+    bool search(const DFBB_SearchBudget & budget);
+    const DFBB_BuildOrderSearchResults & getResults() const;
+    size_t getNumMilestones() const;
+};
+
+}
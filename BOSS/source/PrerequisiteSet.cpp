@@ -25,6 +25,7 @@ const UnitCountType & ActionCountPair::getCount() const
 }
 
 PrerequisiteSet::PrerequisiteSet()
+    : _singleCounts(true)
 {
 
 }
@@ -61,10 +62,49 @@ const UnitCountType & PrerequisiteSet::getActionTypeCount(const UnitCountType in
 {
     return _actionCounts[index].getCount();
 }
+
+const ActionMask & PrerequisiteSet::getMask() const
+{
+    return _mask;
+}
+
+const bool PrerequisiteSet::hasSingleCounts() const
+{
+    return _singleCounts;
+}
     
 void PrerequisiteSet::add(const ActionType & action, const UnitCountType count)
 {
     _actionCounts.push_back(ActionCountPair(action, count));
+
+    if (count > 0)
+    {
+        _mask.add(action);
+    }
+
+    if (count > 1)
+    {
+        _singleCounts = false;
+    }
+}
+
+void PrerequisiteSet::updateMask()
+{
+    _mask.clear();
+    _singleCounts = true;
+
+    for (size_t i(0); i<_actionCounts.size(); ++i)
+    {
+        if (getActionTypeCount(i) > 0)
+        {
+            _mask.add(getActionType(i));
+        }
+
+        if (getActionTypeCount(i) > 1)
+        {
+            _singleCounts = false;
+        }
+    }
 }
 
 void PrerequisiteSet::addUnique(const ActionType & action, const UnitCountType count)
@@ -90,6 +130,7 @@ void PrerequisiteSet::remove(const ActionType & action)
         if (_actionCounts[i].getAction() == action)
         {
             _actionCounts.remove(i);
+            updateMask();
             return;
         }
     }
@@ -4,6 +4,7 @@
 #include "Constants.h"
 #include "Array.hpp"
 #include "ActionType.h"
+#include "ActionMask.h"
 
 namespace BOSS
 {
@@ -27,6 +28,10 @@ public:
 class PrerequisiteSet
 {
 	Vec<ActionCountPair, Constants::MAX_ACTION_TYPES> _actionCounts;
+    ActionMask                                        _mask;              // the actions with a count of at least one
+    bool                                              _singleCounts;      // true if no action needs more than one, so the mask alone describes the set
+
+    void updateMask();
 
 public:
 
@@ -37,6 +42,8 @@ public:
     const bool contains(const ActionType & action) const;
     const ActionType & getActionType(const UnitCountType index) const;
     const UnitCountType & getActionTypeCount(const UnitCountType index) const;
+    const ActionMask & getMask() const;
+    const bool hasSingleCounts() const;
     
     void add(const ActionType & action, const UnitCountType count = 1);
     void addUnique(const ActionType & action, const UnitCountType count = 1);
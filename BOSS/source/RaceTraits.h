@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Common.h"
+
+namespace BOSS
+{
+
+// the rules that differ between the races, known at compile time so the race specific
+// versions of the GameState and UnitData functions only keep the branches for their race
+template <RaceID race>
+class RaceTraits
+{
+public:
+
+    static constexpr bool   usesLarva                   = (race == Races::Zerg);        // units come from larva, buildings morph from drones
+    static constexpr bool   hasMorphedPrerequisites     = (race == Races::Zerg);        // a lair or hive counts as a hatchery, a greater spire as a spire
+    static constexpr bool   workerFreeWhileBuilding     = (race == Races::Protoss);     // probes warp buildings in and go straight back to mining
+    static constexpr bool   workerBusyWhileBuilding     = (race == Races::Terran);      // scvs build until the building finishes
+    static constexpr int    workersRequiredToBuild      = workerFreeWhileBuilding ? 0 : 1;
+};
+
+// calls function<race>(args) for the race known only at run time, which is done once at the top of
+// the hot code rather than in every function it calls
+#define BOSS_RACE_DISPATCH(race, function, ...)                                                      \
+    switch (race)                                                                                   \
+    {                                                                                               \
+        case Races::Protoss:    return function<Races::Protoss>(__VA_ARGS__);                      \
+        case Races::Terran:     return function<Races::Terran>(__VA_ARGS__);                       \
+        case Races::Zerg:       return function<Races::Zerg>(__VA_ARGS__);                         \
+        default:                BOSS_ASSERT(false, "No race specific version for race %d", (int)(race)); \
+    }
+
+}
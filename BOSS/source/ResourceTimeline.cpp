@@ -0,0 +1,155 @@
+#include "ResourceTimeline.h"
+#include "UnitData.h"
+
+using namespace BOSS;
+
+ResourceTimeline::ResourceTimeline()
+    : _numProcessed(0)
+    , _valid(false)
+{
+
+}
+
+// starts a new timeline at the current frame with the current workers, nothing past it is known yet
+void ResourceTimeline::reset(const UnitData & units, const FrameCountType currentFrame)
+{
+    _breakpoints.clear();
+    _numProcessed = 0;
+
+    ResourceBreakpoint start;
+    start.frame             = currentFrame;
+    start.mineralWorkers    = units.getNumMineralWorkers();
+    start.gasWorkers        = units.getNumGasWorkers();
+    _breakpoints.push_back(start);
+
+    _valid = true;
+}
+
+void ResourceTimeline::invalidate()
+{
+    _valid = false;
+}
+
+const bool ResourceTimeline::isValid() const
+{
+    return _valid;
+}
+
+// walks the actions in progress in the order they finish, adding a breakpoint whenever the worker counts change
+// the worker changes are the same ones UnitData makes when it finishes the action
+// stops once the amount is gathered before the next action finishes, so the timeline ends in the segment it's reached in
+void ResourceTimeline::extend(const UnitData & units, const RaceID race, const ResourceCountType amount, const bool gas)
+{
+    const size_t numInProgress = units.getNumActionsInProgress();
+
+    while (_numProcessed < numInProgress)
+    {
+        // the actions in progress are sorted in descending order of finish time
+        const size_t progressIndex = numInProgress - _numProcessed - 1;
+        const ResourceBreakpoint & last = _breakpoints[_breakpoints.size() - 1];
+        const FrameCountType frame = units.getFinishTimeByIndex(progressIndex);
+        const FrameCountType elapsed = frame - last.frame;
+
+        const ResourceCountType minerals = last.minerals + elapsed * last.mineralWorkers * Constants::MPWPF;
+        const ResourceCountType gasGathered = last.gas + elapsed * last.gasWorkers * Constants::GPWPF;
+
+        if ((gas ? gasGathered : minerals) >= amount)
+        {
+            return;
+        }
+
+        ++_numProcessed;
+
+        const ActionType & action = units.getActionInProgressByIndex(progressIndex);
+        UnitCountType mineralWorkers = last.mineralWorkers;
+        UnitCountType gasWorkers     = last.gasWorkers;
+
+        // finishing a building as terran gives you a mineral worker back
+        if (action.isBuilding() && !action.isAddon() && (race == Races::Terran))
+        {
+            mineralWorkers++;
+        }
+
+        if (action.isWorker())
+        {
+            mineralWorkers++;
+        }
+        else if (action.isRefinery())
+        {
+            BOSS_ASSERT(mineralWorkers > 3, "Not enough mineral workers \n");
+            mineralWorkers -= 3;
+            gasWorkers += 3;
+        }
+
+        if ((mineralWorkers == last.mineralWorkers) && (gasWorkers == last.gasWorkers))
+        {
+            continue;
+        }
+
+        ResourceBreakpoint next;
+        next.frame          = frame;
+        next.minerals       = minerals;
+        next.gas            = gasGathered;
+        next.mineralWorkers = mineralWorkers;
+        next.gasWorkers     = gasWorkers;
+        _breakpoints.push_back(next);
+    }
+}
+
+// finds the last breakpoint that has gathered less than amount, the amount is reached in the segment after it
+const FrameCountType ResourceTimeline::whenGathered(const UnitData & units, const RaceID race, const ResourceCountType amount, const bool gas)
+{
+    BOSS_ASSERT(_valid, "Resource timeline used before it was reset");
+
+    if (amount <= 0)
+    {
+        return _breakpoints[0].frame;
+    }
+
+    const ResourceBreakpoint & last = _breakpoints[_breakpoints.size() - 1];
+    if ((gas ? last.gas : last.minerals) < amount)
+    {
+        extend(units, race, amount, gas);
+    }
+
+    // binary search for the first breakpoint which has gathered at least amount, breakpoint 0 has gathered nothing
+    size_t low = 1;
+    size_t high = _breakpoints.size();
+    while (low < high)
+    {
+        const size_t mid = (low + high) / 2;
+        const ResourceCountType gathered = gas ? _breakpoints[mid].gas : _breakpoints[mid].minerals;
+
+        if (gathered < amount)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    const ResourceBreakpoint & point = _breakpoints[low - 1];
+    const ResourceCountType gathered = gas ? point.gas : point.minerals;
+    const ResourceCountType perFrame = gas ? (point.gasWorkers * Constants::GPWPF) : (point.mineralWorkers * Constants::MPWPF);
+
+    BOSS_ASSERT(perFrame > 0, "Shouldn't have 0 %s workers", gas ? "gas" : "mineral");
+    if (perFrame == 0)
+    {
+        return point.frame + 1000000;
+    }
+
+    // round up, since the whole amount has to be gathered
+    return point.frame + (amount - gathered + perFrame - 1) / perFrame;
+}
+
+const FrameCountType ResourceTimeline::whenMineralsGathered(const UnitData & units, const RaceID race, const ResourceCountType amount)
+{
+    return whenGathered(units, race, amount, false);
+}
+
+const FrameCountType ResourceTimeline::whenGasGathered(const UnitData & units, const RaceID race, const ResourceCountType amount)
+{
+    return whenGathered(units, race, amount, true);
+}
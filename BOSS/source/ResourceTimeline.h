@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Common.h"
+#include "Array.hpp"
+
+namespace BOSS
+{
+
+class UnitData;
+
+// one point where the income rate changes, with the income gathered since the timeline's start frame
+class ResourceBreakpoint
+{
+public:
+
+    FrameCountType      frame;
+    ResourceCountType   minerals;           // minerals gathered from the start frame up to this frame
+    ResourceCountType   gas;                // gas gathered from the start frame up to this frame
+    UnitCountType       mineralWorkers;     // workers gathering from this frame until the next breakpoint
+    UnitCountType       gasWorkers;
+
+    ResourceBreakpoint()
+        : frame(0)
+        , minerals(0)
+        , gas(0)
+        , mineralWorkers(0)
+        , gasWorkers(0)
+    {
+
+    }
+};
+
+// piecewise linear income of a state from its current frame on, assuming nothing new is queued
+// the rate changes only when an action in progress finishes and changes the number of gathering workers
+// breakpoints are only added as far as a query needs them, so every query at a state after the first
+// one that reaches as far is a binary search over the gathered amounts, which only ever go up
+class ResourceTimeline
+{
+    Vec<ResourceBreakpoint, Constants::MAX_PROGRESS + 1> _breakpoints;
+    size_t                                              _numProcessed;      // actions in progress looked at so far, soonest first
+    bool                                                _valid;
+
+    void                    extend(const UnitData & units, const RaceID race, const ResourceCountType amount, const bool gas);
+    const FrameCountType    whenGathered(const UnitData & units, const RaceID race, const ResourceCountType amount, const bool gas);
+
+public:
+
+    ResourceTimeline();
+
+    void                    reset(const UnitData & units, const FrameCountType currentFrame);
+    void                    invalidate();
+    const bool              isValid() const;
+
+    // the first frame at which this much more of the resource has been gathered
+    // units must be the ones the timeline was reset with
+    const FrameCountType    whenMineralsGathered(const UnitData & units, const RaceID race, const ResourceCountType amount);
+    const FrameCountType    whenGasGathered(const UnitData & units, const RaceID race, const ResourceCountType amount);
+};
+
+}
@@ -0,0 +1,319 @@
+#include "SearchReplay.h"
+
+#include <cstdint>
+#include <cstring>
+
+using namespace BOSS;
+
+namespace
+{
+    const uint32_t ReplayMagic      = 0x52534f42;   // "BOSR"
+    const uint32_t ReplayVersion    = 1;
+    const int16_t  NoAction         = -1;
+
+    // every platform the bot runs on is little endian, so values are written as they are in memory
+    template <class T>
+    void Put(std::ostream & out, const T value)
+    {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <class T>
+    T Get(std::istream & in)
+    {
+        T value = 0;
+        in.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return value;
+    }
+
+    void PutAction(std::ostream & out, const ActionType & action)
+    {
+        Put<int16_t>(out, action.getRace() == Races::None ? NoAction : (int16_t)action.ID());
+    }
+
+    ActionType GetAction(std::istream & in, const RaceID race)
+    {
+        const int16_t id = Get<int16_t>(in);
+        if (id == NoAction || id < 0 || (size_t)id >= ActionTypes::GetAllActionTypes(race).size())
+        {
+            if (id != NoAction)
+            {
+                in.setstate(std::ios::failbit);
+            }
+            return ActionType();
+        }
+
+        return ActionTypes::GetActionType(race, (ActionID)id);
+    }
+
+    void WriteProblem(std::ostream & out, const SearchReplayProblem & problem)
+    {
+        const GameStateRecipe & state = problem.state;
+        const RaceID race = state.race;
+
+        Put<int32_t>(out, problem.gameFrame);
+
+        Put<uint8_t>(out, (uint8_t)race);
+        Put<int32_t>(out, state.frame);
+        Put<int32_t>(out, state.minerals);
+        Put<int32_t>(out, state.gas);
+        Put<uint32_t>(out, (uint32_t)state.steps.size());
+        for (const GameStateRecipeStep & step : state.steps)
+        {
+            Put<uint8_t>(out, (uint8_t)step.type);
+            PutAction(out, step.action);
+            Put<int32_t>(out, step.time);
+            PutAction(out, step.constructing);
+            PutAction(out, step.addon);
+            Put<uint8_t>(out, (uint8_t)step.numLarva);
+        }
+
+        // only the actions with a goal or a maximum
+        std::vector<ActionID> goalActions;
+        for (ActionID a(0); a < ActionTypes::GetAllActionTypes(race).size(); ++a)
+        {
+            const ActionType & action = ActionTypes::GetActionType(race, a);
+            if (problem.goal.getGoal(action) > 0 || problem.goal.getGoalMax(action) > 0)
+            {
+                goalActions.push_back(a);
+            }
+        }
+
+        Put<uint16_t>(out, (uint16_t)goalActions.size());
+        for (const ActionID a : goalActions)
+        {
+            const ActionType & action = ActionTypes::GetActionType(race, a);
+            Put<int16_t>(out, (int16_t)a);
+            Put<uint16_t>(out, (uint16_t)problem.goal.getGoal(action));
+            Put<uint16_t>(out, (uint16_t)problem.goal.getGoalMax(action));
+        }
+
+        Put<uint8_t>(out, (uint8_t)problem.engine);
+        Put<uint8_t>(out, (uint8_t)problem.numThreads);
+
+        Put<uint16_t>(out, (uint16_t)problem.seeds.size());
+        for (const BuildOrder & seed : problem.seeds)
+        {
+            Put<uint16_t>(out, (uint16_t)seed.size());
+            for (size_t i(0); i < seed.size(); ++i)
+            {
+                PutAction(out, seed[i]);
+            }
+        }
+
+        Put<uint32_t>(out, (uint32_t)problem.frameBudgets.size());
+        for (const double budget : problem.frameBudgets)
+        {
+            Put<float>(out, (float)budget);
+        }
+        Put<uint8_t>(out, problem.background ? 1 : 0);
+        Put<float>(out, (float)problem.backgroundSliceMS);
+        Put<float>(out, (float)problem.backgroundTimeLimitMS);
+
+        Put<uint8_t>(out, problem.finished ? 1 : 0);
+        Put<uint8_t>(out, problem.solved ? 1 : 0);
+        Put<uint8_t>(out, problem.solutionFound ? 1 : 0);
+        Put<uint64_t>(out, problem.nodesExpanded);
+        Put<float>(out, (float)problem.timeElapsed);
+        Put<uint16_t>(out, (uint16_t)problem.buildOrderSize);
+    }
+
+    bool ReadProblem(std::istream & in, SearchReplayProblem & problem)
+    {
+        problem.gameFrame = Get<int32_t>(in);
+
+        const RaceID race = (RaceID)Get<uint8_t>(in);
+        if (!in.good() || race >= Races::NUM_RACES)
+        {
+            return false;
+        }
+
+        GameStateRecipe & state = problem.state;
+        state = GameStateRecipe(race);
+        state.frame    = Get<int32_t>(in);
+        state.minerals = Get<int32_t>(in);
+        state.gas      = Get<int32_t>(in);
+
+        const uint32_t numSteps = Get<uint32_t>(in);
+        for (uint32_t s(0); s < numSteps && in.good(); ++s)
+        {
+            GameStateRecipeStep step((GameStateRecipeStep::Type)Get<uint8_t>(in));
+            step.action       = GetAction(in, race);
+            step.time         = Get<int32_t>(in);
+            step.constructing = GetAction(in, race);
+            step.addon        = GetAction(in, race);
+            step.numLarva     = Get<uint8_t>(in);
+
+            if (step.type > GameStateRecipeStep::CompletedAction || step.action.getRace() == Races::None)
+            {
+                return false;
+            }
+
+            state.steps.push_back(step);
+        }
+
+        problem.goal = BuildOrderSearchGoal(race);
+        const uint16_t numGoals = Get<uint16_t>(in);
+        for (uint16_t g(0); g < numGoals && in.good(); ++g)
+        {
+            const ActionType action = GetAction(in, race);
+            const UnitCountType goal = Get<uint16_t>(in);
+            const UnitCountType goalMax = Get<uint16_t>(in);
+
+            if (action.getRace() == Races::None)
+            {
+                return false;
+            }
+
+            problem.goal.setGoal(action, goal);
+            problem.goal.setGoalMax(action, goalMax);
+        }
+
+        const uint8_t engine = Get<uint8_t>(in);
+        problem.engine     = engine <= SearchEngines::Milestones ? (SearchEngines::SearchEngine)engine : SearchEngines::DFBB;
+        problem.numThreads = Get<uint8_t>(in);
+
+        const uint16_t numSeeds = Get<uint16_t>(in);
+        for (uint16_t s(0); s < numSeeds && in.good(); ++s)
+        {
+            BuildOrder seed;
+            const uint16_t size = Get<uint16_t>(in);
+            for (uint16_t i(0); i < size && in.good(); ++i)
+            {
+                seed.add(GetAction(in, race));
+            }
+            problem.seeds.push_back(seed);
+        }
+
+        const uint32_t numBudgets = Get<uint32_t>(in);
+        for (uint32_t b(0); b < numBudgets && in.good(); ++b)
+        {
+            problem.frameBudgets.push_back(Get<float>(in));
+        }
+        problem.background            = Get<uint8_t>(in) != 0;
+        problem.backgroundSliceMS     = Get<float>(in);
+        problem.backgroundTimeLimitMS = Get<float>(in);
+
+        problem.finished       = Get<uint8_t>(in) != 0;
+        problem.solved         = Get<uint8_t>(in) != 0;
+        problem.solutionFound  = Get<uint8_t>(in) != 0;
+        problem.nodesExpanded  = Get<uint64_t>(in);
+        problem.timeElapsed    = Get<float>(in);
+        problem.buildOrderSize = Get<uint16_t>(in);
+
+        return in.good();
+    }
+}
+
+SearchReplayProblem::SearchReplayProblem()
+    : gameFrame(0)
+    , engine(SearchEngines::DFBB)
+    , numThreads(1)
+    , background(false)
+    , backgroundSliceMS(0)
+    , backgroundTimeLimitMS(0)
+    , finished(false)
+    , solved(false)
+    , solutionFound(false)
+    , nodesExpanded(0)
+    , timeElapsed(0)
+    , buildOrderSize(0)
+{
+
+}
+
+bool SearchReplay::Write(const std::string & filename, const std::vector<SearchReplayProblem> & problems)
+{
+    std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out.good())
+    {
+        return false;
+    }
+
+    Put<uint32_t>(out, ReplayMagic);
+    Put<uint32_t>(out, ReplayVersion);
+    Put<uint32_t>(out, (uint32_t)problems.size());
+
+    for (const SearchReplayProblem & problem : problems)
+    {
+        WriteProblem(out, problem);
+    }
+
+    return out.good();
+}
+
+// the problems before any damage in the file are kept
+bool SearchReplay::Read(const std::string & filename, std::vector<SearchReplayProblem> & problems)
+{
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    if (!in.good() || Get<uint32_t>(in) != ReplayMagic || Get<uint32_t>(in) != ReplayVersion)
+    {
+        return false;
+    }
+
+    const uint32_t numProblems = Get<uint32_t>(in);
+    for (uint32_t p(0); p < numProblems; ++p)
+    {
+        SearchReplayProblem problem;
+        if (!ReadProblem(in, problem))
+        {
+            return false;
+        }
+
+        problems.push_back(problem);
+    }
+
+    return true;
+}
+
+// set up the same way BOSSManager::startNewSearch sets up its search, and resumed the way BOSSManager resumes it
+DFBB_BuildOrderSearchResults SearchReplay::Run(const SearchReplayProblem & problem, const int numThreads)
+{
+    DFBB_BuildOrderSmartSearch search(problem.state.race);
+    search.setGoal(problem.goal);
+    search.setState(GameState(problem.state));
+    search.setNumThreads(numThreads);
+    search.setEngine(problem.engine);
+
+    for (const BuildOrder & seed : problem.seeds)
+    {
+        search.addSeed(seed);
+    }
+
+    double timeElapsed = 0;
+
+    if (problem.background)
+    {
+        Timer timer;
+        timer.start();
+
+        while (true)
+        {
+            const bool finished = search.search(DFBB_SearchBudget(problem.backgroundSliceMS));
+            timeElapsed += search.getResults().timeElapsed;
+
+            if (finished || (timer.getElapsedTimeInMilliSec() > problem.backgroundTimeLimitMS))
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        for (const double budget : problem.frameBudgets)
+        {
+            const bool finished = search.search(DFBB_SearchBudget(budget));
+            timeElapsed += search.getResults().timeElapsed;
+
+            if (finished)
+            {
+                break;
+            }
+        }
+    }
+
+    DFBB_BuildOrderSearchResults results = search.getResults();
+    results.timeElapsed = timeElapsed;
+
+    return results;
+}
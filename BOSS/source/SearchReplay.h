@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "GameStateRecipe.h"
+#include "BuildOrder.h"
+#include "BuildOrderSearchGoal.h"
+#include "DFBB_BuildOrderSmartSearch.h"
+
+namespace BOSS
+{
+
+// a build order search as a game issued it and the time it was given, saved so it can be run again offline
+class SearchReplayProblem
+{
+public:
+
+    int                                 gameFrame;              // the game frame the search started on
+    GameStateRecipe                     state;
+    BuildOrderSearchGoal                goal;
+    SearchEngines::SearchEngine         engine;
+    int                                 numThreads;
+    std::vector<BuildOrder>             seeds;                  // in the order they were added to the search
+
+    // a search run in each frame's leftover time gets one budget per frame until it finishes
+    // a background search gets slices of backgroundSliceMS until backgroundTimeLimitMS of wall clock time has passed
+    std::vector<double>                 frameBudgets;
+    bool                                background;
+    double                              backgroundSliceMS;
+    double                              backgroundTimeLimitMS;
+
+    // what the search found in the game, to compare a replay with
+    bool                                finished;               // false if the search was cancelled for a new one
+    bool                                solved;
+    bool                                solutionFound;
+    unsigned long long                  nodesExpanded;
+    double                              timeElapsed;
+    size_t                              buildOrderSize;
+
+    SearchReplayProblem();
+};
+
+// replay files are little endian with fixed size fields, so a file written by the bot can be read on any platform
+namespace SearchReplay
+{
+    bool Write(const std::string & filename, const std::vector<SearchReplayProblem> & problems);
+    bool Read(const std::string & filename, std::vector<SearchReplayProblem> & problems);
+
+    // runs the search again with the same time slicing, the results have the total search time of all the slices
+    DFBB_BuildOrderSearchResults Run(const SearchReplayProblem & problem, const int numThreads);
+}
+
+}
@@ -1,4 +1,5 @@
 #include "UnitData.h"
+#include "GameStateUndo.h"
 
 using namespace BOSS;
 
@@ -24,6 +25,32 @@ const UnitCountType UnitData::getNumCompleted(const ActionType & action) const
     return _numUnits[action.ID()];
 }
 
+void UnitData::setNumCompleted(const ActionType & action, const UnitCountType & num, GameStateUndo * undo)
+{
+    if (undo)
+    {
+        undo->numCompleted.push_back(std::make_pair(action.ID(), _numUnits[action.ID()]));
+    }
+
+    _unitHash.remove(Hash::UnitCount, Hash::ActionKey(action), _numUnits[action.ID()]);
+    _numUnits[action.ID()] = num;
+    _unitHash.add(Hash::UnitCount, Hash::ActionKey(action), num);
+
+    updateTotalMask(action);
+}
+
+void UnitData::updateTotalMask(const ActionType & action)
+{
+    if (_numUnits[action.ID()] > 0 || _progress.numInProgress(action) > 0)
+    {
+        _totalMask.add(action);
+    }
+    else
+    {
+        _totalMask.remove(action);
+    }
+}
+
 void UnitData::setCurrentSupply(const UnitCountType & supply)
 {
     _currentSupply = supply;
@@ -37,7 +64,7 @@ const FrameCountType UnitData::getWhenBuildingCanBuild(const ActionType & action
 // only used for adding existing buildings from a BWAPI Game * object
 void UnitData::addCompletedBuilding(const ActionType & action, const FrameCountType timeUntilFree, const ActionType & constructing, const ActionType & addon, int numLarva)
 {
-    _numUnits[action.ID()] += action.numProduced();
+    setNumCompleted(action, _numUnits[action.ID()] + action.numProduced());
 
     _maxSupply += action.supplyProvided();
 
@@ -61,12 +88,12 @@ void UnitData::addCompletedBuilding(const ActionType & action, const FrameCountT
     }
 }
 
-void UnitData::addCompletedAction(const ActionType & action, bool wasBuilt)
+void UnitData::addCompletedAction(const ActionType & action, bool wasBuilt, GameStateUndo * undo)
 {
     const static ActionType Lair = ActionTypes::GetActionType("Zerg_Lair");
     const static ActionType Hive = ActionTypes::GetActionType("Zerg_Hive");
 
-    _numUnits[action.ID()] += wasBuilt ? action.numProduced() : 1;
+    setNumCompleted(action, _numUnits[action.ID()] + (wasBuilt ? action.numProduced() : 1), undo);
 
     if (wasBuilt)
     {
@@ -115,7 +142,7 @@ void UnitData::removeCompletedAction(const ActionType & action)
 	const static ActionType Lair = ActionTypes::GetActionType("Zerg_Lair");
 	const static ActionType Hive = ActionTypes::GetActionType("Zerg_Hive");
 
-	_numUnits[action.ID()] -= action.numProduced();
+	setNumCompleted(action, _numUnits[action.ID()] - action.numProduced());
 
 
 		// a lair or hive from a hatchery don't produce additional supply
@@ -161,12 +188,13 @@ void UnitData::removeCompletedAction(const ActionType & action)
 	}
 }
 
-void UnitData::addActionInProgress(const ActionType & action, const FrameCountType & completionFrame, bool queueAction)
+void UnitData::addActionInProgress(const ActionType & action, const FrameCountType & completionFrame, bool queueAction, GameStateUndo * undo)
 {
     FrameCountType finishTime = (action.isBuilding() && !action.isMorphed()) ? completionFrame + Constants::BUILDING_PLACEMENT : completionFrame;
 
 	// add it to the actions in progress
-	_progress.addAction(action, finishTime);
+	_progress.addAction(action, finishTime, undo);
+    updateTotalMask(action);
     
     if (!action.isMorphed())
     {
@@ -177,7 +205,7 @@ void UnitData::addActionInProgress(const ActionType & action, const FrameCountTy
 	{
 		// add it to a free building, which MUST be free since it's called from doAction
 		// which must be already fastForwarded to the correct time
-		_buildings.queueAction(action);
+		_buildings.queueAction(action, undo);
 	}
 }
 
@@ -196,6 +224,21 @@ const SupplyCountType UnitData::getMaxSupply() const
     return _maxSupply;
 }
 
+// the unit, progress, building and larva hashes are maintained incrementally
+// the remaining small scalar values are folded in when the hash is requested
+const HashValues UnitData::getHash() const
+{
+    HashValues hash(_unitHash);
+    hash.add(_progress.getHash());
+    hash.add(_buildings.getHash());
+    hash.add(_hatcheryData.getHash());
+    hash.add(Hash::Workers, _mineralWorkers | (_gasWorkers << 16), _buildingWorkers);
+    hash.add(Hash::Supply, _maxSupply, _currentSupply);
+    hash.add(Hash::Race, _race, 0);
+
+    return hash;
+}
+
 void UnitData::setBuildingWorker()
 {
     BOSS_ASSERT(_mineralWorkers > 0, "Tried to build without a worker");
@@ -235,10 +278,10 @@ void UnitData::setBuildingWorkers(const UnitCountType & buildingWorkers)
     _buildingWorkers = buildingWorkers;
 }
 
-void UnitData::morphUnit(const ActionType & from, const ActionType & to, const FrameCountType & completionFrame)
+void UnitData::morphUnit(const ActionType & from, const ActionType & to, const FrameCountType & completionFrame, GameStateUndo * undo)
 {
     BOSS_ASSERT(getNumCompleted(from) > 0, "Must have the unit type to morph it");
-    _numUnits[from.ID()]--;
+    setNumCompleted(from, _numUnits[from.ID()] - 1, undo);
     _currentSupply -= from.supplyRequired();
 
     if (from.isWorker())
@@ -247,7 +290,45 @@ void UnitData::morphUnit(const ActionType & from, const ActionType & to, const F
         _mineralWorkers--;
     }
 
-    addActionInProgress(to, completionFrame);
+    addActionInProgress(to, completionFrame, true, undo);
+}
+
+// saves the values needed to undo an action, the containers record their own changes as they happen
+void UnitData::saveUndo(GameStateUndo & undo) const
+{
+    undo.mineralWorkers     = _mineralWorkers;
+    undo.gasWorkers         = _gasWorkers;
+    undo.buildingWorkers    = _buildingWorkers;
+    undo.maxSupply          = _maxSupply;
+    undo.currentSupply      = _currentSupply;
+    undo.unitHash           = _unitHash;
+    undo.totalMask          = _totalMask;
+    undo.hatcheryData       = _hatcheryData;
+    undo.numCompleted.clear();
+
+    _progress.saveUndo(undo);
+    _buildings.saveUndo(undo);
+}
+
+void UnitData::restore(const GameStateUndo & undo)
+{
+    _buildings.restore(undo);
+    _progress.restore(undo);
+
+    // the unit hash is restored whole below so the counts can be written directly
+    for (size_t i(undo.numCompleted.size()); i > 0; --i)
+    {
+        _numUnits[undo.numCompleted[i-1].first] = undo.numCompleted[i-1].second;
+    }
+
+    _mineralWorkers     = undo.mineralWorkers;
+    _gasWorkers         = undo.gasWorkers;
+    _buildingWorkers    = undo.buildingWorkers;
+    _maxSupply          = undo.maxSupply;
+    _currentSupply      = undo.currentSupply;
+    _unitHash           = undo.unitHash;
+    _totalMask          = undo.totalMask;
+    _hatcheryData       = undo.hatcheryData;
 }
 
 const UnitCountType UnitData::getNumMineralWorkers() const
@@ -265,18 +346,26 @@ const UnitCountType UnitData::getNumBuildingWorkers() const
     return _buildingWorkers;
 }
 
-ActionType UnitData::finishNextActionInProgress() 
+ActionType UnitData::finishNextActionInProgress(GameStateUndo * undo) 
+{
+    BOSS_RACE_DISPATCH(_race, finishNextActionInProgress, undo);
+    return ActionTypes::None;
+}
+
+template <RaceID race>
+ActionType UnitData::finishNextActionInProgress(GameStateUndo * undo) 
 {	
 	// get the actionUnit from the progress data
 	ActionType action = _progress.nextAction();
 
 	// add the unit to the unit counter
-	addCompletedAction(action);
+	addCompletedAction(action, true, undo);
 			
 	// pop it from the progress vector
-	_progress.popNextAction();
+	_progress.popNextAction(undo);
+    updateTotalMask(action);
 			
-	if (getRace() == Races::Terran)
+	if (RaceTraits<race>::workerBusyWhileBuilding)
 	{
 		// if it's a building, release the worker back
 		if (action.isBuilding() && !action.isAddon())
@@ -284,11 +373,6 @@ ActionType UnitData::finishNextActionInProgress()
 			releaseBuildingWorker();
 		}
 	}
-	else if (getRace() == Races::Zerg)
-	{
-        const static ActionType hatchery = ActionTypes::GetActionType("Zerg_Hatchery");
-
-	}
 
 	return action;
 }
@@ -303,9 +387,9 @@ const FrameCountType UnitData::getNextBuildingFinishTime() const
     return _progress.nextBuildingFinishTime();
 }
 
-void UnitData::setBuildingFrame(const FrameCountType & frame)
+void UnitData::setBuildingFrame(const FrameCountType & frame, GameStateUndo * undo)
 {
-    _buildings.fastForwardBuildings(frame);
+    _buildings.fastForwardBuildings(frame, undo);
 }
 
 const UnitCountType UnitData::getNumTotal(const ActionType & action) const
@@ -313,8 +397,49 @@ const UnitCountType UnitData::getNumTotal(const ActionType & action) const
     return _numUnits[action.ID()] + (_progress.numInProgress(action) * action.numProduced());
 }
 
+const ActionMask UnitData::getPrerequisiteMask() const
+{
+    BOSS_RACE_DISPATCH(_race, getPrerequisiteMask, );
+    return _totalMask;
+}
+
+// the actions we have at least one of, counting zerg buildings as the buildings they morphed from
+template <RaceID race>
+const ActionMask UnitData::getPrerequisiteMask() const
+{
+    static const ActionMaskType Hatchery      = ActionMask::Bit(ActionTypes::GetActionType("Zerg_Hatchery"));
+    static const ActionMaskType Lair          = ActionMask::Bit(ActionTypes::GetActionType("Zerg_Lair"));
+    static const ActionMaskType Hive          = ActionMask::Bit(ActionTypes::GetActionType("Zerg_Hive"));
+    static const ActionMaskType Spire         = ActionMask::Bit(ActionTypes::GetActionType("Zerg_Spire"));
+    static const ActionMaskType GreaterSpire  = ActionMask::Bit(ActionTypes::GetActionType("Zerg_Greater_Spire"));
+
+    ActionMaskType have = _totalMask.getMask();
+
+    if (RaceTraits<race>::hasMorphedPrerequisites)
+    {
+        have |= (have & (Lair | Hive))      ? Hatchery  : 0;
+        have |= (have & Hive)               ? Lair      : 0;
+        have |= (have & GreaterSpire)       ? Spire     : 0;
+    }
+
+    return ActionMask(have);
+}
+
+const bool UnitData::hasPrerequisites(const PrerequisiteSet & required) const
+{
+    BOSS_RACE_DISPATCH(_race, hasPrerequisites, required);
+    return false;
+}
+
+template <RaceID race>
 const bool UnitData::hasPrerequisites(const PrerequisiteSet & required) const
 {
+    // almost every prerequisite needs just one of each action, which the masks can check at once
+    if (required.hasSingleCounts())
+    {
+        return getPrerequisiteMask<race>().containsAll(required.getMask());
+    }
+
     static const ActionType & Hatchery      = ActionTypes::GetActionType("Zerg_Hatchery");
     static const ActionType & Lair          = ActionTypes::GetActionType("Zerg_Lair");
     static const ActionType & Hive          = ActionTypes::GetActionType("Zerg_Hive");
@@ -328,7 +453,7 @@ const bool UnitData::hasPrerequisites(const PrerequisiteSet & required) const
         size_t have = getNumTotal(type);
 
         // special check for zerg moprhed buildings
-        if (_race == Races::Zerg)
+        if (RaceTraits<race>::hasMorphedPrerequisites)
         {
             if (type == Hatchery)
             {
@@ -436,4 +561,15 @@ HatcheryData & UnitData::getHatcheryData()
 const HatcheryData & UnitData::getHatcheryData() const
 {
     return _hatcheryData;
-}
\ No newline at end of file
+}
+
+// the race specific versions that GameState calls
+template const bool      UnitData::hasPrerequisites<Races::Protoss>(const PrerequisiteSet & required) const;
+template const bool      UnitData::hasPrerequisites<Races::Terran>(const PrerequisiteSet & required) const;
+template const bool      UnitData::hasPrerequisites<Races::Zerg>(const PrerequisiteSet & required) const;
+template const ActionMask UnitData::getPrerequisiteMask<Races::Protoss>() const;
+template const ActionMask UnitData::getPrerequisiteMask<Races::Terran>() const;
+template const ActionMask UnitData::getPrerequisiteMask<Races::Zerg>() const;
+template ActionType      UnitData::finishNextActionInProgress<Races::Protoss>(GameStateUndo * undo);
+template ActionType      UnitData::finishNextActionInProgress<Races::Terran>(GameStateUndo * undo);
+template ActionType      UnitData::finishNextActionInProgress<Races::Zerg>(GameStateUndo * undo);
@@ -6,10 +6,15 @@
 #include "ActionType.h"
 #include "ActionInProgress.h"
 #include "HatcheryData.h"
+#include "Hash.h"
+#include "ActionMask.h"
+#include "RaceTraits.h"
 
 namespace BOSS
 {
 
+class GameStateUndo;
+
 class UnitData
 {
     RaceID                              _race;
@@ -27,6 +32,12 @@ class UnitData
     ActionsInProgress	                _progress;					
     BuildingData		                _buildings;
 
+    HashValues                          _unitHash;                  // hash of the completed unit counts
+    ActionMask                          _totalMask;                 // the actions with at least one completed or in progress
+
+    void                    setNumCompleted(const ActionType & action, const UnitCountType & num, GameStateUndo * undo = nullptr);
+    void                    updateTotalMask(const ActionType & action);
+
 public:
 
     UnitData(const RaceID race);
@@ -34,10 +45,15 @@ public:
     const RaceID            getRace() const;
     const bool              hasActionsInProgress() const;
     const bool              hasPrerequisites(const PrerequisiteSet & required) const;
+    template <RaceID race>
+    const bool              hasPrerequisites(const PrerequisiteSet & required) const;
     const bool              hasGasIncome() const;
     const bool              hasMineralIncome() const;
 
     const PrerequisiteSet   getPrerequistesInProgress(const ActionType & action) const;
+    const ActionMask        getPrerequisiteMask() const;
+    template <RaceID race>
+    const ActionMask        getPrerequisiteMask() const;
     
     const UnitCountType     getNumTotal(const ActionType & action) const;
     const UnitCountType     getNumInProgress(const ActionType & action) const;
@@ -64,21 +80,26 @@ public:
 
     const SupplyCountType   getCurrentSupply() const;
     const SupplyCountType   getMaxSupply() const;
+    const HashValues        getHash() const;
     
     void                    setCurrentSupply(const UnitCountType & supply);
     void                    setBuildingWorker();
     void                    releaseBuildingWorker();
     void                    addCompletedBuilding(const ActionType & action, const FrameCountType timeUntilFree, const ActionType & constructing, const ActionType & addon, int numLarva);
-    void                    addCompletedAction(const ActionType & action, bool wasBuilt = true);
+    void                    addCompletedAction(const ActionType & action, bool wasBuilt = true, GameStateUndo * undo = nullptr);
 	void                    removeCompletedAction(const ActionType & action);
-    void                    addActionInProgress(const ActionType & action, const FrameCountType & completionFrame, bool queueAction = true);
-    void                    setBuildingFrame(const FrameCountType & frame);
+    void                    addActionInProgress(const ActionType & action, const FrameCountType & completionFrame, bool queueAction = true, GameStateUndo * undo = nullptr);
+    void                    setBuildingFrame(const FrameCountType & frame, GameStateUndo * undo = nullptr);
     void                    setMineralWorkers(const UnitCountType & mineralWorkers);
     void                    setGasWorkers(const UnitCountType & gasWorkers);
     void                    setBuildingWorkers(const UnitCountType & buildingWorkers);
-    void                    morphUnit(const ActionType & from, const ActionType & to, const FrameCountType & completionFrame);
+    void                    morphUnit(const ActionType & from, const ActionType & to, const FrameCountType & completionFrame, GameStateUndo * undo = nullptr);
+    void                    saveUndo(GameStateUndo & undo) const;
+    void                    restore(const GameStateUndo & undo);
 
-    ActionType              finishNextActionInProgress();
+    ActionType              finishNextActionInProgress(GameStateUndo * undo = nullptr);
+    template <RaceID race>
+    ActionType              finishNextActionInProgress(GameStateUndo * undo = nullptr);
 
     const BuildingData &    getBuildingData() const;
     const HatcheryData &    getHatcheryData() const;
@@ -1,11 +1,20 @@
 #include "Common.h"
 #include "BOSSManager.h"
 #include "BuildingManager.h"
+#include "Logger.h"
 
 #include "The.h"
 
 using namespace UAlbertaBot;
 
+namespace
+{
+    const std::string ReplayFilename    = "BOSS_replay.dat";
+    const std::string StatsFilename     = "BOSS_stats.json";
+    const char * EngineNames[]          = { "DFBB", "Beam", "Milestones" };
+    const double BackgroundSliceMS      = 10;       // a background search checks for a cancel this often
+}
+
 BOSSManager & BOSSManager::Instance() 
 {
     static BOSSManager instance;
@@ -17,19 +26,37 @@ BOSSManager::BOSSManager()
     , _previousSearchFinishFrame(0)
     , _searchInProgress(false)
     , _previousStatus("No Searches")
+    , _searchResultReady(false)
+    , _cancelSearch(false)
+    , _searchThreadTime(0)
+    , _searchThreadException(false)
 {
+    if (Config::Macro::BOSSCache)
+    {
+        _solutionCache.load();
+    }
+}
+
+BOSSManager::~BOSSManager()
+{
+    cancelSearch();
 }
 
 void BOSSManager::reset()
 {
+    cancelSearch();
+
     _previousSearchResults = BOSS::DFBB_BuildOrderSearchResults();
     _searchInProgress = false;
     _previousBuildOrder.clear();
 }
 
 // start a new search for a new goal
+// a background search for an earlier goal is cancelled
 void BOSSManager::startNewSearch(const std::vector<MetaPair> & goalUnits)
 {
+    cancelSearch();
+
     size_t numWorkers   = the.my.all.count(BWAPI::Broodwar->self()->getRace().getWorker());
     size_t numDepots    = the.my.all.count(BWAPI::Broodwar->self()->getRace().getResourceDepot())
                         + the.my.all.count(BWAPI::UnitTypes::Zerg_Lair)
@@ -53,16 +80,81 @@ void BOSSManager::startNewSearch(const std::vector<MetaPair> & goalUnits)
     {
         BOSS::BuildOrderSearchGoal goal = GetGoal(goalUnits);
 
-        BOSS::GameState initialState(BWAPI::Broodwar, BWAPI::Broodwar->self(), BuildingManager::Instance().buildingsQueued());
+        BOSS::GameStateRecipe initialRecipe(BWAPI::Broodwar, BWAPI::Broodwar->self(), BuildingManager::Instance().buildingsQueued());
+        BOSS::GameState initialState(initialRecipe);
+
+        // a cached build order for the same bucketed state is used as it is
+        // one for a similar state is a seed for the search to beat
+        BOSSSolutionCache::Hit cacheHit;
+        if (Config::Macro::BOSSCache && _solutionCache.lookup(initialState, goal, cacheHit))
+        {
+            if (cacheHit.exact)
+            {
+                _searchInProgress = false;
+                _previousSearchStartFrame = BWAPI::Broodwar->getFrameCount();
+                _previousSearchFinishFrame = _previousSearchStartFrame;
+                _totalPreviousSearchTime = 0;
+                _previousGoalUnits = goalUnits;
+                _previousSearchResults = BOSS::DFBB_BuildOrderSearchResults();
+                _previousSearchResults.buildOrder = cacheHit.buildOrder;
+                _savedSearchResults = _previousSearchResults;
+                _previousBuildOrder = cacheHit.buildOrder;
+                _previousStatus = std::string("\x07") + "BOSS Cache Hit\n";
+                return;
+            }
+        }
 
+        _searchGoal = goal;
         _smartSearch = SearchPtr(new BOSS::DFBB_BuildOrderSmartSearch(initialState.getRace()));
-        _smartSearch->setGoal(GetGoal(goalUnits));
+        _smartSearch->setGoal(goal);
         _smartSearch->setState(initialState);
+        _smartSearch->setNumThreads(Config::Macro::BOSSThreads);
+
+        // DFBB rarely finishes on late game goals, where the beam search gives a much better build order than the naive one
+        // goals in between get a time-limited DFBB search first, and are split into milestones small enough
+        // for DFBB to solve one after another only if that doesn't finish
+        const int goalSize = GetGoalSize(goal, initialState);
+        if (Config::Macro::BOSSBeamGoalSize > 0 && goalSize >= Config::Macro::BOSSBeamGoalSize)
+        {
+            _smartSearch->setEngine(BOSS::SearchEngines::Beam);
+        }
+        else if (Config::Macro::BOSSMilestoneGoalSize > 0 && goalSize >= Config::Macro::BOSSMilestoneGoalSize)
+        {
+            _smartSearch->setEngine(BOSS::SearchEngines::Milestones);
+        }
+
+        // seeds that don't reach the goal from this state are dropped by the search
+        // the previous build order is usually for a similar goal, and whatever of it is still legal from here may reach this one
+        std::vector<BOSS::BuildOrder> seeds;
+        if (cacheHit.buildOrder.size() > 0)
+        {
+            seeds.push_back(cacheHit.buildOrder);
+        }
+        if (_previousBuildOrder.size() > 0)
+        {
+            seeds.push_back(_previousBuildOrder);
+        }
+        for (const BOSS::BuildOrder & seed : seeds)
+        {
+            _smartSearch->addSeed(seed);
+        }
 
         _searchInProgress = true;
         _previousSearchStartFrame = BWAPI::Broodwar->getFrameCount();
         _totalPreviousSearchTime = 0;
         _previousGoalUnits = goalUnits;
+
+        if (Config::Macro::BOSSReplay)
+        {
+            recordSearch(initialRecipe, seeds);
+        }
+
+        // the state and goal were copied into the search above, so the thread doesn't touch BWAPI
+        if (Config::Macro::BOSSAsync)
+        {
+            _searchResultReady = false;
+            _searchThread = std::thread(&BOSSManager::runBackgroundSearch, this, _smartSearch);
+        }
     }
     catch (const BOSS::BOSSException &)
     {
@@ -108,21 +200,42 @@ void BOSSManager::drawSearchInformation(int x, int y)
 // tell the search to keep going for however long we have this frame
 void BOSSManager::update(double timeLimit)
 {
+    // a background search owns the search object until it says the result is ready
+    if (_searchThread.joinable())
+    {
+        if (_searchResultReady.load(std::memory_order_acquire))
+        {
+            _searchThread.join();
+
+            _previousStatus = _searchThreadException ? "BOSSExeption" : "";
+            _totalPreviousSearchTime = _searchThreadTime;
+            finishSearch(_smartSearch->getResults().timedOut, _searchThreadException);
+        }
+
+        return;
+    }
+
     // if there's a search in progress, resume it
     if (isSearchInProgress())
     {
         _previousStatus.clear();
 
         // give the search at least 5ms to search this frame
+        // the search pauses as soon as the budget is used up, so fractions of a millisecond are kept
         double realTimeLimit = timeLimit < 0 ? 5 : timeLimit;
-        _smartSearch->setTimeLimit((int)realTimeLimit);
+        bool finished = false;
         bool caughtException = false;
 
+        if (Config::Macro::BOSSReplay && !_replayProblems.empty())
+        {
+            _replayProblems.back().frameBudgets.push_back(realTimeLimit);
+        }
+
         try
         {
             // call the search to continue searching
             // this will resume a search in progress or start a new search if not yet started
-            _smartSearch->search();
+            finished = _smartSearch->search(BOSS::DFBB_SearchBudget(realTimeLimit));
         }
         catch (const BOSS::BOSSException &)
         {
@@ -136,92 +249,243 @@ void BOSSManager::update(double timeLimit)
 
         _totalPreviousSearchTime += _smartSearch->getResults().timeElapsed;
 
-        // after the search finishes for this frame, check to see if we have a solution or if we hit the overall time limit
+        // after the search finishes for this frame, check to see if it is finished or if we hit the overall time limit
+        // a beam or milestone search finishes without being solved
         bool searchTimeOut = (BWAPI::Broodwar->getFrameCount() > (_previousSearchStartFrame + Config::Macro::BOSSFrameLimit));
-        bool previousSearchComplete = searchTimeOut || _smartSearch->getResults().solved || caughtException;
+        bool previousSearchComplete = searchTimeOut || finished || caughtException;
         if (previousSearchComplete)
         {
-            bool solved = _smartSearch->getResults().solved && _smartSearch->getResults().solutionFound;
+            finishSearch(searchTimeOut, caughtException);
+        }
+    }
+}
+
+// the search has either solved the goal, timed out or failed, so take its build order
+// or fall back to a naive build order if it doesn't have one
+void BOSSManager::finishSearch(bool searchTimeOut, bool caughtException)
+{
+    bool solved = _smartSearch->getResults().solved && _smartSearch->getResults().solutionFound;
+
+    // if we've found a solution, let us know
+    if (Config::Debug::DrawBuildOrderSearchInfo && _smartSearch->getResults().solved)
+    {
+        BWAPI::Broodwar->printf("Build order SOLVED in %d nodes", (int)_smartSearch->getResults().nodesExpanded);
+    }
+
+    if (_smartSearch->getResults().solved)
+    {
+        if (_smartSearch->getResults().solutionFound)
+        {
+            _previousStatus = std::string("\x07") + "BOSS Solve Solution\n";
+        }
+        else
+        {
+            _previousStatus = std::string("\x03") + "BOSS Solve NoSolution\n";
+        }
+    }
 
-            // if we've found a solution, let us know
-            if (Config::Debug::DrawBuildOrderSearchInfo && _smartSearch->getResults().solved)
+    // re-set all the search information to get read for the next search
+    _searchInProgress = false;
+    _previousSearchFinishFrame = BWAPI::Broodwar->getFrameCount();
+    _previousSearchResults = _smartSearch->getResults();
+    _savedSearchResults = _previousSearchResults;
+    _previousBuildOrder = _previousSearchResults.buildOrder;
+
+    if (Config::Macro::BOSSReplay && !_replayProblems.empty())
+    {
+        BOSS::SearchReplayProblem & problem = _replayProblems.back();
+        problem.finished = true;
+        problem.solved = _previousSearchResults.solved;
+        problem.solutionFound = _previousSearchResults.solutionFound;
+        problem.nodesExpanded = _previousSearchResults.nodesExpanded;
+        problem.timeElapsed = _totalPreviousSearchTime;
+        problem.buildOrderSize = _previousBuildOrder.size();
+    }
+
+    if (Config::Macro::BOSSStats)
+    {
+        recordSearchStats();
+    }
+
+    // a solved DFBB search proves the build order is the best there is, so keep it for later games
+    // the beam search only finds a good one
+    if (solved && Config::Macro::BOSSCache && _smartSearch->getEngine() == BOSS::SearchEngines::DFBB)
+    {
+        _solutionCache.store(_smartSearch->getParameters().initialState, _searchGoal, _previousBuildOrder);
+    }
+
+    if (solved && _previousBuildOrder.size() == 0)
+    {
+        _previousStatus = std::string("\x07") + "BOSS Trivial Solve\n";
+    }
+
+    // if our search resulted in a build order of size 0 then something failed
+    if (!solved && _previousBuildOrder.size() == 0)
+    {
+        // log the debug information since this shouldn't happen if everything goes to plan
+        /*std::stringstream ss;
+        ss << _smartSearch->getParameters().toString() << "\n";
+        ss << "searchTimeOut: " << (searchTimeOut ? "true" : "false") << "\n";
+        ss << "caughtException: " << (caughtException ? "true" : "false") << "\n";
+        ss << "getResults().solved: " << (_smartSearch->getResults().solved ? "true" : "false") << "\n";
+        ss << "getResults().solutionFound: " << (_smartSearch->getResults().solutionFound ? "true" : "false") << "\n";
+        ss << "nodes: " << _savedSearchResults.nodesExpanded << "\n";
+        ss << "time: " << _savedSearchResults.timeElapsed << "\n";
+        Logger::LogOverwriteToFile("bwapi-data/AI/LastBadBuildOrder.txt", ss.str());*/
+        
+        // so try another naive build order search as a last resort
+        BOSS::NaiveBuildOrderSearch nbos(_smartSearch->getParameters().initialState, _smartSearch->getParameters().goal);
+
+        try
+        {
+            if (searchTimeOut)
             {
-                BWAPI::Broodwar->printf("Build order SOLVED in %d nodes", (int)_smartSearch->getResults().nodesExpanded);
+                _previousStatus = std::string("\x02") + "BOSS Timeout\n";
             }
 
-            if (_smartSearch->getResults().solved)
+            if (caughtException)
             {
-                if (_smartSearch->getResults().solutionFound)
-                {
-                    _previousStatus = std::string("\x07") + "BOSS Solve Solution\n";
-                }
-                else
-                {
-                    _previousStatus = std::string("\x03") + "BOSS Solve NoSolution\n";
-                }
+                _previousStatus = std::string("\x02") + "BOSS Exception\n";
             }
 
-            // re-set all the search information to get read for the next search
-            _searchInProgress = false;
-            _previousSearchFinishFrame = BWAPI::Broodwar->getFrameCount();
-            _previousSearchResults = _smartSearch->getResults();
-            _savedSearchResults = _previousSearchResults;
-            _previousBuildOrder = _previousSearchResults.buildOrder;
+            _previousBuildOrder = nbos.solve();
+            _previousStatus += "\x03NBOS Solution";
+
+            // nothing beat the naive build order, so it is optimal
+            if (_smartSearch->getResults().solved && Config::Macro::BOSSCache && _smartSearch->getEngine() == BOSS::SearchEngines::DFBB)
+            {
+                _solutionCache.store(_smartSearch->getParameters().initialState, _searchGoal, _previousBuildOrder);
+            }
 
-            if (solved && _previousBuildOrder.size() == 0)
+            return;
+        }
+        // and if that search doesn't work then we're out of luck, no build orders for us
+        catch (const BOSS::BOSSException & exception)
+        {
+            _previousStatus += "\x08Naive Exception";
+            if (Config::Debug::DrawBuildOrderSearchInfo)
             {
-                _previousStatus = std::string("\x07") + "BOSS Trivial Solve\n";
+                UAB_ASSERT_WARNING(false, "BOSS Timeout Naive Search Exception: %s", exception.what());
+                BWAPI::Broodwar->drawTextScreen(0, 20, "No BuildOrder found, returning empty BuildOrder");
             }
+            _previousBuildOrder = BOSS::BuildOrder();
+            return;
+        }
+    }
+}
+
+// runs the search on the background thread until it is finished, cancelled or out of time
+// the search is resumed in short slices so a cancel is noticed quickly
+void BOSSManager::runBackgroundSearch(SearchPtr search)
+{
+    const double sliceMS = BackgroundSliceMS;
+    const auto startTime = std::chrono::steady_clock::now();
+
+    double searchTime = 0;
+    bool caughtException = false;
+
+    try
+    {
+        while (!_cancelSearch.load(std::memory_order_relaxed))
+        {
+            bool finished = search->search(BOSS::DFBB_SearchBudget(sliceMS));
+            searchTime += search->getResults().timeElapsed;
 
-            // if our search resulted in a build order of size 0 then something failed
-            if (!solved && _previousBuildOrder.size() == 0)
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+            if (finished || (elapsed.count() > Config::Macro::BOSSTimeLimit))
             {
-                // log the debug information since this shouldn't happen if everything goes to plan
-                /*std::stringstream ss;
-                ss << _smartSearch->getParameters().toString() << "\n";
-                ss << "searchTimeOut: " << (searchTimeOut ? "true" : "false") << "\n";
-                ss << "caughtException: " << (caughtException ? "true" : "false") << "\n";
-                ss << "getResults().solved: " << (_smartSearch->getResults().solved ? "true" : "false") << "\n";
-                ss << "getResults().solutionFound: " << (_smartSearch->getResults().solutionFound ? "true" : "false") << "\n";
-                ss << "nodes: " << _savedSearchResults.nodesExpanded << "\n";
-                ss << "time: " << _savedSearchResults.timeElapsed << "\n";
-                Logger::LogOverwriteToFile("bwapi-data/AI/LastBadBuildOrder.txt", ss.str());*/
-                
-                // so try another naive build order search as a last resort
-                BOSS::NaiveBuildOrderSearch nbos(_smartSearch->getParameters().initialState, _smartSearch->getParameters().goal);
-
-                try
-                {
-                    if (searchTimeOut)
-                    {
-                        _previousStatus = std::string("\x02") + "BOSS Timeout\n";
-                    }
-
-                    if (caughtException)
-                    {
-                        _previousStatus = std::string("\x02") + "BOSS Exception\n";
-                    }
-
-                    _previousBuildOrder = nbos.solve();
-                    _previousStatus += "\x03NBOS Solution";
-
-                    return;
-                }
-                // and if that search doesn't work then we're out of luck, no build orders for us
-                catch (const BOSS::BOSSException & exception)
-                {
-                    _previousStatus += "\x08Naive Exception";
-                    if (Config::Debug::DrawBuildOrderSearchInfo)
-                    {
-                        UAB_ASSERT_WARNING(false, "BOSS Timeout Naive Search Exception: %s", exception.what());
-                        BWAPI::Broodwar->drawTextScreen(0, 20, "No BuildOrder found, returning empty BuildOrder");
-                    }
-                    _previousBuildOrder = BOSS::BuildOrder();
-                    return;
-                }
+                break;
             }
         }
     }
+    catch (...)
+    {
+        caughtException = true;
+    }
+
+    // these are read by the game thread only after it sees the ready flag
+    _searchThreadTime = searchTime;
+    _searchThreadException = caughtException;
+    _searchResultReady.store(true, std::memory_order_release);
+}
+
+// stops a background search and throws away its result
+void BOSSManager::cancelSearch()
+{
+    if (_searchThread.joinable())
+    {
+        _cancelSearch = true;
+        _searchThread.join();
+        _cancelSearch = false;
+        _searchInProgress = false;
+    }
+}
+
+// save the build orders found this game for the next one
+void BOSSManager::onEnd()
+{
+    cancelSearch();
+
+    if (Config::Macro::BOSSCache)
+    {
+        _solutionCache.write();
+    }
+
+    if (Config::Macro::BOSSReplay && !_replayProblems.empty())
+    {
+        BOSS::SearchReplay::Write(Config::IO::WriteDir + ReplayFilename, _replayProblems);
+    }
+
+    if (Config::Macro::BOSSStats && !_searchStats.empty())
+    {
+        Logger::LogOverwriteToFile(Config::IO::WriteDir + StatsFilename, getSearchStatsJSON());
+    }
+}
+
+// the search just finished, with the stats of the search itself if BOSS was built with them
+void BOSSManager::recordSearchStats()
+{
+    std::stringstream ss;
+    ss << "{\"Frame\" : " << _previousSearchStartFrame;
+    ss << ", \"Engine\" : \"" << EngineNames[_smartSearch->getEngine()] << "\"";
+    ss << ", \"Solved\" : " << (_previousSearchResults.solved ? "true" : "false");
+    ss << ", \"SolutionFound\" : " << (_previousSearchResults.solutionFound ? "true" : "false");
+    ss << ", \"Nodes\" : " << _previousSearchResults.nodesExpanded;
+    ss << ", \"TranspositionHits\" : " << _previousSearchResults.transpositionHits;
+    ss << ", \"TimeMS\" : " << _totalPreviousSearchTime;
+    ss << ", \"BuildOrderSize\" : " << _previousBuildOrder.size();
+    ss << ", \"Search\" : " << _previousSearchResults.stats.getJSONString() << "}";
+
+    _searchStats.push_back(ss.str());
+}
+
+std::string BOSSManager::getSearchStatsJSON() const
+{
+    std::string json = "[";
+    for (size_t i(0); i < _searchStats.size(); ++i)
+    {
+        json += (i > 0 ? ",\n" : "\n") + _searchStats[i];
+    }
+
+    return json + "\n]\n";
+}
+
+// keep the search just set up, so BOSS_replay can run it again with the same time slices
+// the budget of each frame is added by update(), and the result by finishSearch()
+void BOSSManager::recordSearch(const BOSS::GameStateRecipe & state, const std::vector<BOSS::BuildOrder> & seeds)
+{
+    BOSS::SearchReplayProblem problem;
+    problem.gameFrame = BWAPI::Broodwar->getFrameCount();
+    problem.state = state;
+    problem.goal = _searchGoal;
+    problem.engine = _smartSearch->getEngine();
+    problem.seeds = seeds;
+    problem.numThreads = Config::Macro::BOSSThreads;
+    problem.background = Config::Macro::BOSSAsync;
+    problem.backgroundSliceMS = BackgroundSliceMS;
+    problem.backgroundTimeLimitMS = Config::Macro::BOSSTimeLimit;
+
+    _replayProblems.push_back(problem);
 }
 
 void BOSSManager::logBadSearch()
@@ -243,6 +507,24 @@ BOSS::BuildOrderSearchGoal BOSSManager::GetGoal(const std::vector<MetaPair> & go
     return goal;
 }
 
+// the number of actions still needed to reach the goal from the state
+int BOSSManager::GetGoalSize(const BOSS::BuildOrderSearchGoal & goal, const BOSS::GameState & state)
+{
+    int size = 0;
+
+    for (const BOSS::ActionType & actionType : BOSS::ActionTypes::GetAllActionTypes(state.getRace()))
+    {
+        int remaining = goal.getGoal(actionType) - state.getUnitData().getNumTotal(actionType);
+        if (remaining > 0)
+        {
+            // units made in pairs, such as zerglings, take one action per pair
+            size += (remaining + actionType.numProduced() - 1) / actionType.numProduced();
+        }
+    }
+
+    return size;
+}
+
 // gets the StarcraftState corresponding to the beginning of a Melee game
 BOSS::GameState BOSSManager::getStartState()
 {
@@ -4,7 +4,12 @@
 #include "WorkerManager.h"
 #include "../../BOSS/source/BOSS.h"
 #include "StrategyManager.h"
+#include "BOSSSolutionCache.h"
+#include "../../BOSS/source/SearchReplay.h"
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 
 namespace UAlbertaBot
 {
@@ -27,6 +32,25 @@ class BOSSManager
     BOSS::DFBB_BuildOrderSearchResults      _savedSearchResults;
     BOSS::BuildOrder                        _previousBuildOrder;
 
+    // build orders from earlier games, used when Config::Macro::BOSSCache is set
+    BOSSSolutionCache                       _solutionCache;
+    BOSS::BuildOrderSearchGoal              _searchGoal;            // the goal as given, before the search adds its own limits
+
+    // background search, used when Config::Macro::BOSSAsync is set
+    std::thread                             _searchThread;
+    std::atomic<bool>                       _searchResultReady;
+    std::atomic<bool>                       _cancelSearch;
+    double                                  _searchThreadTime;          // written by the search thread before the result is ready
+    bool                                    _searchThreadException;
+
+    // every search of the game and the time it was given, saved at the end when Config::Macro::BOSSReplay is set
+    // the last one is the search in progress, if there is one
+    std::vector<BOSS::SearchReplayProblem>  _replayProblems;
+
+    // the stats of every finished search of the game as json, saved at the end when Config::Macro::BOSSStats is set
+    // BOSS only fills in the search's own stats when it's built with BOSS_SEARCH_STATS
+    std::vector<std::string>                _searchStats;
+
     BOSS::GameState				            getCurrentState();
     BOSS::GameState				            getStartState();
     
@@ -39,11 +63,17 @@ class BOSSManager
     const BOSS::RaceID                      getRace() const;
 
     void                                    logBadSearch();
+    void                                    finishSearch(bool searchTimeOut, bool caughtException);
+    void                                    runBackgroundSearch(SearchPtr search);
+    void                                    recordSearch(const BOSS::GameStateRecipe & state, const std::vector<BOSS::BuildOrder> & seeds);
+    void                                    recordSearchStats();
 
     BOSSManager();
 
 public:
 
+    ~BOSSManager();
+
     static BOSSManager &	    Instance();
 
     void						update(double timeLimit);
@@ -53,12 +83,17 @@ public:
     bool                        isSearchInProgress();
 
     void                        startNewSearch(const std::vector<MetaPair> & goalUnits);
+    void                        cancelSearch();
+    void                        onEnd();
+
+    std::string                 getSearchStatsJSON() const;
     
     void						drawSearchInformation(int x, int y);
     void						drawStateInformation(int x, int y);
 
     
     static BOSS::BuildOrderSearchGoal       GetGoal(const std::vector<MetaPair> & goalUnits);	
+    static int                              GetGoalSize(const BOSS::BuildOrderSearchGoal & goal, const BOSS::GameState & state);
     static std::vector<MacroAct>			GetMetaVector(const BOSS::BuildOrder & buildOrder);
     static BOSS::ActionType					GetActionType(const MacroAct & t);
     static MacroAct					        GetMacroAct(const BOSS::ActionType & a);
@@ -0,0 +1,382 @@
+#include "BOSSSolutionCache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include "HashMix.h"
+
+using namespace UAlbertaBot;
+
+namespace
+{
+    const std::string CacheFilename     = "BOSS_solutions.dat";
+    const uint32_t CacheMagic           = 0x43534f42;   // "BOSC"
+    const uint32_t CacheVersion         = 2;
+    const size_t MaxEntries             = 20000;        // entries beyond this are dropped when writing, oldest first
+
+    // bucket sizes used by the exact key
+    const int ResourceBucket            = 50;           // minerals or gas
+    const int FrameBucket               = 24;           // about 1 second of game time
+}
+
+BOSSSolutionCache::BOSSSolutionCache()
+    : _index(nullptr)
+    , _numIndex(0)
+    , _payload(nullptr)
+    , _payloadSize(0)
+    , _game(1)
+    , _loaded(false)
+{
+}
+
+BOSSSolutionCache::~BOSSSolutionCache()
+{
+    unmap();
+}
+
+// the goal plus how many of each unit we have or are making
+uint64_t BOSSSolutionCache::NearKey(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal)
+{
+    const BOSS::RaceID race = state.getRace();
+    uint64_t hash = HashMix(CacheMagic, race);
+
+    for (const BOSS::ActionType & action : BOSS::ActionTypes::GetAllActionTypes(race))
+    {
+        hash = HashMix(hash, goal.getGoal(action));
+        hash = HashMix(hash, goal.getGoalMax(action));
+        hash = HashMix(hash, state.getUnitData().getNumTotal(action));
+    }
+
+    return hash;
+}
+
+// adds what the near key leaves out, with resources and times relative to the current frame put into buckets
+// units in progress and busy buildings are combined with a sum so their order in the state doesn't matter
+uint64_t BOSSSolutionCache::ExactKey(const BOSS::GameState & state, uint64_t nearKey)
+{
+    const BOSS::UnitData & units = state.getUnitData();
+    const int currentFrame = state.getCurrentFrame();
+    uint64_t hash = nearKey;
+
+    for (const BOSS::ActionType & action : BOSS::ActionTypes::GetAllActionTypes(state.getRace()))
+    {
+        hash = HashMix(hash, units.getNumCompleted(action));
+    }
+
+    hash = HashMix(hash, units.getNumMineralWorkers());
+    hash = HashMix(hash, units.getNumGasWorkers());
+    hash = HashMix(hash, units.getNumBuildingWorkers());
+    hash = HashMix(hash, units.getCurrentSupply());
+    hash = HashMix(hash, units.getMaxSupply());
+    hash = HashMix(hash, units.getHatcheryData().numLarva());
+    hash = HashMix(hash, state.getMinerals() / (ResourceBucket * BOSS::Constants::RESOURCE_SCALE));
+    hash = HashMix(hash, state.getGas() / (ResourceBucket * BOSS::Constants::RESOURCE_SCALE));
+
+    uint64_t progress = 0;
+    for (BOSS::UnitCountType i(0); i < units.getNumActionsInProgress(); ++i)
+    {
+        const int framesLeft = std::max(0, units.getActionInProgressFinishTimeByIndex(i) - currentFrame);
+        progress += HashMix(units.getActionInProgressByIndex(i).ID(), framesLeft / FrameBucket);
+    }
+    hash = HashMix(hash, progress);
+
+    uint64_t buildings = 0;
+    const BOSS::BuildingData & buildingData = units.getBuildingData();
+    for (BOSS::UnitCountType i(0); i < buildingData.size(); ++i)
+    {
+        const BOSS::BuildingStatus & building = buildingData.getBuilding(i);
+        if (building._timeRemaining > 0)
+        {
+            buildings += HashMix(HashMix(building._type.ID(), building._isConstructing.ID()), building._timeRemaining / FrameBucket);
+        }
+    }
+    hash = HashMix(hash, buildings);
+
+    return hash;
+}
+
+void BOSSSolutionCache::unmap()
+{
+    _file.close();
+    _index = nullptr;
+    _numIndex = 0;
+    _payload = nullptr;
+    _payloadSize = 0;
+}
+
+// check the header and sizes before trusting anything in the file
+bool BOSSSolutionCache::validateFile()
+{
+    const char * data = _file.data();
+    const size_t dataSize = _file.size();
+
+    if (dataSize < sizeof(FileHeader))
+    {
+        return false;
+    }
+
+    const FileHeader * header = (const FileHeader *)data;
+    if (header->magic != CacheMagic || header->version != CacheVersion)
+    {
+        return false;
+    }
+
+    const size_t indexBytes = (size_t)header->numEntries * sizeof(IndexEntry);
+    if (dataSize != sizeof(FileHeader) + indexBytes + header->payloadSize)
+    {
+        return false;
+    }
+
+    _index = (const IndexEntry *)(data + sizeof(FileHeader));
+    _numIndex = header->numEntries;
+    _payload = (const BOSS::ActionID *)(data + sizeof(FileHeader) + indexBytes);
+    _payloadSize = header->payloadSize;
+
+    for (size_t i(0); i < _numIndex; ++i)
+    {
+        if ((size_t)_index[i].payloadOffset + _index[i].numActions > _payloadSize ||
+            (i > 0 && _index[i-1].exactKey > _index[i].exactKey))
+        {
+            return false;
+        }
+    }
+
+    _game = header->numGames + 1;
+    return true;
+}
+
+void BOSSSolutionCache::load()
+{
+    if (_loaded)
+    {
+        return;
+    }
+    _loaded = true;
+
+    if (_file.open(Config::IO::ReadDir + CacheFilename) && !validateFile())
+    {
+        unmap();
+    }
+}
+
+// the build order is only a hit if it is legal from this state and reaches the goal
+bool BOSSSolutionCache::tryCandidate(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal,
+    BOSS::RaceID race, const BOSS::ActionID * actions, size_t numActions,
+    bool exact, Hit & hit) const
+{
+    if (race != state.getRace())
+    {
+        return false;
+    }
+
+    const size_t numActionTypes = BOSS::ActionTypes::GetAllActionTypes(race).size();
+    BOSS::BuildOrder buildOrder;
+    for (size_t i(0); i < numActions; ++i)
+    {
+        if (actions[i] >= numActionTypes)
+        {
+            return false;
+        }
+        buildOrder.add(BOSS::ActionTypes::GetActionType(race, actions[i]));
+    }
+
+    if (!buildOrder.isLegalFromState(state))
+    {
+        return false;
+    }
+
+    BOSS::GameState finalState(state);
+    buildOrder.doActions(finalState);
+
+    BOSS::BuildOrderSearchGoal goalCopy(goal);
+    if (!goalCopy.isAchievedBy(finalState))
+    {
+        return false;
+    }
+
+    const int finishFrame = finalState.getLastActionFinishTime();
+    if (hit.buildOrder.size() > 0 && !exact && finishFrame >= hit.finishFrame)
+    {
+        return false;
+    }
+
+    hit.buildOrder = buildOrder;
+    hit.finishFrame = finishFrame;
+    hit.exact = exact;
+    return true;
+}
+
+// an exact hit is returned as soon as one checks out
+// otherwise the near miss that finishes earliest is returned, to be used as an upper bound
+bool BOSSSolutionCache::lookup(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal, Hit & hit) const
+{
+    const uint64_t nearKey = NearKey(state, goal);
+    const uint64_t exactKey = ExactKey(state, nearKey);
+
+    hit = Hit();
+
+    for (const Entry & entry : _newEntries)
+    {
+        if (entry.exactKey == exactKey &&
+            tryCandidate(state, goal, entry.race, entry.actions.data(), entry.actions.size(), true, hit))
+        {
+            return true;
+        }
+    }
+
+    auto exactBegin = std::lower_bound(_index, _index + _numIndex, exactKey,
+        [](const IndexEntry & entry, uint64_t key) { return entry.exactKey < key; });
+
+    for (auto it = exactBegin; it != _index + _numIndex && it->exactKey == exactKey; ++it)
+    {
+        if (tryCandidate(state, goal, it->race, _payload + it->payloadOffset, it->numActions, true, hit))
+        {
+            return true;
+        }
+    }
+
+    for (const Entry & entry : _newEntries)
+    {
+        if (entry.nearKey == nearKey && entry.exactKey != exactKey)
+        {
+            tryCandidate(state, goal, entry.race, entry.actions.data(), entry.actions.size(), false, hit);
+        }
+    }
+
+    for (size_t i(0); i < _numIndex; ++i)
+    {
+        if (_index[i].nearKey == nearKey && _index[i].exactKey != exactKey)
+        {
+            tryCandidate(state, goal, _index[i].race, _payload + _index[i].payloadOffset, _index[i].numActions, false, hit);
+        }
+    }
+
+    return hit.buildOrder.size() > 0;
+}
+
+// remember a solved search, state and goal are the ones the search was started with
+void BOSSSolutionCache::store(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal, const BOSS::BuildOrder & buildOrder)
+{
+    if (buildOrder.size() == 0 || buildOrder.size() > 0xffff)
+    {
+        return;
+    }
+
+    Entry entry;
+    entry.nearKey = NearKey(state, goal);
+    entry.exactKey = ExactKey(state, entry.nearKey);
+    entry.race = state.getRace();
+    entry.makespan = buildOrder.getCompletionTime(state) - state.getCurrentFrame();
+    entry.game = _game;
+    for (size_t i(0); i < buildOrder.size(); ++i)
+    {
+        entry.actions.push_back(buildOrder[i].ID());
+    }
+
+    for (Entry & existing : _newEntries)
+    {
+        if (existing.exactKey == entry.exactKey)
+        {
+            if (entry.makespan < existing.makespan)
+            {
+                existing = entry;
+            }
+            return;
+        }
+    }
+
+    _newEntries.push_back(entry);
+}
+
+// merge this game's entries with the loaded ones and write the whole cache
+// where both have the same exact key, the shorter build order is kept
+void BOSSSolutionCache::write()
+{
+    if (_newEntries.empty())
+    {
+        return;
+    }
+
+    std::map<uint64_t, Entry> merged;
+    for (const Entry & entry : _newEntries)
+    {
+        merged[entry.exactKey] = entry;
+    }
+
+    for (size_t i(0); i < _numIndex; ++i)
+    {
+        const IndexEntry & index = _index[i];
+        auto it = merged.find(index.exactKey);
+        if (it != merged.end() && it->second.makespan <= index.makespan)
+        {
+            continue;
+        }
+
+        Entry entry;
+        entry.exactKey = index.exactKey;
+        entry.nearKey = index.nearKey;
+        entry.race = index.race;
+        entry.makespan = index.makespan;
+        entry.game = it != merged.end() ? it->second.game : index.game;     // found again this game
+        entry.actions.assign(_payload + index.payloadOffset, _payload + index.payloadOffset + index.numActions);
+        merged[entry.exactKey] = entry;
+    }
+
+    // when over the limit, drop the entries last found in the oldest games
+    if (merged.size() > MaxEntries)
+    {
+        std::vector<std::pair<uint32_t, uint64_t>> ages;
+        for (const auto & kv : merged)
+        {
+            ages.push_back(std::make_pair(kv.second.game, kv.first));
+        }
+        std::sort(ages.begin(), ages.end());
+        for (size_t i(0); i < ages.size() - MaxEntries; ++i)
+        {
+            merged.erase(ages[i].second);
+        }
+    }
+
+    // release the mapping before writing in case the read and write dirs are the same
+    unmap();
+
+    std::vector<IndexEntry> index;
+    std::vector<BOSS::ActionID> payload;
+    for (const auto & kv : merged)
+    {
+        const Entry & entry = kv.second;
+
+        IndexEntry indexEntry;
+        indexEntry.exactKey = entry.exactKey;
+        indexEntry.nearKey = entry.nearKey;
+        indexEntry.payloadOffset = (uint32_t)payload.size();
+        indexEntry.numActions = (uint16_t)entry.actions.size();
+        indexEntry.race = (uint8_t)entry.race;
+        indexEntry.pad = 0;
+        indexEntry.makespan = entry.makespan;
+        indexEntry.game = entry.game;
+
+        index.push_back(indexEntry);
+        payload.insert(payload.end(), entry.actions.begin(), entry.actions.end());
+    }
+
+    FileHeader header;
+    header.magic = CacheMagic;
+    header.version = CacheVersion;
+    header.numEntries = (uint32_t)index.size();
+    header.payloadSize = (uint32_t)payload.size();
+    header.numGames = _game;
+    header.pad = 0;
+
+    std::ofstream outFile(Config::IO::WriteDir + CacheFilename, std::ios::binary | std::ios::trunc);
+    if (!outFile.good())
+    {
+        return;
+    }
+
+    outFile.write((const char *)&header, sizeof(header));
+    outFile.write((const char *)index.data(), index.size() * sizeof(IndexEntry));
+    outFile.write((const char *)payload.data(), payload.size());
+
+    _newEntries.clear();
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Common.h"
+#include "MappedFile.h"
+#include "../../BOSS/source/BOSS.h"
+
+#include <cstdint>
+
+namespace UAlbertaBot
+{
+
+// Build orders found by BOSS in earlier games, saved in the bot's write dir at the end of a game.
+// A search problem is keyed by the goal plus a canonical signature of the starting state.
+// The signature ignores the frame number and puts resources and timers into coarse buckets,
+// so the same situation in a different game usually gets the same key.
+//   exact key: goal + unit counts + workers + supply + bucketed resources and timers
+//   near key:  goal + unit counts only
+// A cached build order is always re-simulated from the real state before it is used.
+class BOSSSolutionCache
+{
+public:
+
+    // on-disk index entry, the index is sorted by exactKey
+    struct IndexEntry
+    {
+        uint64_t    exactKey;
+        uint64_t    nearKey;
+        uint32_t    payloadOffset;      // into the action ID payload after the index
+        uint16_t    numActions;
+        uint8_t     race;
+        uint8_t     pad;
+        int32_t     makespan;           // frames from the start of the search to the end of the build order
+        uint32_t    game;               // the game that last found the entry, counted by the file
+    };
+
+    struct FileHeader
+    {
+        uint32_t    magic;
+        uint32_t    version;
+        uint32_t    numEntries;
+        uint32_t    payloadSize;
+        uint32_t    numGames;           // games that have written the file
+        uint32_t    pad;
+    };
+
+    // the result of a lookup that found a cached build order which reaches the goal
+    struct Hit
+    {
+        BOSS::BuildOrder    buildOrder;
+        int                 finishFrame;    // simulated from the current state, not the cached makespan
+        bool                exact;          // same bucketed state, good enough to use without searching
+
+        Hit() : finishFrame(0), exact(false) {}
+    };
+
+private:
+
+    // entries found in this game, written out together with the loaded ones at the end
+    struct Entry
+    {
+        uint64_t                    exactKey;
+        uint64_t                    nearKey;
+        BOSS::RaceID                race;
+        int                         makespan;
+        uint32_t                    game;
+        std::vector<BOSS::ActionID> actions;
+    };
+
+    // the memory mapped file that was read at startup
+    MappedFile                      _file;
+
+    const IndexEntry *              _index;
+    size_t                          _numIndex;
+    const BOSS::ActionID *          _payload;
+    size_t                          _payloadSize;
+
+    std::vector<Entry>              _newEntries;
+    uint32_t                        _game;              // this game's number, one more than the games in the file
+    bool                            _loaded;
+
+    void                            unmap();
+    bool                            validateFile();
+
+    bool                            tryCandidate(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal,
+                                        BOSS::RaceID race, const BOSS::ActionID * actions, size_t numActions,
+                                        bool exact, Hit & hit) const;
+
+    static uint64_t                 NearKey(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal);
+    static uint64_t                 ExactKey(const BOSS::GameState & state, uint64_t nearKey);
+
+public:
+
+    BOSSSolutionCache();
+    ~BOSSSolutionCache();
+
+    void                            load();
+    void                            write();
+
+    bool                            lookup(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal, Hit & hit) const;
+    void                            store(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal, const BOSS::BuildOrder & buildOrder);
+};
+
+}
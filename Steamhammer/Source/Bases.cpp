@@ -1,5 +1,7 @@
 #include "Bases.h"
 
+#include "HashMix.h"
+#include "MapAnalysisCache.h"
 #include "MapTools.h"
 #include "InformationManager.h"
 #include "The.h"
@@ -125,6 +127,18 @@ void Bases::countResources(BWAPI::Unit resource, int & minerals, int & gas) cons
     }
 }
 
+// The same resources make the same key in every game on the map, in any order.
+uint64_t Bases::resourceGroupKey(const BWAPI::Unitset & resources) const
+{
+    uint64_t key = 0;
+    for (BWAPI::Unit resource : resources)
+    {
+        const BWAPI::TilePosition tile = resource->getInitialTilePosition();
+        key += HashMix(HashMix(resource->getType().getID(), tile.x), tile.y);
+    }
+    return HashMix(key, resources.size());
+}
+
 // Given a set of resources (mineral patches and geysers), find a base position nearby if possible.
 // This identifies the spot for the resource depot.
 // Return BWAPI::TilePositions::Invalid if no acceptable place is found.
@@ -153,6 +167,14 @@ BWAPI::TilePosition Bases::findBasePosition(BWAPI::Unitset resources)
 
     potentialBases.push_back(PotentialBase(left, right, top, bottom, centerOfResources));
 
+    // Was the position found in an earlier game?
+    const uint64_t key = resourceGroupKey(resources);
+    auto known = basePositions.find(key);
+    if (known != basePositions.end())
+    {
+        return known->second;
+    }
+
     GridDistances distances(centerOfResources, BasePositionRange, false);
 
     int bestScore = INT_MAX;               // smallest is best
@@ -172,6 +194,7 @@ BWAPI::TilePosition Bases::findBasePosition(BWAPI::Unitset resources)
         }
     }
 
+    basePositions[key] = bestTile;
     return bestTile;
 }
 
@@ -621,6 +644,41 @@ void Bases::initialize()
     }
 }
 
+// Only the base positions are saved. The bases themselves are made from the live resource units each game.
+void Bases::saveBasePositions(MapCacheWriter & out) const
+{
+    out.put(int32_t(basePositions.size()));
+    for (const auto & keyTile : basePositions)
+    {
+        out.put(keyTile.first);
+        out.put(int32_t(keyTile.second.x));
+        out.put(int32_t(keyTile.second.y));
+    }
+}
+
+bool Bases::loadBasePositions(MapCacheReader & in)
+{
+    basePositions.clear();
+
+    int32_t n;
+    if (!in.get(n) || n < 0)
+    {
+        return false;
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        uint64_t key;
+        int32_t x, y;
+        if (!in.get(key) || !in.get(x) || !in.get(y))
+        {
+            basePositions.clear();
+            return false;
+        }
+        basePositions[key] = BWAPI::TilePosition(x, y);
+    }
+    return true;
+}
+
 void Bases::update()
 {
     updateEnemyStart();
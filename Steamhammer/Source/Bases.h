@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include "Base.h"
 
 namespace UAlbertaBot
 {
+    class MapCacheReader;
+    class MapCacheWriter;
     class The;
 
     class PotentialBase
@@ -42,6 +45,10 @@ namespace UAlbertaBot
         bool islandBases;
         std::map<BWAPI::Unit, Base *> baseBlockers;	// neutral building to destroy -> base it belongs to
 
+        // Resource group -> base position found for it. Saved with the map analysis, so the search
+        // is not repeated in later games on the same map.
+        std::map<uint64_t, BWAPI::TilePosition> basePositions;
+
         // Debug data structures. Not used for any other purpose, can be deleted with their uses.
         std::vector<BWAPI::Unitset> nonbases;
         std::vector<PotentialBase> potentialBases;
@@ -55,6 +62,7 @@ namespace UAlbertaBot
 
         void removeUsedResources(BWAPI::Unitset & resources, const Base * base) const;
         void countResources(BWAPI::Unit resource, int & minerals, int & gas) const;
+        uint64_t resourceGroupKey(const BWAPI::Unitset & resources) const;
         BWAPI::TilePosition findBasePosition(BWAPI::Unitset resources);
         int baseLocationScore(const BWAPI::TilePosition & tile, BWAPI::Unitset resources) const;
         int tilesBetweenBoxes
@@ -74,6 +82,9 @@ namespace UAlbertaBot
     public:
         void initialize();
         void update();
+
+        void saveBasePositions(MapCacheWriter & out) const;
+        bool loadBasePositions(MapCacheReader & in);
         void checkBuildingPosition(const BWAPI::TilePosition & desired, const BWAPI::TilePosition & actual);
 
         void drawBaseInfo() const;
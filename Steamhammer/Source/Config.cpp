@@ -132,6 +132,14 @@ namespace Config
     namespace Macro
     {
         int BOSSFrameLimit                  = 160;
+        int BOSSThreads                     = 1;        // threads for build order search, 1 searches on the main thread
+        bool BOSSAsync                      = false;    // search on a background thread instead of in each frame's leftover time
+        int BOSSTimeLimit                   = 4000;     // wall clock limit in ms for a background search
+        bool BOSSCache                      = false;    // reuse build orders found in earlier games
+        int BOSSBeamGoalSize                = 0;        // goals needing at least this many actions use the beam search, 0 never does
+        int BOSSMilestoneGoalSize           = 0;        // smaller goals needing at least this many actions are solved in milestones, 0 never are
+        bool BOSSReplay                     = false;    // save every search of the game for BOSS_replay
+        bool BOSSStats                      = false;    // save the stats of every search of the game as json
         int ProductionJamFrameLimit			= 360;
         int WorkersPerRefinery              = 3;
         double WorkersPerPatch              = 3.0;
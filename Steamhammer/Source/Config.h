@@ -127,6 +127,14 @@ namespace Config
     namespace Macro
     {
         extern int BOSSFrameLimit;
+        extern int BOSSThreads;
+        extern bool BOSSAsync;
+        extern int BOSSTimeLimit;
+        extern bool BOSSCache;
+        extern int BOSSBeamGoalSize;
+        extern int BOSSMilestoneGoalSize;
+        extern bool BOSSReplay;
+        extern bool BOSSStats;
         extern int WorkersPerRefinery;
         extern double WorkersPerPatch;
         extern int AbsoluteMaxWorkers;
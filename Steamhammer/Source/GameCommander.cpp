@@ -108,6 +108,7 @@ void GameCommander::onEnd(bool isWinner)
 {
     OpponentModel::Instance().setWin(isWinner);
     OpponentModel::Instance().write();
+    BOSSManager::Instance().onEnd();
 
     // Clean up any data structures that may otherwise not be unwound in the correct order.
     // This fixes an end-of-game bug diagnosed by Bruce Nielsen.
@@ -1,12 +1,15 @@
 #include "Grid.h"
 
-#include "UABAssert.h"
+#include <cstdint>
+#include "MapAnalysisCache.h"
 
 using namespace UAlbertaBot;
 
 // Create an empty, unitialized, unusable grid.
 // Necessary if a Grid subclass is created before BWAPI is initialized.
 Grid::Grid()
+    : width(0)
+    , height(0)
 {
 }
 
@@ -14,21 +17,22 @@ Grid::Grid()
 Grid::Grid(int w, int h, int value)
     : width(w)
     , height(h)
-    , grid(w, std::vector<short>(h, value))
+    , grid(w * h, short(value))
 {
 }
 
-int Grid::get(int x, int y) const
+// For a subclass which initializes itself after construction.
+void Grid::setSize(int w, int h, short value)
 {
-    UAB_ASSERT(grid.size() == width && width > 0 && x >= 0 && y >= 0 && x < width && y < height,
-        "bad at(%d,%d) limit(%d,%d) size %dx%d", x, y, width, height, grid.size(), grid[0].size());
-
-    return grid[x][y];
+    width = w;
+    height = h;
+    grid.assign(w * h, value);
 }
 
-int Grid::at(int x, int y) const
+// The buffer is contiguous and aligned, so the compiler turns this into vector stores (a memset for 0).
+void Grid::fill(short value)
 {
-    return get(x, y);
+    std::fill(grid.begin(), grid.end(), value);
 }
 
 int Grid::at(const BWAPI::TilePosition & pos) const
@@ -54,23 +58,43 @@ int Grid::at(BWAPI::Unit unit) const
 // Check the correct shape of the data structure.
 void Grid::selfTest(const std::string & message) const
 {
-    UAB_ASSERT(width > 0 && width < 256 && height > 0 && height < 256 && grid.size() == width,
-        "bad size %dx%d (size %d)", width, height, grid.size());
-    for (size_t x = 0; x < grid.size(); ++x)
+    UAB_ASSERT(width > 0 && width <= 1024 && height > 0 && height <= 1024,
+        "%s: bad size %dx%d", message.c_str(), width, height);
+    UAB_ASSERT(grid.size() == size_t(width * height),
+        "%s: bad grid size %d for %dx%d", message.c_str(), int(grid.size()), width, height);
+    UAB_ASSERT(reinterpret_cast<uintptr_t>(grid.data()) % GridAllocator<short>::Alignment == 0,
+        "%s: grid not aligned", message.c_str());
+}
+
+void Grid::save(MapCacheWriter & out) const
+{
+    out.put(int32_t(width));
+    out.put(int32_t(height));
+    out.putArray(grid.data(), grid.size());
+}
+
+// The file was checked before it is read, so a bad size means a bug. Fail anyway; the grid will be computed.
+bool Grid::load(MapCacheReader & in)
+{
+    int32_t w, h;
+    if (!in.get(w) || !in.get(h) || w <= 0 || w > 1024 || h <= 0 || h > 1024)
     {
-        UAB_ASSERT(grid[x].size() == height, "%s: bad grid[%d] height %d in %dx%d", message.c_str(), x, grid[x].size(), width, height);
+        return false;
     }
+
+    setSize(w, h, short(0));
+    return in.getArray(grid.data(), grid.size());
 }
 
 // Draw a number in each tile.
 // This default method is overridden in some subclasses.
 void Grid::draw() const
 {
-    for (int x = 0; x < width; ++x)
+    for (int y = 0; y < height; ++y)
     {
-        for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
         {
-            int n = grid[x][y];
+            int n = cell(x, y);
             if (n)
             {
                 char color = n < 0 ? purple : gray;
@@ -80,4 +104,4 @@ void Grid::draw() const
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <new>
 #include <vector>
 #include "BWAPI.h"
+#include "UABAssert.h"
 
 // A base class that stores a short integer for each 32x32 build tile of the map,
 // for ground distances, threat maps, and so on.
@@ -9,6 +11,35 @@
 
 namespace UAlbertaBot
 {
+class MapCacheReader;
+class MapCacheWriter;
+
+// Allocates the grid values aligned to a cache line, so that fills and scans can use full vector loads.
+template <class T>
+class GridAllocator
+{
+public:
+    static const size_t Alignment = 64;
+
+    typedef T value_type;
+
+    GridAllocator() {}
+    template <class U> GridAllocator(const GridAllocator<U> &) {}
+
+    T * allocate(size_t n)
+    {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T * p, size_t)
+    {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <class U> bool operator==(const GridAllocator<U> &) const { return true; }
+    template <class U> bool operator!=(const GridAllocator<U> &) const { return false; }
+};
+
 class Grid
 {
 protected:
@@ -17,19 +48,39 @@ protected:
 
     int width;
     int height;
-    std::vector< std::vector<short> > grid;
+    std::vector<short, GridAllocator<short>> grid;     // row by row: the value of (x,y) is grid[y * width + x]
+
+    void setSize(int w, int h, short value);
+    void fill(short value);
+
+    // Unchecked access for subclasses which already know (x,y) is on the grid.
+    short & cell(int x, int y) { return grid[y * width + x]; };
+    short cell(int x, int y) const { return grid[y * width + x]; };
 
-    int get(int x, int y) const;
+    // One unsigned comparison per coordinate also catches negative values.
+    int get(int x, int y) const
+    {
+        UAB_ASSERT(unsigned(x) < unsigned(width) && unsigned(y) < unsigned(height),
+            "bad at(%d,%d) limit(%d,%d)", x, y, width, height);
+
+        return cell(x, y);
+    };
 
 public:
-    virtual int at(int x, int y) const;							// allow a subclass to decide the scale
-    virtual int at(const BWAPI::TilePosition & pos) const;
+    // The same scale for all grids, so not virtual.
+    int at(int x, int y) const { return get(x, y); };
+
+    virtual int at(const BWAPI::TilePosition & pos) const;		// allow a subclass to decide the scale
     virtual int at(const BWAPI::WalkPosition & pos) const;
     virtual int at(const BWAPI::Position & pos) const;
     virtual int at(BWAPI::Unit unit) const;
 
     virtual void selfTest(const std::string & message) const;
 
+    // For grids of static map analysis, which are saved per map.
+    virtual void save(MapCacheWriter & out) const;
+    virtual bool load(MapCacheReader & in);
+
     virtual void draw() const;
 };
 }
@@ -27,15 +27,16 @@ void GridAttacks::addTilesInRange(const BWAPI::Position & enemyPosition, int ran
     // Find the tiles inside the bounding box which are in range.
     // Be conservative: If the corner nearest the enemy is in range, the tile is in range.
     // The 32 is for converting from tiles to pixels.
-    for (int x = std::max(0, topLeftTile.x); x <= std::min(width-1, bottomRightTile.x); ++x)
+    // Row by row, to match the storage order.
+    for (int y = std::max(0, topLeftTile.y); y <= std::min(height-1, bottomRightTile.y); ++y)
     {
-        int nearestX = 32 * ((32 * x + 31 < enemyPosition.x) ? x + 1 : x);
-        for (int y = std::max(0, topLeftTile.y); y <= std::min(height-1, bottomRightTile.y); ++y)
+        int nearestY = 32 * ((32 * y + 31 <= enemyPosition.y) ? y + 1 : y);
+        for (int x = std::max(0, topLeftTile.x); x <= std::min(width-1, bottomRightTile.x); ++x)
         {
-            int nearestY = 32 * ((32 * y + 31 <= enemyPosition.y) ? y + 1 : y);
+            int nearestX = 32 * ((32 * x + 31 < enemyPosition.x) ? x + 1 : x);
             if (BWAPI::Position(nearestX, nearestY).getApproxDistance(enemyPosition) <= range)
             {
-                grid[x][y] += 1;
+                cell(x, y) += 1;
             }
         }
     }
@@ -87,11 +88,8 @@ GridAttacks::GridAttacks(bool air)
 // Initialize with attacks by the enemy, against either air or ground units.
 void GridAttacks::update()
 {
-    // Zero out the grid.
-    for (int x = 0; x < width; ++x)
-    {
-        std::fill(grid[x].begin(), grid[x].end(), 0);
-    }
+    // Zero out the grid. One contiguous buffer, so this is a single memset.
+    fill(0);
 
     // Fill in the grid.
     const std::map<BWAPI::Unit, UnitInfo> & unitsInfo =
@@ -108,14 +106,14 @@ void GridAttacks::update()
 
 bool GridAttacks::inRange(const BWAPI::TilePosition & pos) const
 {
-    return pos.isValid() && grid[pos.x][pos.y];
+    return pos.isValid() && cell(pos.x, pos.y);
 }
 
 bool GridAttacks::inRange(const BWAPI::TilePosition & topLeft, const BWAPI::TilePosition & bottomRight) const
 {
     UAB_ASSERT(topLeft.isValid() && bottomRight.isValid(), "bad rectangle");
 
-    if (grid[topLeft.x][topLeft.y])
+    if (cell(topLeft.x, topLeft.y))
     {
         return true;
     }
@@ -123,9 +121,9 @@ bool GridAttacks::inRange(const BWAPI::TilePosition & topLeft, const BWAPI::Tile
     // If the rectangle covers more than one tile, check each corner.
     if (topLeft != bottomRight)
     {
-        if (grid[bottomRight.x][bottomRight.y] ||
-            grid[topLeft.x][bottomRight.y] ||
-            grid[bottomRight.x][topLeft.y])
+        if (cell(bottomRight.x, bottomRight.y) ||
+            cell(topLeft.x, bottomRight.y) ||
+            cell(bottomRight.x, topLeft.y))
         {
             return true;
         }
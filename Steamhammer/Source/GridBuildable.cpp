@@ -30,7 +30,7 @@ void GridBuildable::compute()
             {
                 k = 0;
             }
-            grid[x][y] = k;
+            cell(x, y) = k;
         }
     }
 }
@@ -15,16 +15,17 @@ GridDistances::GridDistances()
 GridDistances::GridDistances(const BWAPI::TilePosition & start, bool neutralBlocks)
     : Grid(BWAPI::Broodwar->mapWidth(), BWAPI::Broodwar->mapHeight(), -1)
 {
-    compute(start, MAX_DISTANCE, neutralBlocks);
+    compute(start, MAX_DISTANCE, neutralBlocks, true);
 }
 
 // Compute the map only up to the given distance limit.
 // Tiles beyond the limit are "unreachable".
+// Set sortTiles = false to skip the list of tiles in order of distance, which is 4 times the size of the distances.
 // The start tile should be walkable!
-GridDistances::GridDistances(const BWAPI::TilePosition & start, int limit, bool neutralBlocks)
+GridDistances::GridDistances(const BWAPI::TilePosition & start, int limit, bool neutralBlocks, bool sortTiles)
     : Grid(BWAPI::Broodwar->mapWidth(), BWAPI::Broodwar->mapHeight(), -1)
 {
-    compute(start, limit, neutralBlocks);
+    compute(start, limit, neutralBlocks, sortTiles);
 }
 
 // Because of the simplified way Steamhammer computes whether a tile is walkable,
@@ -48,9 +49,17 @@ const std::vector<BWAPI::TilePosition> & GridDistances::getSortedTiles() const
     return sortedTilePositions;
 }
 
-// Computes grid[x][y] = Manhattan ground distance from the starting tile to (x,y),
+// Bytes used by the distances and the sorted tiles, for the cache in MapTools.
+size_t GridDistances::getMemorySize() const
+{
+    return sizeof(GridDistances) +
+        grid.capacity() * sizeof(short) +
+        sortedTilePositions.capacity() * sizeof(BWAPI::TilePosition);
+}
+
+// Computes cell(x, y) = Manhattan ground distance from the starting tile to (x,y),
 // up to the given limiting distance (and no farther, to save time).
-void GridDistances::compute(const BWAPI::TilePosition & start, int limit, bool neutralBlocks)
+void GridDistances::compute(const BWAPI::TilePosition & start, int limit, bool neutralBlocks, bool sortTiles)
 {
     const size_t LegalActions = 4;
     const int actionX[LegalActions] = { 1, -1, 0, 0 };
@@ -61,14 +70,14 @@ void GridDistances::compute(const BWAPI::TilePosition & start, int limit, bool n
     fringe.reserve(width * height);
     fringe.push_back(start);
 
-    grid[start.x][start.y] = 0;
-    sortedTilePositions.push_back(start);
+    cell(start.x, start.y) = 0;
+
 
     for (size_t fringeIndex=0; fringeIndex<fringe.size(); ++fringeIndex)
     {
         const BWAPI::TilePosition & tile = fringe[fringeIndex];
 
-        int currentDist = grid[tile.x][tile.y];
+        int currentDist = cell(tile.x, tile.y);
         if (currentDist >= limit)
         {
             continue;
@@ -81,13 +90,18 @@ void GridDistances::compute(const BWAPI::TilePosition & start, int limit, bool n
 
             // if the new tile is inside the map bounds, has not been visited yet, and is walkable
             if (nextTile.isValid() &&
-                grid[nextTile.x][nextTile.y] == -1 &&
+                cell(nextTile.x, nextTile.y) == -1 &&
                 (neutralBlocks ? the.map.isWalkable(nextTile) : the.map.isTerrainWalkable(nextTile)))
             {
                 fringe.push_back(nextTile);
-                grid[nextTile.x][nextTile.y] = currentDist + 1;
-                sortedTilePositions.push_back(nextTile);
+                cell(nextTile.x, nextTile.y) = currentDist + 1;
             }
         }
     }
+
+    // The fringe is already in order of distance.
+    if (sortTiles)
+    {
+        sortedTilePositions = fringe;
+    }
 }
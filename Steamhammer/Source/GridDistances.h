@@ -10,15 +10,18 @@ class GridDistances : public Grid
 {
     std::vector<BWAPI::TilePosition> sortedTilePositions;
 
-    void compute(const BWAPI::TilePosition & start, int limit, bool neutralBlocks);
+    void compute(const BWAPI::TilePosition & start, int limit, bool neutralBlocks, bool sortTiles);
 
 public:
     GridDistances();
     GridDistances(const BWAPI::TilePosition & start, bool neutralBlocks = true);
-    GridDistances(const BWAPI::TilePosition & start, int limit, bool neutralBlocks = true);
+    GridDistances(const BWAPI::TilePosition & start, int limit, bool neutralBlocks = true, bool sortTiles = true);
 
     int getStaticUnitDistance(const BWAPI::Unit unit) const;
 
+    bool hasSortedTiles() const { return !sortedTilePositions.empty(); };
     const std::vector<BWAPI::TilePosition> & getSortedTiles() const;
+
+    size_t getMemorySize() const;
 };
 }
\ No newline at end of file
@@ -21,9 +21,7 @@ GridInset::GridInset()
 // This depends on the.partitions already being initialized.
 void GridInset::initialize()
 {
-    width = 4 * BWAPI::Broodwar->mapWidth();
-    height = 4 * BWAPI::Broodwar->mapHeight();
-    grid = std::vector< std::vector<short> >(width, std::vector<short>(height, short(-1)));
+    setSize(4 * BWAPI::Broodwar->mapWidth(), 4 * BWAPI::Broodwar->mapHeight(), short(-1));
 
     std::vector<BWAPI::WalkPosition> fringe;
     fringe.reserve(width * height);
@@ -35,20 +33,20 @@ void GridInset::initialize()
         if (the.partitions.walkable(x, 0))
         {
             fringe.push_back(BWAPI::WalkPosition(x, 0));
-            grid[x][0] = 1;
+            cell(x, 0) = 1;
         }
         else
         {
-            grid[x][0] = 0;
+            cell(x, 0) = 0;
         }
         if (the.partitions.walkable(x, height-1))
         {
             fringe.push_back(BWAPI::WalkPosition(x, height-1));
-            grid[x][height-1] = 1;
+            cell(x, height-1) = 1;
         }
         else
         {
-            grid[x][height-1] = 0;
+            cell(x, height-1) = 0;
         }
     }
     for (int y = 1; y < height-1; ++y)			// don't add the corner tiles again
@@ -56,20 +54,20 @@ void GridInset::initialize()
         if (the.partitions.walkable(0, y))
         {
             fringe.push_back(BWAPI::WalkPosition(0, y));
-            grid[0][y] = 1;
+            cell(0, y) = 1;
         }
         else
         {
-            grid[0][y] = 0;
+            cell(0, y) = 0;
         }
         if (the.partitions.walkable(width-1, y))
         {
             fringe.push_back(BWAPI::WalkPosition(width-1, y));
-            grid[width-1][y] = 1;
+            cell(width-1, y) = 1;
         }
         else
         {
-            grid[width-1][y] = 0;
+            cell(width-1, y) = 0;
         }
     }
 
@@ -86,12 +84,12 @@ void GridInset::initialize()
                     !the.partitions.walkable(x, y - 1))
                 {
                     fringe.push_back(BWAPI::WalkPosition(x, y));
-                    grid[x][y] = 1;
+                    cell(x, y) = 1;
                 }
             }
             else
             {
-                grid[x][y] = 0;
+                cell(x, y) = 0;
             }
         }
     }
@@ -101,7 +99,7 @@ void GridInset::initialize()
     {
         const BWAPI::WalkPosition & tile = fringe[fringeIndex];
 
-        int currentDist = grid[tile.x][tile.y];
+        int currentDist = cell(tile.x, tile.y);
 
         // The legal actions define which tiles are nearest neighbors of this one.
         for (size_t a = 0; a < LegalActions; ++a)
@@ -110,10 +108,10 @@ void GridInset::initialize()
 
             // If the new tile is inside the map bounds, has not been visited yet, and is walkable.
             if (nextTile.isValid() &&
-                grid[nextTile.x][nextTile.y] == -1)		// unwalkable tiles were set to 0 above
+                cell(nextTile.x, nextTile.y) == -1)		// unwalkable tiles were set to 0 above
             {
                 fringe.push_back(nextTile);
-                grid[nextTile.x][nextTile.y] = currentDist + 1;
+                cell(nextTile.x, nextTile.y) = currentDist + 1;
             }
         }
     }
@@ -165,11 +163,11 @@ BWAPI::Position GridInset::find(const BWAPI::Position & start, int inset)
 // Draw the edge ranges as colored contours of dots.
 void GridInset::draw() const
 {
-    for (int x = 0; x < width; ++x)
+    for (int y = 0; y < height; ++y)
     {
-        for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
         {
-            int d = grid[x][y];
+            int d = cell(x, y);
             BWAPI::Color color = BWAPI::Colors::Black;
             if (d > 0)
             {
@@ -23,9 +23,7 @@ GridRoom::GridRoom()
 void GridRoom::initialize()
 {
     // 1. Fill with -1.
-    width = 4 * BWAPI::Broodwar->mapWidth();
-    height = 4 * BWAPI::Broodwar->mapHeight();
-    grid = std::vector< std::vector<short> >(width, std::vector<short>(height, short(-1)));
+    setSize(4 * BWAPI::Broodwar->mapWidth(), 4 * BWAPI::Broodwar->mapHeight(), short(-1));
 
     // 2. Overwrite with vertical room values.
     for (int x = 0; x < width; ++x)
@@ -80,7 +78,7 @@ looptop:
                         // D. We found the end point. Fill in the range.
                         for (int i = startY; i <= y; ++i)
                         {
-                            grid[x][i] = value;
+                            cell(x, i) = value;
                         }
                         ++y;
                         goto looptop;
@@ -93,11 +91,11 @@ looptop:
 
 void GridRoom::draw() const
 {
-    for (int x = 0; x < width; ++x)
+    for (int y = 0; y < height; ++y)
     {
-        for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
         {
-            int d = grid[x][y];
+            int d = cell(x, y);
             BWAPI::Color color = BWAPI::Colors::Black;
             if (d > 0)
             {
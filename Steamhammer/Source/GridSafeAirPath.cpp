@@ -29,7 +29,7 @@ const std::vector<BWAPI::TilePosition> & GridSafeAirPath::getSortedTiles() const
     return sortedTilePositions;
 }
 
-// Computes grid[x][y] = Manhattan ground distance from the starting tile to (x,y),
+// Computes cell(x, y) = Manhattan ground distance from the starting tile to (x,y),
 // up to the given limiting distance (and no farther, to save time).
 // Uses BFS, since the map is quite large and DFS may cause a stack overflow
 void GridSafeAirPath::computeAir(const BWAPI::TilePosition & start, int limit)
@@ -43,14 +43,14 @@ void GridSafeAirPath::computeAir(const BWAPI::TilePosition & start, int limit)
     fringe.reserve(width * height);
     fringe.push_back(start);
 
-    grid[start.x][start.y] = 0;
+    cell(start.x, start.y) = 0;
     sortedTilePositions.push_back(start);
 
     for (size_t fringeIndex=0; fringeIndex<fringe.size(); ++fringeIndex)
     {
         const BWAPI::TilePosition & tile = fringe[fringeIndex];
 
-        int currentDist = grid[tile.x][tile.y];
+        int currentDist = cell(tile.x, tile.y);
         if (currentDist >= limit)
         {
             continue;
@@ -62,11 +62,11 @@ void GridSafeAirPath::computeAir(const BWAPI::TilePosition & start, int limit)
             BWAPI::TilePosition nextTile(tile.x + actionX[a], tile.y + actionY[a]);
 
             if (nextTile.isValid() &&
-                grid[nextTile.x][nextTile.y] == -1 &&
+                cell(nextTile.x, nextTile.y) == -1 &&
                 the.airAttacks.at(nextTile) == 0)
             {
                 fringe.push_back(nextTile);
-                grid[nextTile.x][nextTile.y] = currentDist;
+                cell(nextTile.x, nextTile.y) = currentDist;
                 sortedTilePositions.push_back(nextTile);
             }
         }
@@ -19,17 +19,15 @@ GridTileRoom::GridTileRoom()
 void GridTileRoom::initialize()
 {
     // 1. Fill with -1.
-    width = BWAPI::Broodwar->mapWidth();
-    height = BWAPI::Broodwar->mapHeight();
-    grid = std::vector< std::vector<short> >(width, std::vector<short>(height, short(-1)));
+    setSize(BWAPI::Broodwar->mapWidth(), BWAPI::Broodwar->mapHeight(), short(-1));
 
-    // 2. Loop over each walk tile.
-    for (int x = 0; x < 4 * width; ++x)
+    // 2. Loop over each walk tile, row by row to match the storage order.
+    for (int y = 0; y < 4 * height; ++y)
     {
-        for (int y = 0; y < 4 * height; ++y)
+        for (int x = 0; x < 4 * width; ++x)
         {
             BWAPI::TilePosition tile(BWAPI::WalkPosition(x, y));
-            grid[tile.x][tile.y] = std::max(grid[tile.x][tile.y], short(the.vWalkRoom.at(x,y)));
+            cell(tile.x, tile.y) = std::max(cell(tile.x, tile.y), short(the.vWalkRoom.at(x,y)));
         }
     }
 }
@@ -37,11 +35,11 @@ void GridTileRoom::initialize()
 void GridTileRoom::draw() const
 {
     /* A number on each tile. */
-    for (int x = 0; x < width; ++x)
+    for (int y = 0; y < height; ++y)
     {
-        for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
         {
-            int d = grid[x][y];
+            int d = cell(x, y);
             if (d > 0)
             {
                 BWAPI::Broodwar->drawTextMap(
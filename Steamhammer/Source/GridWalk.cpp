@@ -17,11 +17,6 @@ GridWalk::GridWalk(int w, int h, int value)
 {
 }
 
-int GridWalk::at(int x, int y) const
-{
-    return get(x, y);
-}
-
 int GridWalk::at(const BWAPI::TilePosition & pos) const
 {
     return at(BWAPI::WalkPosition(pos));
@@ -14,7 +14,8 @@ protected:
     GridWalk(int w, int h, int value);
 
 public:
-    int at(int x, int y) const;
+    using Grid::at;
+
     int at(const BWAPI::TilePosition & pos) const;
     int at(const BWAPI::WalkPosition & pos) const;
     int at(const BWAPI::Position & pos) const;
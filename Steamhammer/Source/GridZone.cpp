@@ -1,5 +1,6 @@
 #include "GridZone.h"
 
+#include "MapAnalysisCache.h"
 #include "The.h"
 
 using namespace UAlbertaBot;
@@ -83,10 +84,20 @@ void GridZone::newZoneID(const Zone * zone, int id)
 {
     for (const BWAPI::TilePosition & tile : zone->tiles())
     {
-        grid[tile.x][tile.y] = id;
+        cell(tile.x, tile.y) = id;
     }
 }
 
+// Forget zones from a saved file that failed to load.
+void GridZone::clearZones()
+{
+    for (Zone * zone : zones)
+    {
+        delete zone;
+    }
+    zones.clear();
+}
+
 // This is a little expensive, but it is a valuable test during development.
 void GridZone::sanityCheck()
 {
@@ -100,12 +111,12 @@ void GridZone::sanityCheck()
             if (zone)
             {
                 UAB_ASSERT(zone->id() > 0 && zone->id() < int(zones.size()), "bad zone id");
-                UAB_ASSERT(zone->id() == grid[x][y], "zone id mismatch");
+                UAB_ASSERT(zone->id() == cell(x, y), "zone id mismatch");
                 tileCount[zone->id()] += 1;
             }
             else
             {
-                UAB_ASSERT(grid[x][y] == 0, "non-zero non-zone");
+                UAB_ASSERT(cell(x, y) == 0, "non-zero non-zone");
                 zone = zones[0];
                 UAB_ASSERT(zone->id() == 0 && !zone->isValid(), "non-zone is valid zone");
             }
@@ -172,9 +183,8 @@ void GridZone::initialize()
     const int minArea = 3;		// zone with fewer tiles than this is merged or invalidated
 
     // 1. Fill with 0.
-    width = BWAPI::Broodwar->mapWidth();
-    height = BWAPI::Broodwar->mapHeight();
-    grid = std::vector< std::vector<short> >(width, std::vector<short>(height, short(0)));
+    setSize(BWAPI::Broodwar->mapWidth(), BWAPI::Broodwar->mapHeight(), short(0));
+    clearZones();
 
     // 0 is the id of the "not a zone" zone.
     // 0 values in the grid that are found to be part of a zone will be overwritten.
@@ -187,10 +197,10 @@ void GridZone::initialize()
         for (int y = 0; y < height; ++y)
         {
             const BWAPI::TilePosition xy(x, y);
-            if (grid[x][y] == 0 && the.tileRoom.at(xy) >= minRoom)
+            if (cell(x, y) == 0 && the.tileRoom.at(xy) >= minRoom)
             {
                 // 3. Fill in the next zone.
-                grid[x][y] = zoneID;
+                cell(x, y) = zoneID;
                 zones.push_back(new Zone(zoneID));
                 Zone * zone(zones.back());
                 zone->_state = the.tileRoom.at(xy) <= chokeWidth ? ZoneState::Choke : ZoneState::Normal;
@@ -211,7 +221,7 @@ void GridZone::initialize()
 
                         if (nextTile.isValid())
                         {
-                            int id = grid[nextTile.x][nextTile.y];
+                            int id = cell(nextTile.x, nextTile.y);
                             if (id != 0)
                             {
                                 if (id != zoneID)	// all zones other than 0 are valid so far
@@ -232,7 +242,7 @@ void GridZone::initialize()
                                 //      Only merger creates a Normal zone with varying heights.
                                 zone->_tiles.push_back(nextTile);
                                 fringe.push_back(nextTile);
-                                grid[nextTile.x][nextTile.y] = zoneID;
+                                cell(nextTile.x, nextTile.y) = zoneID;
                             }
                         }
                     }
@@ -323,6 +333,94 @@ void GridZone::initialize()
     // sanityCheck();
 }
 
+// Save the zones after the grid. Neighbors are saved by ID.
+void GridZone::save(MapCacheWriter & out) const
+{
+    Grid::save(out);
+
+    out.put(int32_t(zones.size()));
+    for (const Zone * zone : zones)
+    {
+        out.put(int32_t(zone->_state));
+        out.put(int32_t(zone->_groundHeight));
+
+        out.put(int32_t(zone->_tiles.size()));
+        for (const BWAPI::TilePosition & tile : zone->_tiles)
+        {
+            out.put(int16_t(tile.x));
+            out.put(int16_t(tile.y));
+        }
+
+        out.put(int32_t(zone->_neighbors.size()));
+        for (const Zone * neighbor : zone->_neighbors)
+        {
+            out.put(int32_t(neighbor->_id));
+        }
+    }
+}
+
+// Create all the zones first, so that neighbor IDs can be turned into pointers.
+bool GridZone::load(MapCacheReader & in)
+{
+    clearZones();
+
+    int32_t nZones;
+    if (!Grid::load(in) || !in.get(nZones) || nZones <= 0 || nZones > width * height + 1)
+    {
+        return false;
+    }
+
+    for (int id = 0; id < nZones; ++id)
+    {
+        zones.push_back(new Zone(id));
+    }
+
+    for (Zone * zone : zones)
+    {
+        int32_t state, groundHeight, nTiles;
+        if (!in.get(state) || !in.get(groundHeight) || !in.get(nTiles) ||
+            state < int32_t(ZoneState::Choke) || state > int32_t(ZoneState::Invalid) ||
+            nTiles < 0 || nTiles > width * height)
+        {
+            clearZones();
+            return false;
+        }
+        zone->_state = ZoneState(state);
+        zone->_groundHeight = groundHeight;
+
+        zone->_tiles.reserve(nTiles);
+        for (int i = 0; i < nTiles; ++i)
+        {
+            int16_t x, y;
+            if (!in.get(x) || !in.get(y) || !BWAPI::TilePosition(x, y).isValid())
+            {
+                clearZones();
+                return false;
+            }
+            zone->_tiles.push_back(BWAPI::TilePosition(x, y));
+        }
+
+        int32_t nNeighbors;
+        if (!in.get(nNeighbors) || nNeighbors < 0 || nNeighbors >= nZones)
+        {
+            clearZones();
+            return false;
+        }
+        for (int i = 0; i < nNeighbors; ++i)
+        {
+            int32_t neighborID;
+            if (!in.get(neighborID) || neighborID <= 0 || neighborID >= nZones)
+            {
+                clearZones();
+                return false;
+            }
+            zone->_neighbors.insert(zones[neighborID]);
+        }
+    }
+
+    return true;
+}
+
 // The zone with id N is stored at index N in the vector.
 Zone * GridZone::ptr(int id)
 {
@@ -340,7 +438,7 @@ Zone * GridZone::ptr(int id)
 // x and y are TilePosition coordinates.
 Zone * GridZone::ptr(int x, int y)
 {
-    return ptr(grid[x][y]);
+    return ptr(cell(x, y));
 }
 
 Zone * GridZone::ptr(const BWAPI::TilePosition & tile)
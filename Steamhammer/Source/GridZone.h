@@ -51,6 +51,7 @@ private:
     std::vector<Zone *> zones;
 
     void newZoneID(const Zone * zone, int id);
+    void clearZones();
 
     void sanityCheck();
 
@@ -59,6 +60,12 @@ public:
 
     void initialize();
 
+    void save(MapCacheWriter & out) const override;
+    bool load(MapCacheReader & in) override;
+
+    // Zone IDs run from 1 to size() - 1. Some zones may be invalid.
+    int size() const { return int(zones.size()); };
+
     // Return nullptr for zone 0, a pointer to the zone otherwise.
     Zone * ptr(int id);
     Zone * ptr(int x, int y);
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+// Combine a value into a hash, for keys of saved data that have to be the same in every game.
+// std::hash is not guaranteed to be, so it can't be used for those.
+
+namespace UAlbertaBot
+{
+inline uint64_t HashMix(uint64_t hash, uint64_t value)
+{
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+}
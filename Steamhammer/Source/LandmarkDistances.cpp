@@ -0,0 +1,234 @@
+#include "LandmarkDistances.h"
+
+#include <cstdint>
+#include <fstream>
+#include "The.h"
+
+using namespace UAlbertaBot;
+
+namespace
+{
+    const uint32_t FileMagic    = 0x4b524d4c;   // "LMRK"
+    const uint32_t FileVersion  = 1;
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        int32_t  width;
+        int32_t  height;
+        int32_t  numLandmarks;
+    };
+
+    // The route through the landmarks is at most 2 * (distance to the landmarks) longer than the true distance.
+    // Estimate only when that is at most 1 / MaxErrorDivisor of the distance between the landmarks.
+    const int MaxErrorDivisor = 5;
+}
+
+LandmarkDistances::LandmarkDistances()
+    : width(0)
+    , height(0)
+{
+}
+
+// Call after the landmark distance maps are cached in MapTools, which makes the table cheap to fill in.
+void LandmarkDistances::initialize(const std::vector<BWAPI::TilePosition> & landmarkTiles)
+{
+    width = BWAPI::Broodwar->mapWidth();
+    height = BWAPI::Broodwar->mapHeight();
+    landmarks = landmarkTiles;
+
+    // The file is written to the write dir. Look there too, as MapAnalysisCache does.
+    if (read(Config::IO::ReadDir + filename()) ||
+        (Config::IO::WriteDir != Config::IO::ReadDir && read(Config::IO::WriteDir + filename())))
+    {
+        return;
+    }
+
+    // A file that failed to read may have left partial data.
+    nearest.clear();
+    computeTable();
+    computeNearest();
+    write(Config::IO::WriteDir + filename());
+}
+
+void LandmarkDistances::computeTable()
+{
+    const size_t n = landmarks.size();
+    table.assign(n * n, short(-1));
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            table[i * n + j] = short(the.map.getGroundTileDistance(landmarks[j], landmarks[i]));
+        }
+    }
+}
+
+// One breadth-first search from all landmarks at once finds each tile's nearest landmark.
+void LandmarkDistances::computeNearest()
+{
+    const size_t LegalActions = 4;
+    const int actionX[LegalActions] = { 1, -1, 0, 0 };
+    const int actionY[LegalActions] = { 0, 0, 1, -1 };
+
+    nearest.assign(width * height, short(-1));
+    nearestDistance.assign(width * height, short(-1));
+
+    std::vector<BWAPI::TilePosition> fringe;
+    fringe.reserve(width * height);
+
+    for (size_t i = 0; i < landmarks.size(); ++i)
+    {
+        const BWAPI::TilePosition & tile = landmarks[i];
+        if (nearest[tile.y * width + tile.x] == -1)
+        {
+            nearest[tile.y * width + tile.x] = short(i);
+            nearestDistance[tile.y * width + tile.x] = 0;
+            fringe.push_back(tile);
+        }
+    }
+
+    for (size_t fringeIndex = 0; fringeIndex < fringe.size(); ++fringeIndex)
+    {
+        const BWAPI::TilePosition & tile = fringe[fringeIndex];
+        const int index = tile.y * width + tile.x;
+
+        for (size_t a = 0; a < LegalActions; ++a)
+        {
+            BWAPI::TilePosition nextTile(tile.x + actionX[a], tile.y + actionY[a]);
+            if (nextTile.isValid() &&
+                nearest[nextTile.y * width + nextTile.x] == -1 &&
+                the.map.isWalkable(nextTile))
+            {
+                fringe.push_back(nextTile);
+                nearest[nextTile.y * width + nextTile.x] = nearest[index];
+                nearestDistance[nextTile.y * width + nextTile.x] = nearestDistance[index] + 1;
+            }
+        }
+    }
+}
+
+// Distance in tiles between two landmarks, -1 if not connected by ground.
+int LandmarkDistances::distance(int from, int to) const
+{
+    UAB_ASSERT(from >= 0 && from < size() && to >= 0 && to < size(), "bad landmark");
+    return table[from * size() + to];
+}
+
+// Estimated ground distance in tiles by way of the nearest landmarks of the tiles.
+// Return -1 if there is no good enough estimate: A tile has no landmark, both have the same landmark,
+// the landmarks are not connected, or the tiles are too far from their landmarks for the distance.
+// Not connected is not an estimate, so a caller can't tell it apart from no estimate.
+int LandmarkDistances::estimate(const BWAPI::TilePosition & from, const BWAPI::TilePosition & to) const
+{
+    if (nearest.empty() || !from.isValid() || !to.isValid())
+    {
+        return -1;
+    }
+
+    const int fromLandmark = nearest[from.y * width + from.x];
+    const int toLandmark = nearest[to.y * width + to.x];
+    if (fromLandmark < 0 || toLandmark < 0 || fromLandmark == toLandmark)
+    {
+        return -1;
+    }
+
+    const int between = distance(fromLandmark, toLandmark);
+    const int detour = nearestDistance[from.y * width + from.x] + nearestDistance[to.y * width + to.x];
+    if (between < 0 || MaxErrorDivisor * 2 * detour > between)
+    {
+        return -1;
+    }
+
+    return between + detour;
+}
+
+// One file per map.
+std::string LandmarkDistances::filename() const
+{
+    return "landmarks_" + BWAPI::Broodwar->mapHash() + ".dat";
+}
+
+// Read the file if it exists and has the same landmarks, which are found from the map the same way every game.
+bool LandmarkDistances::read(const std::string & filename)
+{
+    std::ifstream inFile(filename, std::ios::binary);
+    if (!inFile.good())
+    {
+        return false;
+    }
+
+    FileHeader header;
+    inFile.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!inFile.good() ||
+        header.magic != FileMagic || header.version != FileVersion ||
+        header.width != width || header.height != height || header.numLandmarks != size())
+    {
+        return false;
+    }
+
+    std::vector<short> tiles(2 * landmarks.size());
+    inFile.read(reinterpret_cast<char *>(tiles.data()), tiles.size() * sizeof(short));
+    for (size_t i = 0; i < landmarks.size(); ++i)
+    {
+        if (tiles[2 * i] != landmarks[i].x || tiles[2 * i + 1] != landmarks[i].y)
+        {
+            return false;
+        }
+    }
+
+    table.resize(landmarks.size() * landmarks.size());
+    nearest.resize(width * height);
+    nearestDistance.resize(width * height);
+    inFile.read(reinterpret_cast<char *>(table.data()), table.size() * sizeof(short));
+    inFile.read(reinterpret_cast<char *>(nearest.data()), nearest.size() * sizeof(short));
+    inFile.read(reinterpret_cast<char *>(nearestDistance.data()), nearestDistance.size() * sizeof(short));
+
+    // A short file leaves the data unusable. Say so, and it will be computed and written again.
+    if (!inFile.good())
+    {
+        return false;
+    }
+
+    // The values are used as indexes, so a damaged file must not get through.
+    for (size_t i = 0; i < nearest.size(); ++i)
+    {
+        if (nearest[i] < -1 || nearest[i] >= size() || nearestDistance[i] < -1)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void LandmarkDistances::write(const std::string & filename) const
+{
+    std::ofstream outFile(filename, std::ios::binary | std::ios::trunc);
+    if (!outFile.good())
+    {
+        return;
+    }
+
+    FileHeader header;
+    header.magic = FileMagic;
+    header.version = FileVersion;
+    header.width = width;
+    header.height = height;
+    header.numLandmarks = size();
+    outFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    std::vector<short> tiles;
+    for (const BWAPI::TilePosition & tile : landmarks)
+    {
+        tiles.push_back(short(tile.x));
+        tiles.push_back(short(tile.y));
+    }
+    outFile.write(reinterpret_cast<const char *>(tiles.data()), tiles.size() * sizeof(short));
+
+    outFile.write(reinterpret_cast<const char *>(table.data()), table.size() * sizeof(short));
+    outFile.write(reinterpret_cast<const char *>(nearest.data()), nearest.size() * sizeof(short));
+    outFile.write(reinterpret_cast<const char *>(nearestDistance.data()), nearestDistance.size() * sizeof(short));
+}
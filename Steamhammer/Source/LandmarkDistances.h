@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include "BWAPI.h"
+
+// Ground distances between landmarks, the bases and chokes of the map, for estimating distances between tiles.
+// Every tile also knows its nearest landmark and its distance from it, so the distance between two tiles
+// can be estimated as tile -> landmark -> landmark -> tile without a search.
+// It's all saved in a file per map, so later games on the same map read it instead of computing it.
+
+namespace UAlbertaBot
+{
+class LandmarkDistances
+{
+    int width;
+    int height;
+
+    std::vector<BWAPI::TilePosition> landmarks;
+    std::vector<short> table;				// table[i * landmarks.size() + j] = distance from landmark i to j, -1 if not connected
+    std::vector<short> nearest;				// row by row, the index of each tile's nearest landmark, -1 if none
+    std::vector<short> nearestDistance;		// row by row, the distance from each tile to its nearest landmark
+
+    void computeTable();
+    void computeNearest();
+
+    std::string filename() const;
+    bool read(const std::string & filename);
+    void write(const std::string & filename) const;
+
+public:
+    LandmarkDistances();
+
+    void initialize(const std::vector<BWAPI::TilePosition> & landmarkTiles);
+
+    int size() const { return int(landmarks.size()); };
+    int distance(int from, int to) const;
+
+    int estimate(const BWAPI::TilePosition & from, const BWAPI::TilePosition & to) const;
+};
+}
@@ -0,0 +1,176 @@
+#include "MapAnalysisCache.h"
+
+#include <fstream>
+#include "Bases.h"
+#include "HashMix.h"
+#include "The.h"
+
+using namespace UAlbertaBot;
+
+namespace
+{
+    const uint32_t FileMagic    = 0x5050414d;   // "MAPP"
+
+    // Increase the version when the analysis or the saved format changes, so that old files are recomputed.
+    const uint32_t FileVersion  = 1;
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        int32_t  width;             // in build tiles
+        int32_t  height;
+        uint64_t layoutKey;         // the map and its static neutral units
+        uint64_t payloadSize;       // bytes after the header
+        uint64_t checksum;          // of the bytes after the header
+    };
+}
+
+MapCacheReader::MapCacheReader(const char * data, size_t size)
+    : _data(data)
+    , _size(size)
+    , _pos(0)
+{
+}
+
+// -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+
+// One file per map.
+std::string MapAnalysisCache::filename() const
+{
+    return "map_analysis_" + BWAPI::Broodwar->mapHash() + ".dat";
+}
+
+// Check everything about the file before trusting any of it.
+bool MapAnalysisCache::validate(uint64_t layoutKey) const
+{
+    if (file.size() < sizeof(FileHeader))
+    {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    return
+        header.magic == FileMagic &&
+        header.version == FileVersion &&
+        header.width == BWAPI::Broodwar->mapWidth() &&
+        header.height == BWAPI::Broodwar->mapHeight() &&
+        header.layoutKey == layoutKey &&
+        header.payloadSize == file.size() - sizeof(FileHeader) &&
+        header.checksum == Checksum(file.data() + sizeof(FileHeader), file.size() - sizeof(FileHeader));
+}
+
+// Read the analysis in the order that save() wrote it.
+bool MapAnalysisCache::read(uint64_t layoutKey)
+{
+    if (!validate(layoutKey))
+    {
+        return false;
+    }
+
+    MapCacheReader in(file.data() + sizeof(FileHeader), file.size() - sizeof(FileHeader));
+
+    return
+        the.partitions.load(in) &&
+        the.inset.load(in) &&
+        the.vWalkRoom.load(in) &&
+        the.tileRoom.load(in) &&
+        the.zone.load(in) &&
+        the.bases.loadBasePositions(in) &&
+        in.atEnd();
+}
+
+// The map hash covers the terrain. The static neutral units may differ on the same terrain
+// (for example, a map version with or without mineral blocks), and they affect walkability and bases.
+uint64_t MapAnalysisCache::LayoutKey()
+{
+    uint64_t hash = HashMix(FileMagic, BWAPI::Broodwar->mapWidth());
+    hash = HashMix(hash, BWAPI::Broodwar->mapHeight());
+    for (char c : BWAPI::Broodwar->mapHash())
+    {
+        hash = HashMix(hash, uint8_t(c));
+    }
+
+    // Adding makes the key independent of the order of the units.
+    uint64_t neutrals = 0;
+    for (BWAPI::Unit unit : BWAPI::Broodwar->getStaticNeutralUnits())
+    {
+        const BWAPI::TilePosition tile = unit->getInitialTilePosition();
+        neutrals += HashMix(HashMix(HashMix(unit->getType().getID(), tile.x), tile.y), unit->getInitialResources());
+    }
+
+    return HashMix(hash, neutrals);
+}
+
+// FNV-1a taken 8 bytes at a time. It's a check against truncated or damaged files, not against tampering,
+// and it has to be fast for a file of several megabytes.
+uint64_t MapAnalysisCache::Checksum(const char * data, size_t size)
+{
+    const uint64_t Prime = 0x100000001b3ULL;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * Prime;
+    }
+    for (; i < size; ++i)
+    {
+        hash = (hash ^ uint8_t(data[i])) * Prime;
+    }
+
+    return hash;
+}
+
+// -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+
+// The file is written to the write dir. Tournaments copy it to the read dir for later games;
+// when testing it usually stays in the write dir. Look in both places.
+bool MapAnalysisCache::load()
+{
+    const uint64_t layoutKey = LayoutKey();
+
+    bool loaded = file.open(Config::IO::ReadDir + filename()) && read(layoutKey);
+    if (!loaded && Config::IO::WriteDir != Config::IO::ReadDir)
+    {
+        loaded = file.open(Config::IO::WriteDir + filename()) && read(layoutKey);
+    }
+
+    // Everything was copied out of the file.
+    file.close();
+    return loaded;
+}
+
+void MapAnalysisCache::save()
+{
+    MapCacheWriter out;
+    the.partitions.save(out);
+    the.inset.save(out);
+    the.vWalkRoom.save(out);
+    the.tileRoom.save(out);
+    the.zone.save(out);
+    the.bases.saveBasePositions(out);
+
+    const std::vector<char> & bytes = out.bytes();
+
+    FileHeader header;
+    header.magic = FileMagic;
+    header.version = FileVersion;
+    header.width = BWAPI::Broodwar->mapWidth();
+    header.height = BWAPI::Broodwar->mapHeight();
+    header.layoutKey = LayoutKey();
+    header.payloadSize = bytes.size();
+    header.checksum = Checksum(bytes.data(), bytes.size());
+
+    std::ofstream outFile(Config::IO::WriteDir + filename(), std::ios::binary | std::ios::trunc);
+    if (!outFile.good())
+    {
+        return;
+    }
+    outFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    outFile.write(bytes.data(), bytes.size());
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// The static map analysis saved in a file per map, so that later games on the same map
+// read it instead of computing it: map partitions, inset, room, tile room, zones, and the base placements.
+// The file is only used if it was made from the same map with the same static neutral units,
+// by the same version of the analysis code, and its checksum matches.
+
+namespace UAlbertaBot
+{
+// Collects the saved data. Each analysis class writes its own values in its own order.
+class MapCacheWriter
+{
+    std::vector<char> _bytes;
+
+public:
+    template <class T> void put(const T & value)
+    {
+        putArray(&value, 1);
+    };
+
+    template <class T> void putArray(const T * values, size_t n)
+    {
+        const char * bytes = reinterpret_cast<const char *>(values);
+        _bytes.insert(_bytes.end(), bytes, bytes + n * sizeof(T));
+    };
+
+    const std::vector<char> & bytes() const { return _bytes; };
+};
+
+// Reads the values back in the same order. A read past the end fails instead of reading garbage.
+// The mapped data has no alignment guarantee, so values are copied out.
+class MapCacheReader
+{
+    const char * _data;
+    size_t _size;
+    size_t _pos;
+
+public:
+    MapCacheReader(const char * data, size_t size);
+
+    template <class T> bool get(T & value)
+    {
+        return getArray(&value, 1);
+    };
+
+    template <class T> bool getArray(T * values, size_t n)
+    {
+        const size_t bytes = n * sizeof(T);
+        if (bytes > _size - _pos)
+        {
+            return false;
+        }
+        std::memcpy(values, _data + _pos, bytes);
+        _pos += bytes;
+        return true;
+    };
+
+    bool atEnd() const { return _pos == _size; };
+};
+
+class MapAnalysisCache
+{
+    MappedFile file;
+
+    std::string filename() const;
+    bool validate(uint64_t layoutKey) const;
+    bool read(uint64_t layoutKey);
+
+    static uint64_t LayoutKey();
+    static uint64_t Checksum(const char * data, size_t size);
+
+public:
+    // Fill in the map analysis from the file. Return false if there is no usable file.
+    bool load();
+
+    // Write the map analysis after it has been computed.
+    void save();
+};
+}
@@ -1,5 +1,6 @@
 #include "MapPartitions.h"
 
+#include "MapAnalysisCache.h"
 #include "UABAssert.h"
 
 using namespace UAlbertaBot;
@@ -98,6 +99,7 @@ void MapPartitions::initialize()
 {
     width = 4 * BWAPI::Broodwar->mapWidth();
     height = 4 * BWAPI::Broodwar->mapHeight();
+    numPartitions = 0;
 
     findUnwalkability();
 
@@ -120,6 +122,44 @@ void MapPartitions::initialize()
     UAB_ASSERT(numPartitions > 0, "no partitions");
 }
 
+// The grids are stored column by column, x then y, so that's how they are saved.
+void MapPartitions::save(MapCacheWriter & out) const
+{
+    out.put(int32_t(width));
+    out.put(int32_t(height));
+    out.put(int32_t(numPartitions));
+    for (int x = 0; x < width; ++x)
+    {
+        out.putArray(unwalkability[x].data(), height);
+        out.putArray(partition[x].data(), height);
+    }
+}
+
+bool MapPartitions::load(MapCacheReader & in)
+{
+    int32_t w, h, n;
+    if (!in.get(w) || !in.get(h) || !in.get(n) ||
+        w != 4 * BWAPI::Broodwar->mapWidth() || h != 4 * BWAPI::Broodwar->mapHeight() || n <= 0)
+    {
+        return false;
+    }
+
+    width = w;
+    height = h;
+    numPartitions = n;
+    unwalkability = std::vector< std::vector<unsigned short> >(width, std::vector<unsigned short>(height, 0));
+    partition = std::vector< std::vector<unsigned short> >(width, std::vector<unsigned short>(height, 0));
+    for (int x = 0; x < width; ++x)
+    {
+        if (!in.getArray(unwalkability[x].data(), height) || !in.getArray(partition[x].data(), height))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool MapPartitions::walkable(int walkX, int walkY) const
 {
     UAB_ASSERT(walkX >= 0 && walkY >= 0 && walkX < width && walkY < height, "bad walk tile");
@@ -20,6 +20,9 @@
 
 namespace UAlbertaBot
 {
+    class MapCacheReader;
+    class MapCacheWriter;
+
     class MapPartitions
     {
         int width;		// in walk tiles
@@ -36,6 +39,9 @@ namespace UAlbertaBot
         MapPartitions();
         void initialize();
 
+        void save(MapCacheWriter & out) const;
+        bool load(MapCacheReader & in);
+
         bool walkable(int walkX, int walkY) const;
         bool walkable(const BWAPI::WalkPosition & pos) const;
         
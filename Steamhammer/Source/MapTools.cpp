@@ -9,6 +9,13 @@
 using namespace UAlbertaBot;
 
 MapTools::MapTools()
+    : _width(0)
+    , _cacheBytes(0)
+    , _cacheHits(0)
+    , _cacheMisses(0)
+    , _cacheEvictions(0)
+    , _pinnedBytes(0)
+    , _landmarkHits(0)
 {
 }
 
@@ -24,21 +31,23 @@ void MapTools::initialize()
 void MapTools::setBWAPIMapData()
 {
     // 1. Mark all tiles walkable and buildable at first.
-    _terrainWalkable = std::vector< std::vector<bool> >(BWAPI::Broodwar->mapWidth(), std::vector<bool>(BWAPI::Broodwar->mapHeight(), true));
-    _walkable = std::vector< std::vector<bool> >(BWAPI::Broodwar->mapWidth(), std::vector<bool>(BWAPI::Broodwar->mapHeight(), true));
-    _buildable = std::vector< std::vector<bool> >(BWAPI::Broodwar->mapWidth(), std::vector<bool>(BWAPI::Broodwar->mapHeight(), true));
-    _depotBuildable = std::vector< std::vector<bool> >(BWAPI::Broodwar->mapWidth(), std::vector<bool>(BWAPI::Broodwar->mapHeight(), true));
+    const size_t nTiles = BWAPI::Broodwar->mapWidth() * BWAPI::Broodwar->mapHeight();
+    _width = BWAPI::Broodwar->mapWidth();
+    _terrainWalkable.assign(nTiles, true);
+    _walkable.assign(nTiles, true);
+    _buildable.assign(nTiles, true);
+    _depotBuildable.assign(nTiles, true);
 
     // 2. Check terrain: Is it buildable? Is it walkable?
     // This sets _walkable and _terrainWalkable identically.
-    for (int x = 0; x < BWAPI::Broodwar->mapWidth(); ++x)
+    for (int y = 0; y < BWAPI::Broodwar->mapHeight(); ++y)
     {
-        for (int y = 0; y < BWAPI::Broodwar->mapHeight(); ++y)
+        for (int x = 0; x < BWAPI::Broodwar->mapWidth(); ++x)
         {
             // This initializes all cells of _buildable and _depotBuildable.
             bool buildable = BWAPI::Broodwar->isBuildable(BWAPI::TilePosition(x, y), false);
-            _buildable[x][y] = buildable;
-            _depotBuildable[x][y] = buildable;
+            _buildable[index(x, y)] = buildable;
+            _depotBuildable[index(x, y)] = buildable;
 
             // Check each 8x8 walk tile within this 32x32 TilePosition.
             for (int i = 0; i < 4; ++i)
@@ -47,8 +56,8 @@ void MapTools::setBWAPIMapData()
                 {
                     if (!BWAPI::Broodwar->isWalkable(x * 4 + i, y * 4 + j))
                     {
-                        _terrainWalkable[x][y] = false;
-                        _walkable[x][y] = false;
+                        _terrainWalkable[index(x, y)] = false;
+                        _walkable[index(x, y)] = false;
                         goto tileExit;
                     }
                 }
@@ -72,7 +81,7 @@ void MapTools::setBWAPIMapData()
                 {
                     if (BWAPI::TilePosition(x, y).isValid())   // assume it may be partly off the edge
                     {
-                        _walkable[x][y] = false;
+                        _walkable[index(x, y)] = false;
                     }
                 }
             }
@@ -94,7 +103,7 @@ void MapTools::setBWAPIMapData()
         {
             for (int y = tileY; y < tileY + resource->getType().tileHeight(); ++y)
             {
-                _buildable[x][y] = false;
+                _buildable[index(x, y)] = false;
 
                 // A resource depot can't be built within 3 tiles of any resource.
                 for (int dx = -3; dx <= 3; dx++)
@@ -103,7 +112,7 @@ void MapTools::setBWAPIMapData()
                     {
                         if (BWAPI::TilePosition(x + dx, y + dy).isValid())
                         {
-                            _depotBuildable[x + dx][y + dy] = false;
+                            _depotBuildable[index(x + dx, y + dy)] = false;
                         }
                     }
                 }
@@ -112,38 +121,192 @@ void MapTools::setBWAPIMapData()
     }
 }
 
-// Ground distance in tiles, -1 if no path exists.
-// This is Manhattan distance, not true walking distance. Still good for finding paths.
-int MapTools::getGroundTileDistance(BWAPI::TilePosition origin, BWAPI::TilePosition destination)
+// The landmarks are the tile of each base, where the base's own distance map starts,
+// and the tile nearest the middle of each choke. A choke is a zone.
+std::vector<BWAPI::TilePosition> MapTools::getLandmarkTiles() const
 {
-    // if we have too many maps, reset our stored maps in case we run out of memory
-    if (_allMaps.size() > allMapsSize)
+    std::vector<BWAPI::TilePosition> landmarks;
+
+    for (const Base * base : the.bases.getAll())
+    {
+        landmarks.push_back(base->getTilePosition());
+    }
+
+    for (int id = 1; id < the.zone.size(); ++id)
     {
-        _allMaps.clear();
+        const Zone * zone = the.zone.ptr(id);
+        if (!zone->isValid() || !zone->isChoke() || zone->tiles().empty())
+        {
+            continue;
+        }
+
+        BWAPI::TilePosition sum(0, 0);
+        for (const BWAPI::TilePosition & tile : zone->tiles())
+        {
+            sum += tile;
+        }
+        const BWAPI::TilePosition middle(sum.x / int(zone->tiles().size()), sum.y / int(zone->tiles().size()));
 
-        if (Config::Debug::DrawMapDistances)
+        BWAPI::TilePosition best = zone->tiles().front();
+        for (const BWAPI::TilePosition & tile : zone->tiles())
         {
-            BWAPI::Broodwar->printf("Cleared distance map cache");
+            if (tile.getApproxDistance(middle) < best.getApproxDistance(middle))
+            {
+                best = tile;
+            }
         }
+        landmarks.push_back(best);
     }
 
-    // Do we have a distance map to the destination?
-    auto it = _allMaps.find(destination);
+    return landmarks;
+}
+
+// Call after bases and zones are initialized.
+// Pin the distance maps most likely to be asked for, those of the landmarks, so they are never evicted.
+// The bases already have their maps; the chokes get maps as long as the pinned budget lasts.
+// Then find the distances between landmarks, for estimating distances that have no map.
+void MapTools::initializeLandmarks()
+{
+    for (const Base * base : the.bases.getAll())
+    {
+        _pinnedMaps[base->getTilePosition()] = &base->getDistances();
+    }
+
+    const std::vector<BWAPI::TilePosition> landmarks = getLandmarkTiles();
+
+    for (const BWAPI::TilePosition & tile : landmarks)
+    {
+        (void) pinDistanceMap(tile);
+    }
+
+    _landmarks.initialize(landmarks);
+}
+
+// Keep the distance map to the tile for the rest of the game, taking it out of the cache if it is there.
+// Return false if the pinned maps are already over their budget.
+bool MapTools::pinDistanceMap(const BWAPI::TilePosition & tile)
+{
+    if (_pinnedMaps.find(tile) != _pinnedMaps.end())
+    {
+        return true;
+    }
+    if (_pinnedBytes >= pinnedCacheBytes)
+    {
+        return false;
+    }
+
+    GridDistances & pinned = _pinnedOwned[tile];
+
+    auto it = _allMaps.find(tile);
+    if (it == _allMaps.end())
+    {
+        ++_cacheMisses;
+        pinned = GridDistances(tile, MAX_DISTANCE, true, false);
+    }
+    else
+    {
+        pinned = std::move(it->second.distances);
+        _cacheBytes -= it->second.bytes;
+        _lru.erase(it->second.lruPos);
+        _allMaps.erase(it);
+    }
+
+    _pinnedBytes += pinned.getMemorySize();
+    _pinnedMaps[tile] = &pinned;
+    return true;
+}
+
+// Return the distance map to the tile, or null if there is none.
+// A cached map is marked most recently used. It is preferred over a pinned map,
+// because it only exists if it has something the pinned map lacks: sorted tiles.
+// This counts neither a hit nor a miss.
+const GridDistances * MapTools::findDistanceMap(const BWAPI::TilePosition & tile)
+{
+    auto it = _allMaps.find(tile);
     if (it != _allMaps.end())
     {
-        return (*it).second.at(origin);
+        _lru.splice(_lru.begin(), _lru, it->second.lruPos);
+        return &it->second.distances;
+    }
+
+    auto pinned = _pinnedMaps.find(tile);
+    if (pinned != _pinnedMaps.end())
+    {
+        return pinned->second;
+    }
+
+    return nullptr;
+}
+
+// Return the distance map to the tile, from the cache or computed and added to the cache.
+// If sortTiles is set, the map also has its tiles sorted by distance. A cached map without them is recomputed.
+const GridDistances & MapTools::getDistanceMap(const BWAPI::TilePosition & tile, bool sortTiles)
+{
+    const GridDistances * cached = findDistanceMap(tile);
+    if (cached && (!sortTiles || cached->hasSortedTiles()))
+    {
+        ++_cacheHits;
+        return *cached;
+    }
+
+    ++_cacheMisses;
+
+    GridDistances distances(tile, MAX_DISTANCE, true, sortTiles);
+    const size_t bytes = distances.getMemorySize();
+
+    auto it = _allMaps.find(tile);
+    if (it == _allMaps.end())
+    {
+        _lru.push_front(tile);
+        it = _allMaps.insert(std::make_pair(tile, CachedDistances{ std::move(distances), bytes, _lru.begin() })).first;
+    }
+    else
+    {
+        _cacheBytes -= it->second.bytes;
+        it->second.distances = std::move(distances);
+        it->second.bytes = bytes;
+    }
+    _cacheBytes += bytes;
+
+    evictDistanceMaps();
+
+    return it->second.distances;
+}
+
+// Drop the least recently used maps until the cache fits in its budget.
+// The most recently used map is always kept, since the caller may still be using it.
+void MapTools::evictDistanceMaps()
+{
+    while (_cacheBytes > distanceCacheBytes && _lru.size() > 1)
+    {
+        auto it = _allMaps.find(_lru.back());
+        _cacheBytes -= it->second.bytes;
+        _allMaps.erase(it);
+        _lru.pop_back();
+        ++_cacheEvictions;
+    }
+}
+
+// Ground distance in tiles, -1 if no path exists.
+// This is Manhattan distance, not true walking distance. Still good for finding paths.
+int MapTools::getGroundTileDistance(BWAPI::TilePosition origin, BWAPI::TilePosition destination)
+{
+    // Do we have a distance map to the destination?
+    if (const GridDistances * distances = findDistanceMap(destination))
+    {
+        ++_cacheHits;
+        return distances->at(origin);
     }
 
     // It's symmetrical. A distance map to the origin is just as good.
-    it = _allMaps.find(origin);
-    if (it != _allMaps.end())
+    if (const GridDistances * distances = findDistanceMap(origin))
     {
-        return (*it).second.at(destination);
+        ++_cacheHits;
+        return distances->at(destination);
     }
 
     // Make a new map for this destination.
-    _allMaps.insert(std::pair<BWAPI::TilePosition, GridDistances>(destination, GridDistances(destination)));
-    return _allMaps[destination].at(origin);
+    return getDistanceMap(destination, false).at(origin);
 }
 
 int MapTools::getGroundTileDistance(BWAPI::Position origin, BWAPI::Position destination)
@@ -163,12 +326,53 @@ int MapTools::getGroundDistance(BWAPI::Position origin, BWAPI::Position destinat
     return tiles;    // 0 or -1
 }
 
-const std::vector<BWAPI::TilePosition> & MapTools::getClosestTilesTo(BWAPI::TilePosition pos)
+// Like getGroundTileDistance(), but when there is no cached distance map, it may route the distance
+// by way of the landmarks instead of making a new map. Then it can be too long by up to 1/5.
+// For callers that compare distances roughly and are called too often to afford a search each time.
+int MapTools::estimateGroundTileDistance(BWAPI::TilePosition origin, BWAPI::TilePosition destination)
+{
+    if (const GridDistances * distances = findDistanceMap(destination))
+    {
+        ++_cacheHits;
+        return distances->at(origin);
+    }
+
+    if (const GridDistances * distances = findDistanceMap(origin))
+    {
+        ++_cacheHits;
+        return distances->at(destination);
+    }
+
+    // Estimate it by way of the landmarks, if they are close enough to the tiles to give a good estimate.
+    const int estimate = _landmarks.estimate(origin, destination);
+    if (estimate >= 0)
+    {
+        ++_landmarkHits;
+        return estimate;
+    }
+
+    return getDistanceMap(destination, false).at(origin);
+}
+
+int MapTools::estimateGroundTileDistance(BWAPI::Position origin, BWAPI::Position destination)
 {
-    // make sure the distance map is calculated with pos as a destination
-    int a = getGroundTileDistance(pos, pos);
+    return estimateGroundTileDistance(BWAPI::TilePosition(origin), BWAPI::TilePosition(destination));
+}
 
-    return _allMaps[pos].getSortedTiles();
+// Ground distance in pixels, possibly estimated as in estimateGroundTileDistance().
+int MapTools::estimateGroundDistance(BWAPI::Position origin, BWAPI::Position destination)
+{
+    int tiles = estimateGroundTileDistance(origin, destination);
+    if (tiles > 0)
+    {
+        return 32 * tiles;
+    }
+    return tiles;    // 0 or -1
+}
+
+const std::vector<BWAPI::TilePosition> & MapTools::getClosestTilesTo(BWAPI::TilePosition pos)
+{
+    return getDistanceMap(pos, true).getSortedTiles();
 }
 
 const std::vector<BWAPI::TilePosition> & MapTools::getClosestTilesTo(BWAPI::Position pos)
@@ -210,6 +414,12 @@ void MapTools::drawHomeDistances()
     if (Config::Debug::DrawMapDistances)
     {
         the.bases.myMain()->getDistances().draw();
+
+        BWAPI::Broodwar->drawTextScreen(200, 10, "%cdistance maps %d %dKB, pinned %d %dKB, hits %d misses %d evictions %d",
+            white, int(_allMaps.size()), int(_cacheBytes / 1024), int(_pinnedMaps.size()), int(_pinnedBytes / 1024),
+            _cacheHits, _cacheMisses, _cacheEvictions);
+        BWAPI::Broodwar->drawTextScreen(200, 20, "%clandmarks %d, estimates %d",
+            white, _landmarks.size(), _landmarkHits);
     }
 }
 
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <list>
 #include <map>
 #include <vector>
 #include "GridDistances.h"
+#include "LandmarkDistances.h"
 
 // Keep track of map information, like what tiles are walkable or buildable.
 
@@ -13,35 +15,75 @@ class GridDistances;
 
 class MapTools
 {
-    const size_t allMapsSize = 40;			// store this many distance maps in _allMaps
+    const size_t distanceCacheBytes = 16 * 1024 * 1024;	// evict distance maps when _allMaps uses more than this
+    const size_t pinnedCacheBytes = 8 * 1024 * 1024;	// stop pinning maps when _pinnedOwned uses more than this
 
-    std::map<BWAPI::TilePosition, GridDistances>
+    // A cached distance map that may be evicted.
+    struct CachedDistances
+    {
+        GridDistances   distances;
+        size_t          bytes;
+        std::list<BWAPI::TilePosition>::iterator lruPos;
+    };
+
+    std::map<BWAPI::TilePosition, CachedDistances>
                         _allMaps;			// a cache of already computed distance maps
-    std::vector< std::vector<bool> >
-                        _terrainWalkable;	// walkable considering terrain only
-    std::vector< std::vector<bool> >
-                        _walkable;			// walkable considering terrain and neutral units
-    std::vector< std::vector<bool> >
-                        _buildable;
-    std::vector< std::vector<bool> >
-                        _depotBuildable;
+    std::list<BWAPI::TilePosition>
+                        _lru;				// _allMaps, most recently used first
+    size_t              _cacheBytes;
+    int                 _cacheHits;
+    int                 _cacheMisses;
+    int                 _cacheEvictions;
+
+    // Pinned maps are never evicted and don't count against the cache budget.
+    // Each base keeps its own distance map, so those are pinned without copying them.
+    std::map<BWAPI::TilePosition, const GridDistances *>
+                        _pinnedMaps;		// all pinned maps, ours and the bases'
+    std::map<BWAPI::TilePosition, GridDistances>
+                        _pinnedOwned;		// pinned maps that no base keeps
+    size_t              _pinnedBytes;
+
+    LandmarkDistances   _landmarks;			// for estimateGroundTileDistance() between tiles with no cached map
+    int                 _landmarkHits;
+
+    // One byte per tile, row by row like Grid, so a lookup is a single load with no bit twiddling.
+    int                 _width;
+    std::vector<char>   _terrainWalkable;	// walkable considering terrain only
+    std::vector<char>   _walkable;			// walkable considering terrain and neutral units
+    std::vector<char>   _buildable;
+    std::vector<char>   _depotBuildable;
+
+    int                 index(int x, int y) const { return y * _width + x; };
 
     void				setBWAPIMapData();					// reads in the map data from bwapi and stores it in our map format
 
+    const GridDistances * findDistanceMap(const BWAPI::TilePosition & tile);
+    const GridDistances & getDistanceMap(const BWAPI::TilePosition & tile, bool sortTiles);
+    void                evictDistanceMaps();
+
+    std::vector<BWAPI::TilePosition> getLandmarkTiles() const;
+
 public:
 
     MapTools();
     void initialize();
+    void initializeLandmarks();
+    bool pinDistanceMap(const BWAPI::TilePosition & tile);
 
     int		getGroundTileDistance(BWAPI::TilePosition from, BWAPI::TilePosition to);
     int		getGroundTileDistance(BWAPI::Position from, BWAPI::Position to);
     int		getGroundDistance(BWAPI::Position from, BWAPI::Position to);
 
+    // Faster and less exact. See the .cpp file.
+    int		estimateGroundTileDistance(BWAPI::TilePosition from, BWAPI::TilePosition to);
+    int		estimateGroundTileDistance(BWAPI::Position from, BWAPI::Position to);
+    int		estimateGroundDistance(BWAPI::Position from, BWAPI::Position to);
+
     // Pass only valid tiles to these routines!
-    bool	isTerrainWalkable(BWAPI::TilePosition tile) const { return _terrainWalkable[tile.x][tile.y]; };
-    bool	isWalkable(BWAPI::TilePosition tile) const { return _walkable[tile.x][tile.y]; };
-    bool	isBuildable(BWAPI::TilePosition tile) const { return _buildable[tile.x][tile.y]; };
-    bool	isDepotBuildable(BWAPI::TilePosition tile) const { return _depotBuildable[tile.x][tile.y]; };
+    bool	isTerrainWalkable(BWAPI::TilePosition tile) const { return _terrainWalkable[index(tile.x, tile.y)] != 0; };
+    bool	isWalkable(BWAPI::TilePosition tile) const { return _walkable[index(tile.x, tile.y)] != 0; };
+    bool	isBuildable(BWAPI::TilePosition tile) const { return _buildable[index(tile.x, tile.y)] != 0; };
+    bool	isDepotBuildable(BWAPI::TilePosition tile) const { return _depotBuildable[index(tile.x, tile.y)] != 0; };
 
     // TODO deprecated method, used only in Bases
     bool	isBuildable(BWAPI::TilePosition tile, BWAPI::UnitType type) const;
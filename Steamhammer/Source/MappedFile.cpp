@@ -0,0 +1,103 @@
+#include "MappedFile.h"
+
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace UAlbertaBot;
+
+MappedFile::MappedFile()
+    : _data(nullptr)
+    , _size(0)
+    , _fileHandle(nullptr)
+    , _mappingHandle(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+// Map the whole file read-only. Return false if it doesn't exist, is empty, or can't be mapped.
+bool MappedFile::open(const std::string & filename)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    _fileHandle = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        close();
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        close();
+        return false;
+    }
+    _mappingHandle = mapping;
+
+    _data = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!_data)
+    {
+        close();
+        return false;
+    }
+    _size = (size_t)size.QuadPart;
+#else
+    std::ifstream inFile(filename, std::ios::binary);
+    if (!inFile.good())
+    {
+        return false;
+    }
+
+    _fallbackData.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+    if (_fallbackData.empty())
+    {
+        return false;
+    }
+    _data = _fallbackData.data();
+    _size = _fallbackData.size();
+#endif
+
+    return true;
+}
+
+// Release the file. Pointers into the data are no longer valid.
+// Close before writing the same file, since Windows doesn't allow overwriting a mapped file.
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (_data && _mappingHandle)
+    {
+        UnmapViewOfFile(_data);
+    }
+    if (_mappingHandle)
+    {
+        CloseHandle((HANDLE)_mappingHandle);
+    }
+    if (_fileHandle)
+    {
+        CloseHandle((HANDLE)_fileHandle);
+    }
+#endif
+
+    _data = nullptr;
+    _size = 0;
+    _fileHandle = nullptr;
+    _mappingHandle = nullptr;
+    _fallbackData.clear();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// A file mapped read-only into memory, for reading saved data in place without copying it.
+// Where mapping isn't available, the file is read into memory instead. Callers can't tell the difference.
+
+namespace UAlbertaBot
+{
+class MappedFile
+{
+    const char * _data;
+    size_t _size;
+    void * _fileHandle;
+    void * _mappingHandle;
+    std::vector<char> _fallbackData;
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    bool open(const std::string & filename);
+    void close();
+
+    bool isOpen() const { return _data != nullptr; };
+    const char * data() const { return _data; };
+    size_t size() const { return _size; };
+};
+}
@@ -16,6 +16,31 @@
 
 using namespace UAlbertaBot;
 
+// Read only the directories from the IO section of the configuration file.
+// The full config depends on the map analysis and is parsed after it, but the map analysis
+// is read from and saved to these directories, so they are needed first.
+// ParseConfigFile() reads them again later, with the same result.
+void ParseUtils::ParseIODirectories(const std::string & filename)
+{
+    rapidjson::Document doc;
+
+    std::string config = FileUtils::ReadFile(filename);
+    if (config.length() == 0 || doc.Parse(config.c_str()).HasParseError())
+    {
+        return;
+    }
+
+    if (doc.HasMember("IO") && doc["IO"].IsObject())
+    {
+        const rapidjson::Value & io = doc["IO"];
+
+        JSONTools::ReadString("StaticDirectory", io, Config::IO::StaticDir);
+        JSONTools::ReadString("PreparedDataDirectory", io, Config::IO::PreparedDataDir);
+        JSONTools::ReadString("ReadDirectory", io, Config::IO::ReadDir);
+        JSONTools::ReadString("WriteDirectory", io, Config::IO::WriteDir);
+    }
+}
+
 // Parse the JSON configuration file into Config:: variables.
 void ParseUtils::ParseConfigFile(const std::string & filename)
 {
@@ -91,6 +116,14 @@ void ParseUtils::ParseConfigFile(const std::string & filename)
     {
         const rapidjson::Value & macro = doc["Macro"];
         JSONTools::ReadInt("BOSSFrameLimit", macro, Config::Macro::BOSSFrameLimit);
+        JSONTools::ReadInt("BOSSThreads", macro, Config::Macro::BOSSThreads);
+        JSONTools::ReadBool("BOSSAsync", macro, Config::Macro::BOSSAsync);
+        JSONTools::ReadInt("BOSSTimeLimit", macro, Config::Macro::BOSSTimeLimit);
+        JSONTools::ReadBool("BOSSCache", macro, Config::Macro::BOSSCache);
+        JSONTools::ReadInt("BOSSBeamGoalSize", macro, Config::Macro::BOSSBeamGoalSize);
+        JSONTools::ReadInt("BOSSMilestoneGoalSize", macro, Config::Macro::BOSSMilestoneGoalSize);
+        JSONTools::ReadBool("BOSSReplay", macro, Config::Macro::BOSSReplay);
+        JSONTools::ReadBool("BOSSStats", macro, Config::Macro::BOSSStats);
         Config::Macro::ProductionJamFrameLimit = GetIntByRace("ProductionJamFrameLimit", macro);
         Config::Macro::WorkersPerRefinery = GetIntByRace("WorkersPerRefinery", macro);
         Config::Macro::WorkersPerPatch = GetDoubleByRace("WorkersPerPatch", macro);
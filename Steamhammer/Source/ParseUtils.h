@@ -7,6 +7,7 @@ namespace UAlbertaBot
 {
 namespace ParseUtils
 {
+    void ParseIODirectories(const std::string & filename);
     void ParseConfigFile(const std::string & filename);
     void ParseTextCommand(const std::string & commandLine);
     BWAPI::Race GetRace(const std::string & raceName);
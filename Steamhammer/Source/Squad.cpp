@@ -1175,9 +1175,9 @@ BWAPI::Unit Squad::unitClosestToPosition(const BWAPI::Position & pos, const BWAP
         int dist;
         if (_hasGround)
         {
-            // A ground or air-ground group. Use ground distance.
+            // A ground or air-ground group. Use ground distance. Close is close enough, so it may be estimated.
             // It is -1 if no ground path exists.
-            dist = the.map.getGroundDistance(unit->getPosition(), pos);
+            dist = the.map.estimateGroundDistance(unit->getPosition(), pos);
         }
         else
         {
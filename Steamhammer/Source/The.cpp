@@ -3,6 +3,7 @@
 
 #include "Bases.h"
 #include "InformationManager.h"
+#include "MapAnalysisCache.h"
 #include "MapGrid.h"
 #include "OpeningTiming.h"
 #include "ParseUtils.h"
@@ -32,14 +33,27 @@ void The::initialize()
     _selfRace = BWAPI::Broodwar->self()->getRace();
 
     // The order of initialization is important because of dependencies.
-    partitions.initialize();
-    inset.initialize();				// depends on partitions
-    vWalkRoom.initialize();			// depends on edgeRange
-    tileRoom.initialize();			// depends on vWalkRoom
-    zone.initialize();				// depends on tileRoom
+    // The static map analysis is read from a file if an earlier game on this map saved it.
+    // The rest of the config file is parsed below, but the file directories are needed now.
+    ParseUtils::ParseIODirectories(Config::ConfigFile::ConfigFileLocation);
+    MapAnalysisCache mapCache;
+    const bool mapCached = mapCache.load();
+    if (!mapCached)
+    {
+        partitions.initialize();
+        inset.initialize();				// depends on partitions
+        vWalkRoom.initialize();			// depends on edgeRange
+        tileRoom.initialize();			// depends on vWalkRoom
+        zone.initialize();				// depends on tileRoom
+    }
     map.initialize();
 
     bases.initialize();             // depends on map
+    if (!mapCached)
+    {
+        mapCache.save();            // depends on bases
+    }
+    map.initializeLandmarks();      // depends on bases and zone
     info.initialize();              // depends on bases
     placer.initialize();
     ops.initialize();